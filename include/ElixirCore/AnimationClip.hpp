@@ -0,0 +1,137 @@
+#ifndef ANIMATION_CLIP_HPP
+#define ANIMATION_CLIP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace elix
+{
+    //Compressed keyframe animation. Every track has independent translation, rotation and scale curves, reduced to the
+    //keys linear interpolation cannot reproduce within the error bounds. Rotations are stored smallest three in 48 bits,
+    //translations and scales as 16 bit fractions of their channel's range, key times as 16 bit fractions of the duration
+    class AnimationClip
+    {
+    public:
+        enum Channel : uint8_t
+        {
+            TRANSLATION,
+            ROTATION,
+            SCALE,
+            CHANNEL_COUNT
+        };
+
+        struct Settings
+        {
+            //Model units
+            float translationError{0.001f};
+            //Radians
+            float rotationError{0.0005f};
+            float scaleError{0.0001f};
+        };
+
+        template<typename T>
+        struct Key
+        {
+            float time;
+            T value;
+        };
+
+        //Uncompressed input, times in ticks
+        struct RawTrack
+        {
+            std::string name;
+            std::vector<Key<glm::vec3>> translations;
+            std::vector<Key<glm::quat>> rotations;
+            std::vector<Key<glm::vec3>> scales;
+        };
+
+        struct Transform
+        {
+            glm::vec3 translation{0.0f};
+            glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+            glm::vec3 scale{1.0f};
+        };
+
+        //Last key used by every channel of one playing instance. Playback moves forward a key or two per frame, so sampling
+        //through a cursor checks the cached key and its successor before falling back to a binary search on seeks and loops
+        struct Cursor
+        {
+            const AnimationClip* clip{nullptr};
+            std::vector<uint32_t> keys;
+        };
+
+        AnimationClip() = default;
+
+        static AnimationClip compress(const std::string& name, float duration, float ticksPerSecond, const std::vector<RawTrack>& tracks);
+        static AnimationClip compress(const std::string& name, float duration, float ticksPerSecond, const std::vector<RawTrack>& tracks, const Settings& settings);
+
+        //time in ticks, clamped to the clip
+        [[nodiscard]] Transform sample(size_t track, float time) const;
+        //Same result, the cursor is reset when it was last used with another clip
+        [[nodiscard]] Transform sample(size_t track, float time, Cursor& cursor) const;
+
+        //The keys around time and the interpolation factor of every channel (indexed by Channel), for callers that
+        //interpolate many tracks at once. Rotations are not hemisphere aligned, flip end when dot(start, end) < 0
+        void sampleKeys(size_t track, float time, Cursor& cursor, Transform& start, Transform& end, glm::vec3& factors) const;
+
+        //-1 if no track animates the node
+        [[nodiscard]] int findTrack(const std::string& name) const;
+
+        [[nodiscard]] size_t getTrackCount() const;
+        [[nodiscard]] const std::string& getTrackName(size_t track) const;
+        [[nodiscard]] const std::string& getName() const;
+        [[nodiscard]] float getDuration() const;
+        [[nodiscard]] float getTicksPerSecond() const;
+
+        [[nodiscard]] size_t getKeyCount() const;
+        [[nodiscard]] size_t getMemorySize() const;
+
+    private:
+        struct ChannelRange
+        {
+            uint32_t firstKey{0};
+            uint32_t keyCount{0};
+            //Dequantized value is rangeMin + rangeExtent * q / 65535, unused for rotations
+            glm::vec3 rangeMin{0.0f};
+            glm::vec3 rangeExtent{0.0f};
+        };
+
+        struct Track
+        {
+            ChannelRange channels[CHANNEL_COUNT];
+        };
+
+        //Resets the cursor when it was last used with another clip
+        [[nodiscard]] uint32_t* getHints(size_t track, Cursor& cursor) const;
+        [[nodiscard]] float normalizeTime(float time) const;
+
+        //key has to be the one findKey returns for normalizedTime
+        [[nodiscard]] glm::vec3 sampleVector(const ChannelRange& channel, uint32_t key, float normalizedTime) const;
+        [[nodiscard]] glm::quat sampleRotation(const ChannelRange& channel, uint32_t key, float normalizedTime) const;
+        [[nodiscard]] float getInterpolation(uint32_t key, float normalizedTime) const;
+
+        //Index of the last key at or before normalizedTime, the first one if there is none
+        [[nodiscard]] uint32_t findKey(const ChannelRange& channel, float normalizedTime) const;
+        //Starts from hint and updates it
+        [[nodiscard]] uint32_t findKey(const ChannelRange& channel, float normalizedTime, uint32_t& hint) const;
+
+        std::string m_name;
+        float m_duration{0.0f};
+        float m_ticksPerSecond{0.0f};
+
+        std::vector<Track> m_tracks;
+        std::vector<std::string> m_trackNames;
+
+        //Shared by every channel, a channel owns keyCount consecutive entries starting at firstKey
+        std::vector<uint16_t> m_keyTimes;
+        //Three per key
+        std::vector<uint16_t> m_keyValues;
+    };
+} //namespace elix
+
+#endif //ANIMATION_CLIP_HPP
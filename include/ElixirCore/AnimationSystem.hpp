@@ -0,0 +1,58 @@
+#ifndef ANIMATION_SYSTEM_HPP
+#define ANIMATION_SYSTEM_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace elix
+{
+    //Samples the skeletal poses of every animator in one pass. Keys are decoded per bone, interpolation and the TRS to
+    //matrix conversion run on SoA batches of simd::WIDTH bones, characters are spread over the shared ThreadPool
+    class AnimationSystem
+    {
+    public:
+        //Everything one instance needs to sample a pose, nothing in here is shared
+        struct Pose
+        {
+            AnimationClip::Cursor cursor;
+            //Skeleton evaluation order
+            std::vector<glm::mat4> localTransforms;
+            std::vector<glm::mat4> modelTransforms;
+            //Bone id order, the skinning palette
+            std::vector<glm::mat4> finalMatrices;
+        };
+
+        struct BenchmarkResult
+        {
+            size_t characterCount{0};
+            size_t boneCount{0};
+            size_t frameCount{0};
+            double milliseconds{0.0};
+            double bonesPerMillisecond{0.0};
+        };
+
+        //Samples the pending pose of every AnimatorComponent in objects, in parallel. Scene::update calls it after the
+        //objects updated; when batching is disabled animators sample in their own update instead
+        static void update(const std::vector<std::shared_ptr<GameObject>>& objects);
+
+        //Builds the bone to track table of an animation the first time it is used with its skeleton. Not thread safe,
+        //call before sampling
+        static void bind(common::Animation& animation);
+
+        //Samples a bound animation at time into pose. Thread safe as long as every thread brings its own pose
+        static void samplePose(const common::Animation& animation, float time, Pose& pose);
+
+        //Poses characterCount instances of a skeletal animation for frameCount frames, each at its own phase
+        static BenchmarkResult benchmark(common::Animation& animation, size_t characterCount, size_t frameCount = 100);
+        //Logs benchmark for 1, 100 and 1000 characters
+        static void runBenchmarks(common::Animation& animation);
+
+        static void setBatchingEnabled(bool isEnabled);
+        [[nodiscard]] static bool isBatchingEnabled();
+    };
+} //namespace elix
+
+#endif //ANIMATION_SYSTEM_HPP
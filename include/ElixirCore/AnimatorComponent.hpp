@@ -1,6 +1,7 @@
 #ifndef ANIMATOR_COMPONENT_HPP
 #define ANIMATOR_COMPONENT_HPP
 
+#include "AnimationSystem.hpp"
 #include "Component.hpp"
 #include "Common.hpp"
 
@@ -9,15 +10,31 @@ class AnimatorComponent final : public Component
 public:
     AnimatorComponent();
 
+    //Advances the playback. The skeletal pose is sampled right away only when elix::AnimationSystem batching is off,
+    //otherwise it stays pending until the system's pass
     void update(float deltaTime) override;
+    //Binds clips to their skeleton and may drive the owner's transform, one instance at a time
+    [[nodiscard]] elix::UpdatePhase getUpdatePhase() const override { return elix::UpdatePhase::Animation; }
+    [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::TRANSFORMS, elix::Resource::ANIMATION | elix::Resource::TRANSFORMS}; }
+
+    //Samples the pending pose, touches nothing but this instance so animators can sample in parallel
+    void samplePose();
+    [[nodiscard]] bool hasPendingPose() const;
 
     void playAnimation(common::Animation* animation, bool repeat = true);
 
     void stopAnimation();
 
     [[nodiscard]] bool isAnimationPlaying() const;
+
+    //Skinning palette of this instance by bone id, upload it as finalBonesMatrices. Holds the bind pose from the first
+    //playAnimation until sampling starts; the model, skeleton and clips stay shared between every instance
+    [[nodiscard]] const std::vector<glm::mat4>& getFinalMatrices() const;
+    //Bones in model space, in the skeleton's evaluation order. Use for attachments
+    [[nodiscard]] const std::vector<glm::mat4>& getModelTransforms() const;
+    //Changes whenever the palette does, lets caches built from it (elix::SkinningCache) skip unchanged poses
+    [[nodiscard]] uint32_t getPoseVersion() const;
 private:
-    void calculateBoneTransform(common::BoneInfo* boneInfo, const glm::mat4 &parentTransform, common::Animation* animation, float currentTime);
     void calculateObjectTransform(common::Animation* animation, float currentTime);
 
     bool m_isAnimationPaused{false};
@@ -33,6 +50,10 @@ private:
     common::Animation* m_currentAnimation{nullptr};
     common::Animation* m_nextAnimation{nullptr};
     common::Animation* m_queueAnimation{nullptr};
+
+    bool m_hasPendingPose{false};
+    uint32_t m_poseVersion{0};
+    elix::AnimationSystem::Pose m_pose;
 };
 
 #endif //ANIMATOR_COMPONENT_HPP
@@ -0,0 +1,34 @@
+#ifndef ASSET_HANDLE_HPP
+#define ASSET_HANDLE_HPP
+
+#include <cstdint>
+#include <functional>
+
+namespace elix
+{
+    //Index into the per type storage of AssetsCache plus the generation of the slot. A handle to a removed
+    //asset keeps its old generation and stops resolving instead of pointing at whatever reused the slot
+    template<typename T>
+    struct AssetHandle
+    {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{0};
+
+        [[nodiscard]] bool isValid() const { return index != INVALID_INDEX; }
+
+        bool operator==(const AssetHandle& other) const = default;
+    };
+} //namespace elix
+
+template<typename T>
+struct std::hash<elix::AssetHandle<T>>
+{
+    size_t operator()(const elix::AssetHandle<T>& handle) const noexcept
+    {
+        return std::hash<uint64_t>{}((static_cast<uint64_t>(handle.generation) << 32) | handle.index);
+    }
+};
+
+#endif //ASSET_HANDLE_HPP
@@ -3,21 +3,92 @@
 
 #include "Texture.hpp"
 #include "Model.hpp"
+#include "AssetHandle.hpp"
 #include <memory>
+#include <string>
 
 namespace elix
 {
+    enum class AssetType : uint8_t
+    {
+        Model,
+        Texture,
+        Material,
+        Animation,
+        Custom
+    };
+
+    class AssetTexture;
+
     class Asset
     {
     public:
+        //Used by AssetsCache to route assets into their typed storage without RTTI
+        [[nodiscard]] virtual AssetType getType() const { return AssetType::Custom; }
+
+        struct LoadStatistics
+        {
+            std::string loader;
+            size_t bytesRead{0};
+            size_t bytesDecoded{0};
+        };
+
+        struct MemoryUsage
+        {
+            size_t cpuBytes{0};
+            size_t gpuBytes{0};
+
+            [[nodiscard]] size_t total() const { return cpuBytes + gpuBytes; }
+
+            MemoryUsage& operator+=(const MemoryUsage& other)
+            {
+                cpuBytes += other.cpuBytes;
+                gpuBytes += other.gpuBytes;
+                return *this;
+            }
+        };
+
+        //What the asset currently keeps resident, used by AssetsCache for its memory budget
+        [[nodiscard]] virtual MemoryUsage getMemoryUsage() const { return {}; }
+
+        void setLoadStatistics(const LoadStatistics& statistics) { m_loadStatistics = statistics; }
+        [[nodiscard]] const LoadStatistics& getLoadStatistics() const { return m_loadStatistics; }
+
+        //GPU upload stage of the asset. Decoding happens on any thread, bake() only on the OpenGL thread
+        virtual void bake() {}
+
         virtual ~Asset() = default;
+    private:
+        LoadStatistics m_loadStatistics;
     };
 
     class AssetModel final : public Asset
     {
     public:
+        static constexpr AssetType TYPE = AssetType::Model;
+        [[nodiscard]] AssetType getType() const override { return TYPE; }
+
         explicit AssetModel(std::unique_ptr<elix::Model> model) : m_model(std::move(model)) {}
         [[nodiscard]] elix::Model* getModel() const { return m_model.get(); }
+
+        void bake() override { m_model->bake(); }
+
+        [[nodiscard]] MemoryUsage getMemoryUsage() const override
+        {
+            MemoryUsage usage;
+
+            for (size_t meshIndex = 0; meshIndex < m_model->getNumMeshes(); ++meshIndex)
+            {
+                const auto mesh = m_model->getMesh(static_cast<int>(meshIndex));
+                usage.cpuBytes += mesh->getVertexData().size_bytes() + mesh->getIndexData().size_bytes();
+                usage.gpuBytes += mesh->getGpuMemorySize();
+            }
+
+            if (const auto skeleton = m_model->getSkeleton())
+                usage.cpuBytes += skeleton->getMemorySize();
+
+            return usage;
+        }
     private:
         std::unique_ptr<elix::Model> m_model{nullptr};
     };
@@ -25,18 +96,40 @@ namespace elix
     class AssetMaterial final : public Asset
     {
     public:
+        static constexpr AssetType TYPE = AssetType::Material;
+        [[nodiscard]] AssetType getType() const override { return TYPE; }
+
         explicit AssetMaterial(std::unique_ptr<Material> material) : m_material(std::move(material)) {}
         [[nodiscard]] Material* getMaterial() const { return m_material.get(); }
+
+        //Textures the material points at. AssetsCache keeps them referenced for as long as the material is cached
+        void addTextureDependency(AssetHandle<AssetTexture> texture) { m_textureDependencies.push_back(texture); }
+        [[nodiscard]] const std::vector<AssetHandle<AssetTexture>>& getTextureDependencies() const { return m_textureDependencies; }
     private:
         std::unique_ptr<Material> m_material{nullptr};
+        std::vector<AssetHandle<AssetTexture>> m_textureDependencies;
     };
 
     class AssetTexture final : public Asset
     {
     public:
+        static constexpr AssetType TYPE = AssetType::Texture;
+        [[nodiscard]] AssetType getType() const override { return TYPE; }
+
         explicit AssetTexture(std::unique_ptr<elix::Texture> texture) : m_texture(std::move(texture)) {}
 
         [[nodiscard]] elix::Texture* getTexture() const { return m_texture.get(); }
+
+        void bake() override
+        {
+            if (!m_texture->isBaked())
+                m_texture->bake();
+        }
+
+        [[nodiscard]] MemoryUsage getMemoryUsage() const override
+        {
+            return {m_texture->getCpuMemorySize(), m_texture->getGpuMemorySize()};
+        }
     private:
         std::unique_ptr<elix::Texture> m_texture{nullptr};
     };
@@ -44,10 +137,18 @@ namespace elix
     class AssetAnimation final : public Asset
     {
     public:
+        static constexpr AssetType TYPE = AssetType::Animation;
+        [[nodiscard]] AssetType getType() const override { return TYPE; }
+
         explicit AssetAnimation(std::unique_ptr<common::Animation> animation) : m_animation(std::move(animation)) {}
 
         [[nodiscard]] common::Animation* getAnimation() const { return m_animation.get(); }
 
+        [[nodiscard]] MemoryUsage getMemoryUsage() const override
+        {
+            return {sizeof(common::Animation) - sizeof(AnimationClip) + m_animation->clip.getMemorySize(), 0};
+        }
+
     private:
         std::unique_ptr<common::Animation> m_animation{nullptr};
     };
@@ -2,43 +2,430 @@
 #define ASSETS_CACHE_HPP
 
 #include "Assets.hpp"
-#include <filesystem>
+#include "AssetHandle.hpp"
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include "Logger.hpp"
 
 namespace elix
 {
+    //Slot array for one asset type. Lookups by handle are an index plus a generation compare,
+    //lookups by name are a single hash into the path or file name index
+    template<typename T>
+    class AssetStorage
+    {
+    public:
+        AssetHandle<T> add(const std::string& path, std::unique_ptr<T> asset)
+        {
+            //Re-adding a path replaces the asset in place so existing handles keep resolving. A referenced asset is kept
+            //and the new one dropped, its users hold raw pointers into it
+            if (const auto it = m_pathIndex.find(path); it != m_pathIndex.end())
+            {
+                if (m_slots[it->second].references > 0)
+                    ELIX_LOG_WARN("Asset ", path, " is still in use, keeping the loaded version");
+                else
+                    m_slots[it->second].asset = std::move(asset);
+
+                return {it->second, m_slots[it->second].generation};
+            }
+
+            uint32_t index;
+
+            if (!m_freeSlots.empty())
+            {
+                index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+
+            auto& slot = m_slots[index];
+            slot.asset = std::move(asset);
+            slot.path = path;
+
+            m_pathIndex[path] = index;
+            addName(getFileName(path), index);
+
+            return {index, slot.generation};
+        }
+
+        //False while the asset at path is referenced, add keeps it then
+        [[nodiscard]] bool isReplaceable(const std::string& path) const
+        {
+            const auto it = m_pathIndex.find(path);
+            return it == m_pathIndex.end() || m_slots[it->second].references == 0;
+        }
+
+        //Extra name the asset can be found by, e.g. the source model name of a cooked model
+        void addName(const std::string& name, uint32_t index)
+        {
+            if (!name.empty())
+                m_nameIndex.try_emplace(name, index);
+        }
+
+        [[nodiscard]] T* get(AssetHandle<T> handle) const
+        {
+            if (!contains(handle))
+                return nullptr;
+
+            return m_slots[handle.index].asset.get();
+        }
+
+        //True while the slot is alive, evicted or not
+        [[nodiscard]] bool contains(AssetHandle<T> handle) const
+        {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation && !m_slots[handle.index].path.empty();
+        }
+
+        [[nodiscard]] bool isEvicted(AssetHandle<T> handle) const
+        {
+            return contains(handle) && !m_slots[handle.index].asset;
+        }
+
+        //Drops the asset but keeps its slot, path and generation so handles reload it instead of going stale
+        void evict(AssetHandle<T> handle)
+        {
+            if (contains(handle))
+                m_slots[handle.index].asset.reset();
+        }
+
+        void restore(AssetHandle<T> handle, std::unique_ptr<T> asset)
+        {
+            if (contains(handle))
+                m_slots[handle.index].asset = std::move(asset);
+        }
+
+        void acquire(AssetHandle<T> handle)
+        {
+            if (contains(handle))
+                ++m_slots[handle.index].references;
+        }
+
+        void release(AssetHandle<T> handle)
+        {
+            if (contains(handle) && m_slots[handle.index].references > 0)
+                --m_slots[handle.index].references;
+        }
+
+        [[nodiscard]] uint32_t getReferences(AssetHandle<T> handle) const
+        {
+            return contains(handle) ? m_slots[handle.index].references : 0;
+        }
+
+        void touch(AssetHandle<T> handle, uint64_t tick)
+        {
+            if (contains(handle))
+                m_slots[handle.index].lastUsed = tick;
+        }
+
+        [[nodiscard]] uint64_t getLastUsed(AssetHandle<T> handle) const
+        {
+            return contains(handle) ? m_slots[handle.index].lastUsed : 0;
+        }
+
+        [[nodiscard]] AssetHandle<T> find(const std::string& pathOrName) const
+        {
+            if (const auto it = m_pathIndex.find(pathOrName); it != m_pathIndex.end())
+                return {it->second, m_slots[it->second].generation};
+
+            if (const auto it = m_nameIndex.find(pathOrName); it != m_nameIndex.end())
+                return {it->second, m_slots[it->second].generation};
+
+            return {};
+        }
+
+        [[nodiscard]] const std::string& getPath(AssetHandle<T> handle) const
+        {
+            static const std::string empty;
+            return contains(handle) ? m_slots[handle.index].path : empty;
+        }
+
+        bool remove(AssetHandle<T> handle)
+        {
+            if (!contains(handle))
+                return false;
+
+            auto& slot = m_slots[handle.index];
+
+            m_pathIndex.erase(slot.path);
+
+            std::erase_if(m_nameIndex, [&handle](const auto& entry) { return entry.second == handle.index; });
+
+            slot.asset.reset();
+            slot.path.clear();
+            slot.references = 0;
+            slot.lastUsed = 0;
+            ++slot.generation;
+
+            m_freeSlots.push_back(handle.index);
+
+            return true;
+        }
+
+        template<typename F>
+        void forEach(F&& function) const
+        {
+            for (uint32_t index = 0; index < m_slots.size(); ++index)
+                if (m_slots[index].asset)
+                    function(AssetHandle<T>{index, m_slots[index].generation}, m_slots[index].asset.get());
+        }
+
+    private:
+        struct Slot
+        {
+            std::unique_ptr<T> asset{nullptr};
+            std::string path;
+            uint32_t generation{1};
+            uint32_t references{0};
+            uint64_t lastUsed{0};
+        };
+
+        static std::string getFileName(std::string_view path)
+        {
+            const size_t separator = path.find_last_of("/\\");
+            return std::string(separator == std::string_view::npos ? path : path.substr(separator + 1));
+        }
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        std::unordered_map<std::string, uint32_t> m_pathIndex;
+        std::unordered_map<std::string, uint32_t> m_nameIndex;
+    };
+
     class AssetsCache
     {
     public:
         elix::Asset* addAsset(const std::string& path, std::unique_ptr<elix::Asset> asset);
 
+        template<typename T>
+        AssetHandle<T> addAsset(const std::string& path, std::unique_ptr<T> asset)
+        {
+            if constexpr (std::is_same_v<T, AssetMaterial>)
+            {
+                if (getStorage<T>().isReplaceable(path))
+                {
+                    acquireDependencies(asset.get());
+
+                    //Replacing a cached material drops the references its previous version held
+                    releaseDependencies(getStorage<T>().get(getStorage<T>().find(path)));
+                }
+            }
+
+            const auto handle = getStorage<T>().add(path, std::move(asset));
+            getStorage<T>().touch(handle, ++m_accessTick);
+            trim();
+
+            return handle;
+        }
+
+        //Decodes every file on the shared thread pool and bakes the results on the calling thread as they arrive.
+        //Must be called from the OpenGL thread. Returns the assets that were imported
+        std::vector<elix::Asset*> importAssets(const std::vector<std::string>& paths);
+
+        template<typename T>
+        [[nodiscard]] AssetHandle<T> getHandle(const std::string& pathOrName) const
+        {
+            if constexpr (hasTypedStorage<T>())
+                return std::get<AssetStorage<T>>(m_storages).find(pathOrName);
+            else
+                return {};
+        }
+
+        //Marks the asset as used and reloads it if it was evicted. Must be called from the OpenGL thread
+        template<typename T>
+        [[nodiscard]] T* getAsset(AssetHandle<T> handle)
+        {
+            auto& storage = getStorage<T>();
+
+            storage.touch(handle, ++m_accessTick);
+
+            if (storage.isEvicted(handle))
+                reloadAsset(handle);
+
+            return storage.get(handle);
+        }
+
+        template<typename T>
+        T* getAsset(const std::string& path)
+        {
+            if constexpr (hasTypedStorage<T>())
+                return getAsset(getHandle<T>(path));
+            else
+                return dynamic_cast<T*>(m_customAssets.get(m_customAssets.find(path)));
+        }
+
+        //Lookup without bookkeeping or reloading. Evicted assets return nullptr. Safe to call from loaders running
+        //on worker threads while nothing is added to the cache
+        template<typename T>
+        [[nodiscard]] T* findAsset(const std::string& pathOrName) const
+        {
+            return std::get<AssetStorage<T>>(m_storages).get(getHandle<T>(pathOrName));
+        }
+
         template<typename T>
         std::vector<T*> getAllAssets()
         {
             std::vector<T*> result;
 
-            for (const auto& [_, asset] : m_assets)
-                if (auto dynamicAsset = dynamic_cast<T*>(asset.get()))
-                    result.push_back(dynamicAsset);
+            if constexpr (hasTypedStorage<T>())
+                getStorage<T>().forEach([&result](AssetHandle<T>, T* asset) { result.push_back(asset); });
+            else
+                m_customAssets.forEach([&result](AssetHandle<elix::Asset>, elix::Asset* asset)
+                {
+                    if (auto dynamicAsset = dynamic_cast<T*>(asset))
+                        result.push_back(dynamicAsset);
+                });
 
             return result;
         }
 
         template<typename T>
-        T* getAsset(const std::string& path)
+        bool removeAsset(AssetHandle<T> handle)
         {
-            if (const auto it = m_assets.find(path); it != m_assets.end())
-                return dynamic_cast<T*>(it->second.get());
+            if constexpr (std::is_same_v<T, AssetMaterial>)
+                releaseDependencies(getStorage<T>().get(handle));
+
+            return getStorage<T>().remove(handle);
+        }
 
-            for (const auto& [pathToAsset, asset] : m_assets)
-                if (std::string justAName = std::filesystem::path(pathToAsset).filename().string(); justAName == path)
-                    return dynamic_cast<T*>(asset.get());
+        //Referenced assets are never evicted. Scenes and components hold references through elix::AssetReference
+        template<typename T>
+        void acquire(AssetHandle<T> handle)
+        {
+            getStorage<T>().acquire(handle);
+        }
 
-            return nullptr;
+        template<typename T>
+        void release(AssetHandle<T> handle)
+        {
+            getStorage<T>().release(handle);
         }
 
+        //Decodes the asset again from its path, replacing whatever is resident. Must be called from the OpenGL thread
+        template<typename T>
+        bool reloadAsset(AssetHandle<T> handle)
+        {
+            auto& storage = getStorage<T>();
+
+            if (!storage.contains(handle))
+                return false;
+
+            storage.touch(handle, ++m_accessTick);
+
+            auto asset = loadFromPath(storage.getPath(handle));
+
+            bool typeMatches = asset != nullptr;
+
+            if constexpr (hasTypedStorage<T>())
+                typeMatches = typeMatches && asset->getType() == T::TYPE;
+
+            if (!typeMatches)
+            {
+                ELIX_LOG_ERROR("Failed to reload asset ", storage.getPath(handle));
+                return false;
+            }
+
+            if constexpr (std::is_same_v<T, AssetMaterial>)
+            {
+                releaseDependencies(storage.get(handle));
+                acquireDependencies(static_cast<AssetMaterial*>(asset.get()));
+            }
+
+            storage.restore(handle, std::unique_ptr<T>(static_cast<T*>(asset.release())));
+            trim();
+
+            return true;
+        }
+
+        //Budget for everything resident in the cache, CPU and GPU together. 0 disables eviction
+        void setMemoryBudget(size_t bytes);
+        [[nodiscard]] size_t getMemoryBudget() const;
+
+        [[nodiscard]] Asset::MemoryUsage getMemoryUsage(AssetType type) const;
+        [[nodiscard]] Asset::MemoryUsage getMemoryUsage() const;
+
+        //Evicts unreferenced models and textures, least recently used first, until the cache fits the budget
+        void trim();
+
+    private:
+        using Storages = std::tuple<AssetStorage<AssetModel>, AssetStorage<AssetTexture>, AssetStorage<AssetMaterial>, AssetStorage<AssetAnimation>>;
+
+        template<typename T>
+        static constexpr bool hasTypedStorage()
+        {
+            return std::is_same_v<T, AssetModel> || std::is_same_v<T, AssetTexture> || std::is_same_v<T, AssetMaterial> || std::is_same_v<T, AssetAnimation>;
+        }
+
+        template<typename T>
+        AssetStorage<T>& getStorage()
+        {
+            if constexpr (hasTypedStorage<T>())
+                return std::get<AssetStorage<T>>(m_storages);
+            else
+                return m_customAssets;
+        }
+
+        std::unique_ptr<elix::Asset> loadFromPath(const std::string& path);
+
+        void acquireDependencies(const AssetMaterial* material);
+        void releaseDependencies(const AssetMaterial* material);
+
+        Storages m_storages;
+
+        //Assets from user registered loaders
+        AssetStorage<elix::Asset> m_customAssets;
+
+        size_t m_memoryBudget{0};
+        uint64_t m_accessTick{0};
+    };
+
+    //Owning reference to a cached asset. While any reference exists the asset stays resident.
+    //The cache has to outlive every reference taken from it
+    template<typename T>
+    class AssetReference
+    {
+    public:
+        AssetReference() = default;
+
+        AssetReference(AssetsCache* cache, AssetHandle<T> handle) : m_cache(cache), m_handle(handle)
+        {
+            if (m_cache)
+                m_cache->acquire(m_handle);
+        }
+
+        AssetReference(const AssetReference& other) : AssetReference(other.m_cache, other.m_handle) {}
+
+        AssetReference(AssetReference&& other) noexcept : m_cache(other.m_cache), m_handle(other.m_handle)
+        {
+            other.m_cache = nullptr;
+        }
+
+        AssetReference& operator=(AssetReference other) noexcept
+        {
+            std::swap(m_cache, other.m_cache);
+            std::swap(m_handle, other.m_handle);
+            return *this;
+        }
+
+        ~AssetReference()
+        {
+            if (m_cache)
+                m_cache->release(m_handle);
+        }
+
+        [[nodiscard]] T* get() const { return m_cache ? m_cache->getAsset(m_handle) : nullptr; }
+        [[nodiscard]] AssetHandle<T> getHandle() const { return m_handle; }
+
+        T* operator->() const { return get(); }
+        explicit operator bool() const { return get() != nullptr; }
+
     private:
-        std::unordered_map<std::string, std::unique_ptr<elix::Asset>> m_assets;
+        AssetsCache* m_cache{nullptr};
+        AssetHandle<T> m_handle;
     };
 } //namespace elix
 #endif //ASSETS_CACHE_HPP
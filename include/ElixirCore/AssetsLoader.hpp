@@ -1,7 +1,9 @@
 #ifndef ASSETS_LOADER_HPP
 #define ASSETS_LOADER_HPP
 
+#include <functional>
 #include <memory>
+#include <span>
 #include "Assets.hpp"
 #include "AssetsCache.hpp"
 
@@ -10,17 +12,52 @@ namespace elix
     class AssetsLoader
     {
     public:
+        //Every file is matched to exactly one loader from its extension and first bytes, then decoded once
+        struct Loader
+        {
+            std::string name;
+            //Receives the lower case extension with the dot, e.g. ".png"
+            std::function<bool(const std::string& extension)> matchesExtension;
+            //Receives the first bytes of the file. Must not decode anything
+            std::function<bool(std::span<const unsigned char> header)> probe;
+            std::function<std::unique_ptr<elix::Asset>(const std::string& filePath, elix::AssetsCache* cache, Asset::LoadStatistics& statistics)> decode;
+            //Loaders that resolve other assets through the cache (materials) run after everything else in a batch import
+            bool requiresCache{false};
+        };
+
+        static void registerLoader(const Loader& loader);
+
+        [[nodiscard]] static const Loader* findLoader(const std::string& filePath, std::span<const unsigned char> header);
+
+        [[nodiscard]] static bool requiresCache(const std::string& filePath);
+
         template<typename T>
         static std::unique_ptr<T> loadAsset(const std::string& filePath)
         {
             return loadAnimation(filePath);
         }
 
+        //Decodes and bakes the asset. Must run on the OpenGL thread
         static std::unique_ptr<elix::Asset> loadAsset(const std::string& filePath, elix::AssetsCache* cache = nullptr);
 
+        //CPU only part of loadAsset, safe to call from worker threads. The result still has to be baked on the OpenGL thread
+        static std::unique_ptr<elix::Asset> decodeAsset(const std::string& filePath, elix::AssetsCache* cache = nullptr);
+
+        //Runs the Assimp import without touching OpenGL. Used by loadModel and by the offline cooker
+        static bool importModel(const std::string& filePath, std::vector<common::MeshData>& meshes, Skeleton& skeleton);
+
+        //Welds, reorders and builds LODs for imported meshes in loadModel, see MeshOptimizer and MeshSimplifier. Off by default,
+        //cooked models get all of it offline
+        static void setMeshOptimization(bool enabled);
+        [[nodiscard]] static bool isMeshOptimizationEnabled();
+
     private:
+        static void registerDefaultLoaders();
+
         static std::unique_ptr<AssetTexture> loadTexture(const std::string& filePath);
+        static std::unique_ptr<AssetTexture> loadCookedTexture(const std::string& filePath);
         static std::unique_ptr<AssetModel> loadModel(const std::string& filePath);
+        static std::unique_ptr<AssetModel> loadCookedModel(const std::string& filePath, elix::AssetsCache* cache);
         static std::unique_ptr<AssetMaterial> loadMaterial(const std::string& filePath, elix::AssetsCache* cache);
         static std::unique_ptr<AssetAnimation> loadAnimation(const std::string& filePath);
 
@@ -12,7 +12,9 @@ namespace elix
         {
             Vertex,
             Index,
-            Uniform
+            Uniform,
+            //Needs OpenGL 4.3
+            ShaderStorage
         };
 
         enum class BufferUsage
@@ -33,6 +35,11 @@ namespace elix
 
         void uploadRaw(const void* data, size_t size);
 
+        //Binds the buffer to an indexed binding point of its type, uniform and shader storage buffers only
+        void bindBase(unsigned int index) const;
+
+        unsigned int getId() const;
+
         ~Buffer();
     private:
         unsigned int m_id{0};
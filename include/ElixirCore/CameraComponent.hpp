@@ -13,6 +13,8 @@ namespace elix
         CameraComponent();
 
         void update(float deltaTime) override;
+        [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::NONE, elix::Resource::CAMERA}; }
+        [[nodiscard]] bool isThreadSafe() const override { return true; }
 
         [[nodiscard]] glm::vec3 getPosition() const;
         [[nodiscard]] glm::vec3 getForward() const;
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "AnimationClip.hpp"
 #include "Material.hpp"
 class Skeleton;
 class GameObject;
@@ -32,57 +33,75 @@ namespace common
         glm::vec4 weight = glm::vec4(0);
     };
 
+    //Simplified index buffer over the vertices of its mesh. error is the distance to the source surface in model units
+    struct MeshLod
+    {
+        std::vector<unsigned int> indices;
+        float error{0.0f};
+    };
+
+    //CPU side mesh data, produced by the importers before anything touches OpenGL
+    struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        std::string materialSlot;
+        //Coarser levels after the full detail indices, see elix::MeshSimplifier
+        std::vector<MeshLod> lods;
+    };
+
+    struct BoundingBox
+    {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+
+        [[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+        [[nodiscard]] float getRadius() const { return glm::length(max - min) * 0.5f; }
+    };
+
+    //How much an object matters this frame, filled by elix::SignificanceManager
+    struct Significance
+    {
+        //Zero for objects nobody notices, one and above for objects that update every frame
+        float score{1.0f};
+        float distance{0.0f};
+        bool isVisible{true};
+    };
+
+    //Authoring record of a bone, the way importers build a skeleton. Skeleton flattens them for evaluation
     struct BoneInfo
     {
         std::string name{"Undefined"};
         int id{-1};
         glm::mat4 offsetMatrix{1.0f};
-        glm::mat4 finalTransformation{1.0f};
         glm::mat4 localBindTransform{1.0f};
         glm::mat4 globalBindTransform{1.0f};
         std::vector<int> children;
-        std::vector<BoneInfo*> childrenInfo;
         int parentId{-1};
 
         BoneInfo() = default;
 
-        BoneInfo(const std::string& boneName, int boneId, const glm::mat4& boneOffsetMatrix, const glm::mat4& boneFinalTransformation)
+        BoneInfo(const std::string& boneName, int boneId, const glm::mat4& boneOffsetMatrix)
         {
             name = boneName;
             id = boneId;
             offsetMatrix = boneOffsetMatrix;
-            finalTransformation = boneFinalTransformation;
         }
     };
 
-    struct SQT
-    {
-        glm::quat rotation{1, 0, 0, 0};
-        glm::vec3 position{0, 0, 0};
-        glm::vec3 scale{0, 0, 0};
-        float timeStamp{0.0f};
-    };
-
-    struct AnimationTrack
-    {
-        std::vector<SQT> keyFrames;
-        std::string objectName;
-    };
-
     struct Animation
     {
         std::string name;
         double ticksPerSecond;
         double duration;
-        std::vector<AnimationTrack> boneAnimations;
+        elix::AnimationClip clip;
         Skeleton* skeletonForAnimation{nullptr};
         GameObject* gameObject{nullptr};
 
-        common::AnimationTrack* getAnimationTrack(const std::string& name)
-        {
-            const auto it = std::find_if(boneAnimations.begin(), boneAnimations.end(), [&name](const auto& bone) {return bone.objectName == name;});
-            return it == boneAnimations.end() ? nullptr : &(*it);
-        }
+        //Clip track of every bone of boundSkeleton in its evaluation order, -1 where the clip does not animate the bone.
+        //Rebuilt by the animator whenever skeletonForAnimation changes
+        std::vector<int> boneTracks;
+        const Skeleton* boundSkeleton{nullptr};
     };
 } //namespace common
 
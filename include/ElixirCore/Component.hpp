@@ -1,13 +1,37 @@
 #ifndef COMPONENT_HPP
 #define COMPONENT_HPP
 
+#include "UpdatePhase.hpp"
+
 class GameObject;
 
+//How far an insignificant object may throttle the component's update, see elix::SignificanceManager
+struct TickBudget
+{
+    //Rate in Hz the update falls to at zero significance. Zero keeps the component updating every frame
+    float minRate{0.0f};
+    //Significance from which the component updates every frame again
+    float fullRateSignificance{0.5f};
+};
+
 class Component
 {
 public:
     virtual void update(float deltaTime) = 0;
 
+    //Calls update with all the time gathered since the previous call once the budget allows it at this significance
+    void tick(float deltaTime, float significance);
+
+    //Phase elix::Scheduler updates the component in and the state its update touches. Components of one type form a
+    //job, jobs of a phase run in parallel unless their access conflicts
+    [[nodiscard]] virtual elix::UpdatePhase getUpdatePhase() const { return elix::UpdatePhase::Gameplay; }
+    [[nodiscard]] virtual elix::Access getAccess() const { return {}; }
+    //True if update only touches the component and its owner, instances of the type are then split over the pool
+    [[nodiscard]] virtual bool isThreadSafe() const { return false; }
+
+    void setTickBudget(const TickBudget& budget) { m_tickBudget = budget; }
+    [[nodiscard]] const TickBudget& getTickBudget() const { return m_tickBudget; }
+
     virtual void setOwner(GameObject* owner) { m_owner = owner; }
     [[nodiscard]] GameObject* getOwner() const { return m_owner; }
 
@@ -15,6 +39,8 @@ public:
     virtual ~Component() = default;
 private:
     GameObject* m_owner{nullptr};
+    TickBudget m_tickBudget;
+    float m_pendingTime{0.0f};
 };
 
 #endif //COMPONENT_HPP
@@ -11,17 +11,21 @@ namespace elix
         enum class DrawMode
         {
             TRIANGLES,
-            LINES
+            LINES,
+            POINTS
         };
 
         enum class DrawType
         {
-            UNSIGNED_INT
+            UNSIGNED_INT,
+            UNSIGNED_SHORT
         };
 
         static void draw(DrawMode drawMode, size_t count, DrawType drawType = DrawType::UNSIGNED_INT, const void* indices = nullptr);
 
         static void drawArrays(DrawMode drawMode, size_t first, size_t count);
+
+        static void drawInstanced(DrawMode drawMode, size_t count, DrawType drawType, const void* indices, size_t instanceCount);
     };
 } //namespace elix
 
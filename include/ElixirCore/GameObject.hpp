@@ -3,80 +3,120 @@
 
 #include <functional>
 #include <memory>
-#include <typeindex>
 #include <unordered_map>
+#include <vector>
 
 #include "Common.hpp"
 #include "Component.hpp"
 #include "Material.hpp"
+#include "Registry.hpp"
 #include "ScriptsRegister.hpp"
+#include "Transform.hpp"
 
+class Scene;
+
+//Handle to an entity of elix::Registry. Components and the transform live in the registry's archetype columns, the
+//object keeps only what is not queried in bulk
 class GameObject
 {
 public:
     explicit GameObject(const std::string&name);
 
+    GameObject(const GameObject&) = delete;
+    GameObject& operator=(const GameObject&) = delete;
+
     virtual void setLayerMask(const common::LayerMask& layerMask);
     virtual void setPosition(const glm::vec3& position);
     virtual void setScale(const glm::vec3& scale);
+    //Euler angles in degrees, applied as yaw (y), pitch (x), roll (z)
     virtual void setRotation(const glm::vec3 &axis);
+    virtual void setOrientation(const glm::quat& orientation);
     virtual void setName(const std::string& name);
+    //Free form group, Scene indexes objects by it
+    void setTag(const std::string& tag);
 
     void setPositionChangedCallback(const std::function<void(const glm::vec3&)>& callback);
+    //Called by elix::TransformSystem::update once per frame the world matrix changed, not by every setter
     void setTransformationChangedCallback(const std::function<void(const glm::mat4&)>& callback);
 
+    //Position, rotation and scale are local, relative to the parent
     [[nodiscard]] glm::vec3 getPosition() const;
     [[nodiscard]] glm::vec3 getScale() const;
     [[nodiscard]] glm::vec3 getRotation() const;
+    [[nodiscard]] glm::quat getOrientation() const;
     [[nodiscard]] const common::LayerMask& getLayerMask() const;
     [[nodiscard]] const std::string& getName() const;
+    [[nodiscard]] const std::string& getTag() const;
+    //Scene the object was added to, nullptr once it is removed
+    [[nodiscard]] Scene* getScene() const;
+    //World matrix
     glm::mat4 getTransformMatrix();
+    //Decomposed into the local position, rotation and scale
     void setTransformMatrix(const glm::mat4& transformMatrix);
 
+    //nullptr detaches. The local transform is kept, so the world placement follows the new parent. Returns false if
+    //parent is this object or one of its descendants
+    bool setParent(GameObject* parent);
+    [[nodiscard]] GameObject* getParent() const;
+    [[nodiscard]] const std::vector<GameObject*>& getChildren() const;
+
     virtual void destroy();
+    //Ticks every component in type id order, throttled by their budgets and the object's significance. Scene leaves
+    //this to its elix::Scheduler
     virtual void update(float deltaTime);
 
+    //Multiplies the significance of the object, raise it for the player and anything the camera follows
+    void setSignificancePriority(float priority);
+    [[nodiscard]] float getSignificancePriority() const;
+
+    void setSignificance(const common::Significance& significance);
+    [[nodiscard]] const common::Significance& getSignificance() const;
+
+    //Replaces a component of the same type. The pointer stays valid until the component is replaced or the object dies
     template<typename T, typename... Args>
     T* addComponent(Args&&... args)
     {
         static_assert(!std::is_abstract_v<T>, "GameObject::addComponent() Cannot add abstract component!");
         static_assert(std::is_base_of_v<Component, T>, "GameObject::addComponent() T must derive from Component class");
 
-        const auto type = std::type_index(typeid(T));
-        auto comp = std::make_shared<T>(std::forward<Args>(args)...);
-        T* ptr = comp.get();
-        comp->setOwner(this);
-        m_components[type] = std::move(comp);
-        return ptr;
+        T& component = elix::Registry::instance().add<T>(m_entity, std::forward<Args>(args)...);
+        component.setOwner(this);
+        return &component;
     }
 
     template<typename T>
     T* getComponent()
     {
-        const auto it = m_components.find(std::type_index(typeid(T)));
-        return it != m_components.end() ? static_cast<T*>(it->second.get()) : nullptr;
+        return elix::Registry::instance().get<T>(m_entity);
     }
 
     template<typename T>
     bool hasComponent() const
     {
-        return m_components.contains(std::type_index(typeid(T)));
+        return elix::Registry::instance().has<T>(m_entity);
     }
 
+    [[nodiscard]] elix::Entity getEntity() const;
+
     virtual ~GameObject();
 
     std::unordered_map<int, Material*> overrideMaterials;
 private:
-    glm::mat4 m_transformMatrix;
-    bool m_isTransformMatrixDirty{true};
+    friend class Scene;
+
+    [[nodiscard]] elix::Transform& getTransform() const;
+
+    elix::Entity m_entity;
+    uint32_t m_transformNode;
+    GameObject* m_parent{nullptr};
+    std::vector<GameObject*> m_children;
     std::function<void(const glm::vec3&)> m_positionChangedCallback;
-    std::function<void(const glm::mat4&)> m_transformationChangedCallback;
-    std::unordered_map<std::type_index, std::shared_ptr<Component>> m_components;
     common::LayerMask m_layerMask{common::LayerMask::DEFAULT};
-    glm::vec3 m_position{glm::vec3(0.0f, 0.0f, 0.0f)};
-    glm::vec3 m_scale{glm::vec3(1.0f, 1.0f, 1.0f)};
-    glm::vec3 m_rotation{0.0f};
     std::string m_name;
+    std::string m_tag;
+    Scene* m_scene{nullptr};
+    common::Significance m_significance;
+    float m_significancePriority{1.0f};
 };
 
 #endif //GAME_OBJECT_HPP
\ No newline at end of file
@@ -12,6 +12,9 @@ public:
     explicit LightComponent(const lighting::Light& light);
 
     void update(float deltaTime) override;
+    [[nodiscard]] elix::UpdatePhase getUpdatePhase() const override { return elix::UpdatePhase::Late; }
+    [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::TRANSFORMS, elix::Resource::LIGHTS}; }
+    [[nodiscard]] bool isThreadSafe() const override { return true; }
 
     lighting::Light* getLight();
 
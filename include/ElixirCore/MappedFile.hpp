@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace elix
+{
+    //Read-only memory mapping of a whole file. Pages are shared with every other process mapping the same file
+    class MappedFile
+    {
+    public:
+        static std::shared_ptr<MappedFile> open(const std::string& filePath);
+
+        [[nodiscard]] const std::byte* data() const;
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] const std::string& getPath() const;
+
+        template<typename T>
+        [[nodiscard]] const T* at(size_t offset) const
+        {
+            return reinterpret_cast<const T*>(m_data + offset);
+        }
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+    private:
+        MappedFile() = default;
+
+        const std::byte* m_data{nullptr};
+        size_t m_size{0};
+        std::string m_path;
+
+#ifdef _WIN32
+        void* m_fileHandle{nullptr};
+        void* m_mappingHandle{nullptr};
+#else
+        int m_fileDescriptor{-1};
+#endif
+    };
+} //namespace elix
+
+#endif //MAPPED_FILE_HPP
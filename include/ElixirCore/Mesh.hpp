@@ -4,30 +4,126 @@
 #include "Common.hpp"
 #include "VertexArray.hpp"
 #include "Material.hpp"
+#include "MappedFile.hpp"
+#include "VertexFormat.hpp"
+#include "Buffer.hpp"
+
+#include <memory>
+#include <span>
 
 namespace elix
 {
     class Mesh
     {
     public:
+        //Range of the shared index buffer one detail level draws. Level 0 is the full mesh
+        struct Lod
+        {
+            uint32_t indexOffset{0};
+            uint32_t indexCount{0};
+            //Distance to the full detail surface in model units
+            float error{0.0f};
+        };
+
+        //Packs the vertices into the static or skinned layout, indices become 16 bit when the vertex count allows it
         Mesh(const std::vector<common::Vertex>& vertices, const std::vector<unsigned int>& indices);
 
-        void draw() const;
+        //Same as above, the LOD index buffers of meshData are appended after the full detail one
+        explicit Mesh(const common::MeshData& meshData);
+
+        //Packed vertices and indices are read straight from a mapped cooked model, nothing is copied on the CPU side.
+        //Without lods the whole index range is the only level
+        Mesh(std::shared_ptr<const elix::MappedFile> source, VertexLayout vertexLayout, std::span<const std::byte> vertices, IndexType indexType, std::span<const std::byte> indices,
+             std::vector<Lod> lods = {});
+
+        //Uploads the vertex and index buffers. Has to run on the OpenGL thread, draw() does it lazily otherwise
+        void bake();
+
+        [[nodiscard]] bool isBaked() const;
+
+        //Frees the GPU copy. The mesh is uploaded again on the next bake() or draw()
+        void release();
+
+        //Draws with the depth only stream while a depth only pass is active and the mesh has one, the full vertex otherwise.
+        //lod is clamped to the coarsest level
+        void draw(size_t lod = 0) const;
+
+        //instanceCount copies of draw(lod), the shader tells them apart by gl_InstanceID. Shaders that fetch per vertex
+        //data by gl_VertexID pass useDepthStream false, the depth stream has its own vertex order
+        void drawInstanced(size_t lod, size_t instanceCount, bool useDepthStream = true) const;
+
+        //Draws the index range of lod through another vertex array, one that got the index buffer from attachIndexBuffer
+        void draw(const elix::VertexArray& vertexArray, size_t lod, size_t instanceCount = 1) const;
+
+        //Binds the index buffer into the vertex array currently bound. The mesh has to be baked
+        void attachIndexBuffer() const;
+
+        //Every vertex once as a point in index order of the vertex buffer, for transform feedback passes
+        void drawVertices() const;
+
+        [[nodiscard]] size_t getLodCount() const;
+        [[nodiscard]] const Lod& getLod(size_t lod) const;
+
+        //Shadow passes set this in ShadowHandler, a depth prepass can set it around its draws
+        static void setDepthOnlyPass(bool isDepthOnly);
+        [[nodiscard]] static bool isDepthOnlyPass();
+
+        //Whether meshes uploaded from now on get a separate position (and skinning) stream for depth only passes. On by default
+        static void setDepthStreamsEnabled(bool enabled);
+        [[nodiscard]] static bool isDepthStreamsEnabled();
+
+        [[nodiscard]] bool hasDepthStream() const;
+
+        //Bytes the uploaded buffers take, depth stream included. Zero while not baked
+        [[nodiscard]] size_t getGpuMemorySize() const;
 
         void setMaterial(Material* material);
 
+        void setMaterialSlot(const std::string& materialSlot);
+
         [[nodiscard]] Material* getMaterial() const;
 
+        [[nodiscard]] const std::string& getMaterialSlot() const;
+
         [[nodiscard]] bool hasBones() const;
+
+        [[nodiscard]] VertexLayout getVertexLayout() const;
+        [[nodiscard]] IndexType getIndexType() const;
+
+        [[nodiscard]] size_t getVertexCount() const;
+        [[nodiscard]] size_t getIndexCount() const;
+
+        [[nodiscard]] std::span<const std::byte> getVertexData() const;
+        [[nodiscard]] std::span<const std::byte> getIndexData() const;
     private:
-        uint32_t m_indicesCount{0};
+        void upload() const;
 
-        elix::VertexArray m_vertexArray;
+        void uploadDepthStream(std::span<const std::byte> vertices, std::span<const std::byte> indices) const;
+
+        mutable bool m_isBaked{false};
+        mutable size_t m_gpuMemorySize{0};
+
+        VertexLayout m_vertexLayout{VertexLayout::Static};
+        IndexType m_indexType{IndexType::UInt32};
+
+        std::vector<Lod> m_lods;
+
+        mutable elix::VertexArray m_vertexArray;
+        //Kept so other vertex arrays can share it
+        mutable std::shared_ptr<elix::Buffer> m_indexBuffer{nullptr};
+        mutable elix::VertexArray m_depthVertexArray;
+        mutable bool m_hasDepthStream{false};
 
         Material* m_material{Material::getDefaultMaterial().get()};
 
-        std::vector<common::Vertex> m_vertices;
-        std::vector<unsigned int> m_indices;
+        std::string m_materialSlot;
+
+        std::vector<std::byte> m_vertices;
+        std::vector<std::byte> m_indices;
+
+        std::shared_ptr<const elix::MappedFile> m_source{nullptr};
+        std::span<const std::byte> m_mappedVertices;
+        std::span<const std::byte> m_mappedIndices;
     };
 }
 
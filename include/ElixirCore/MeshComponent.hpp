@@ -4,22 +4,78 @@
 #include "Component.hpp"
 #include "Model.hpp"
 #include "Material.hpp"
+#include "AssetsCache.hpp"
+#include "SkinningCache.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace elix
+{
+    class CameraComponent;
+}
 
 class MeshComponent final : public Component
 {
 public:
+    struct LodSettings
+    {
+        //Largest error in pixels a level may show on screen
+        float maxScreenError{1.0f};
+        //How far past the threshold the error has to go before the level changes, keeps boundaries from flickering
+        float hysteresis{0.25f};
+        //Objects projecting smaller than this many pixels are not drawn at all
+        float cullScreenSize{2.0f};
+        //Levels added on top while a depth only pass (shadows) draws
+        uint32_t shadowLodBias{1};
+    };
+
     explicit MeshComponent(elix::Model* model) : m_model(model) {}
 
-    void render(std::unordered_map<int, Material*> *overrideMaterials = nullptr) const
-    {
-        overrideMaterials ? m_model->drawWithMaterials(*overrideMaterials) : m_model->draw();
-    }
+    //Keeps the model resident in the cache for the lifetime of the component
+    explicit MeshComponent(const elix::AssetReference<elix::AssetModel>& modelReference) : m_model(modelReference ? modelReference->getModel() : nullptr), m_modelReference(modelReference) {}
+
+    //Draws the level picked by selectLod, nothing if the object was culled or is instanced. Pre-skinned models draw from the
+    //skinning cache, see isPreSkinned
+    void render(std::unordered_map<int, Material*> *overrideMaterials = nullptr) const;
+
+    //Whether render draws vertices elix::SkinningCache already skinned. Bind the STATIC shaders for every pass then,
+    //the SKELETON ones otherwise
+    [[nodiscard]] bool isPreSkinned() const;
+
+    //Created on first use
+    [[nodiscard]] elix::SkinningCache& getSkinningCache();
+
+    //Set by elix::SkinnedRenderer for the frame, render draws nothing then
+    void setInstanced(bool isInstanced) {m_isInstanced = isInstanced;}
+    [[nodiscard]] bool isInstanced() const {return m_isInstanced;}
 
     void update(float deltaTime) override {}
+    [[nodiscard]] elix::UpdatePhase getUpdatePhase() const override { return elix::UpdatePhase::Late; }
+    [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::NONE, elix::Resource::NONE}; }
+    [[nodiscard]] bool isThreadSafe() const override { return true; }
+
+    //Picks the detail level from the projected size of the model bounds. Call once per frame before rendering
+    void selectLod(const elix::CameraComponent& camera, float viewportHeight);
+
+    //selectLod for the MeshComponent of every object
+    static void selectLods(const std::vector<std::shared_ptr<GameObject>>& objects, const elix::CameraComponent& camera, float viewportHeight);
+
+    static void setLodSettings(const LodSettings& settings);
+    [[nodiscard]] static const LodSettings& getLodSettings();
 
     [[nodiscard]] elix::Model* getModel() const {return m_model;}
+    [[nodiscard]] size_t getLod() const {return m_lod;}
+    [[nodiscard]] bool isCulled() const {return m_isCulled;}
 private:
     elix::Model* m_model{nullptr};
+    elix::AssetReference<elix::AssetModel> m_modelReference;
+
+    size_t m_lod{0};
+    bool m_isCulled{false};
+    bool m_isInstanced{false};
+
+    std::unique_ptr<elix::SkinningCache> m_skinningCache{nullptr};
 };
 
 #endif //MESH_COMPONENT_HPP
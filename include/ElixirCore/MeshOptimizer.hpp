@@ -0,0 +1,51 @@
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace elix
+{
+    //Import time passes over CPU side meshes. Nothing in here touches OpenGL
+    class MeshOptimizer
+    {
+    public:
+        //Post transform cache size the statistics are simulated with, a conservative FIFO most GPUs beat
+        static constexpr uint32_t CACHE_SIZE = 16;
+
+        struct Statistics
+        {
+            size_t vertexCountBefore{0};
+            size_t vertexCountAfter{0};
+            float acmrBefore{0.0f};
+            float acmrAfter{0.0f};
+        };
+
+        //Welds duplicates, reorders for the vertex cache then for overdraw and finally remaps vertices in fetch order
+        static Statistics optimize(common::MeshData& mesh);
+
+        //Optimizes every mesh, the statistics are summed up with the miss ratios weighted by triangle count
+        static Statistics optimize(std::vector<common::MeshData>& meshes);
+
+        //Merges bitwise identical vertices. Returns the number of vertices left
+        static size_t weldVertices(std::vector<common::Vertex>& vertices, std::vector<unsigned int>& indices);
+
+        //Linear time triangle reordering after Forsyth, scores vertices by cache position and remaining valence
+        static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+        //Splits a cache optimized index buffer into clusters at cache restarts and sorts them outside in. Keeps the
+        //previous order if the cache miss ratio grows by more than threshold
+        static void optimizeOverdraw(std::vector<unsigned int>& indices, std::span<const common::Vertex> vertices, float threshold = 1.05f);
+
+        //Orders vertices by first use in the index buffer so the vertex fetch walks memory linearly
+        static void optimizeVertexFetch(std::vector<common::Vertex>& vertices, std::vector<unsigned int>& indices);
+
+        //Average cache miss ratio, transformed vertices per triangle in a simulated FIFO cache. 0.5 is the ideal, 3 the worst
+        [[nodiscard]] static float computeACMR(std::span<const unsigned int> indices, size_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+    };
+} //namespace elix
+
+#endif //MESH_OPTIMIZER_HPP
@@ -0,0 +1,35 @@
+#ifndef MESH_SIMPLIFIER_HPP
+#define MESH_SIMPLIFIER_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace elix
+{
+    //Quadric error edge collapse for import time LOD generation. Nothing in here touches OpenGL
+    class MeshSimplifier
+    {
+    public:
+        //Simplified levels generated after the source one
+        static constexpr size_t MAX_LODS = 4;
+        //Triangle count of every level relative to the previous one
+        static constexpr float LOD_REDUCTION = 0.5f;
+        //Levels stop once the error would exceed this fraction of the mesh radius
+        static constexpr float MAX_RELATIVE_ERROR = 0.05f;
+
+        //Collapses edges in order of their quadric error until the index count reaches targetIndexCount or the next
+        //collapse would move the surface further than targetError. Indices are only ever moved to vertices that already
+        //exist, so the result indexes the same vertex buffer. UV and normal seams collapse along themselves, borders
+        //along the border, non-manifold vertices stay
+        static std::vector<unsigned int> simplify(std::span<const unsigned int> indices, std::span<const common::Vertex> vertices,
+                                                  size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+        //Fills mesh.lods with up to MAX_LODS levels, each cache optimized. Has to run after the vertices got their final order
+        static void generateLods(common::MeshData& mesh);
+    };
+} //namespace elix
+
+#endif //MESH_SIMPLIFIER_HPP
@@ -13,11 +13,22 @@ namespace elix
     public:
         Model(const std::string& name, const std::vector<elix::Mesh>& meshes, std::unique_ptr<Skeleton> skeleton = nullptr);
 
-        void draw() const;
+        //lod is clamped per mesh, meshes with fewer levels draw their coarsest one
+        void draw(size_t lod = 0) const;
+
+        //Uploads every mesh, see elix::Mesh::bake
+        void bake();
+
+        ~Model();
 
         void addAnimation(common::Animation* animation);
 
-        void drawWithMaterials(std::unordered_map<int, Material*>& materials) const;
+        void drawWithMaterials(std::unordered_map<int, Material*>& materials, size_t lod = 0) const;
+
+        //Most levels any mesh has
+        [[nodiscard]] size_t getLodCount() const;
+        //Largest error of any mesh at this level, in model units
+        [[nodiscard]] float getLodError(size_t lod) const;
 
         [[nodiscard]] common::Animation* getAnimation(int index) const;
         [[nodiscard]] common::Animation* getAnimation(const std::string& name) const;
@@ -26,9 +37,13 @@ namespace elix
         [[nodiscard]] std::string getName() const;
         [[nodiscard]] size_t getNumMeshes() const;
         [[nodiscard]] elix::Mesh* getMesh(int meshIndex);
+        [[nodiscard]] const std::vector<elix::Mesh>& getMeshes() const;
         [[nodiscard]] bool hasSkeleton() const;
+        //Bind pose bounds of every mesh in model space
+        [[nodiscard]] const common::BoundingBox& getBoundingBox() const;
     private:
         std::string m_name;
+        common::BoundingBox m_boundingBox;
         std::vector<elix::Mesh> m_meshes;
         std::unique_ptr<Skeleton> m_skeleton{nullptr};
         std::vector<common::Animation*> m_animations;
@@ -0,0 +1,115 @@
+#ifndef MODEL_COOKER_HPP
+#define MODEL_COOKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common.hpp"
+
+class Skeleton;
+
+namespace elix
+{
+    //Binary layout of a cooked model (.emodel). Little endian, every section is 16 byte aligned so the
+    //mapped bytes can be used in place
+    namespace cooked
+    {
+        constexpr uint32_t MODEL_MAGIC = 0x4C444D45; // "EMDL"
+        constexpr uint32_t MODEL_VERSION = 3;
+        constexpr uint32_t SECTION_ALIGNMENT = 16;
+
+        //Vertices are stored packed, elix::SkinnedVertex with bones and elix::StaticVertex otherwise
+        enum MeshFlags : uint32_t
+        {
+            MESH_FLAG_HAS_BONES = 1 << 0,
+            MESH_FLAG_16BIT_INDICES = 1 << 1,
+        };
+
+        struct ModelHeader
+        {
+            uint32_t magic{MODEL_MAGIC};
+            uint32_t version{MODEL_VERSION};
+            uint64_t fileSize{0};
+
+            uint32_t meshCount{0};
+            uint32_t boneCount{0};
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+
+            uint64_t meshTableOffset{0};
+            uint64_t boneTableOffset{0};
+            uint64_t stringTableOffset{0};
+            uint64_t stringTableSize{0};
+
+            float globalInverseTransform[16]{};
+        };
+
+        struct MeshRecord
+        {
+            uint64_t vertexOffset{0};
+            uint64_t indexOffset{0};
+            uint32_t vertexCount{0};
+            uint32_t indexCount{0};
+            uint32_t materialSlotOffset{0};
+            uint32_t materialSlotLength{0};
+            uint32_t flags{0};
+            uint32_t lodCount{0};
+            uint64_t lodTableOffset{0};
+        };
+
+        //Detail levels of a mesh, level 0 first. Offsets count indices from the start of the mesh's index data
+        struct LodRecord
+        {
+            uint32_t indexOffset{0};
+            uint32_t indexCount{0};
+            float error{0.0f};
+            uint32_t reserved{0};
+        };
+
+        struct BoneRecord
+        {
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+            int32_t parentId{-1};
+            uint32_t reserved{0};
+            float offsetMatrix[16]{};
+            float localBindTransform[16]{};
+            float globalBindTransform[16]{};
+        };
+    } //namespace cooked
+
+    class ModelCooker
+    {
+    public:
+        static constexpr const char* EXTENSION = ".emodel";
+
+        //Validated view over the bytes of a cooked model, usually a mapped file. Every table, span and string a record
+        //points at lies inside the bytes
+        struct ModelView
+        {
+            const cooked::ModelHeader* header{nullptr};
+            std::span<const cooked::MeshRecord> meshes;
+            std::span<const cooked::BoneRecord> bones;
+            std::string_view strings;
+            std::span<const std::byte> bytes;
+
+            [[nodiscard]] std::span<const std::byte> getVertices(const cooked::MeshRecord& mesh) const;
+            [[nodiscard]] std::span<const std::byte> getIndices(const cooked::MeshRecord& mesh) const;
+            [[nodiscard]] std::span<const cooked::LodRecord> getLods(const cooked::MeshRecord& mesh) const;
+            [[nodiscard]] std::string_view getString(uint32_t offset, uint32_t length) const;
+        };
+
+        //Imports the source model with Assimp and writes it as a cooked model. Does not need an OpenGL context
+        static bool cook(const std::string& sourcePath, const std::string& outputPath);
+
+        static bool write(const std::string& modelName, const std::vector<common::MeshData>& meshes, Skeleton* skeleton, const std::string& outputPath);
+
+        static bool parse(std::span<const std::byte> bytes, ModelView& view);
+    };
+} //namespace elix
+
+#endif //MODEL_COOKER_HPP
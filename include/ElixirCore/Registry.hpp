@@ -0,0 +1,372 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Component.hpp"
+
+namespace elix
+{
+    //Generational handle. A destroyed entity's index is reused with the next generation, so stale handles never match
+    struct Entity
+    {
+        static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+        uint32_t index{INVALID_INDEX};
+        uint32_t generation{0};
+
+        [[nodiscard]] bool isValid() const { return index != INVALID_INDEX; }
+        bool operator==(const Entity& other) const = default;
+    };
+
+    using ComponentTypeId = uint32_t;
+
+    constexpr size_t MAX_COMPONENT_TYPES = 64;
+    using Signature = std::bitset<MAX_COMPONENT_TYPES>;
+
+    //Dense ids, one per component type, handed out on first use and fixed from then on. They index signatures and
+    //column tables, no type_index is ever hashed
+    class ComponentTypes
+    {
+    public:
+        template<typename T>
+        static ComponentTypeId id()
+        {
+            static const ComponentTypeId id = next();
+            return id;
+        }
+    private:
+        static ComponentTypeId next();
+    };
+
+    //Component classes are polymorphic and handed out by pointer, so they stay put behind a unique_ptr and their
+    //column holds the pointers. Anything else (Transform and other plain data) is stored by value
+    template<typename T>
+    using Stored = std::conditional_t<std::is_base_of_v<Component, T>, std::unique_ptr<T>, T>;
+
+    //Components of every entity with the same set of types. One column per type, entities are rows, rows stay dense
+    class Archetype
+    {
+    public:
+        class Column
+        {
+        public:
+            virtual ~Column() = default;
+
+            [[nodiscard]] virtual std::unique_ptr<Column> createEmpty() const = 0;
+            //Appends row of other, a column of the same type
+            virtual void moveFrom(Column& other, size_t row) = 0;
+            virtual void swapRemove(size_t row) = 0;
+            //nullptr for plain data
+            [[nodiscard]] virtual Component* getComponent(size_t row) = 0;
+        };
+
+        template<typename T>
+        class ColumnOf final : public Column
+        {
+        public:
+            [[nodiscard]] std::unique_ptr<Column> createEmpty() const override { return std::make_unique<ColumnOf>(); }
+
+            void moveFrom(Column& other, size_t row) override { values.push_back(std::move(static_cast<ColumnOf&>(other).values[row])); }
+
+            void swapRemove(size_t row) override
+            {
+                if (row + 1 != values.size())
+                    values[row] = std::move(values.back());
+
+                values.pop_back();
+            }
+
+            [[nodiscard]] Component* getComponent(size_t row) override
+            {
+                if constexpr (std::is_base_of_v<Component, T>)
+                    return values[row].get();
+                else
+                    return nullptr;
+            }
+
+            T& get(size_t row)
+            {
+                if constexpr (std::is_base_of_v<Component, T>)
+                    return *values[row];
+                else
+                    return values[row];
+            }
+
+            std::vector<Stored<T>> values;
+        };
+
+        Archetype();
+
+        [[nodiscard]] bool has(ComponentTypeId type) const { return m_signature.test(type); }
+
+        template<typename T>
+        ColumnOf<T>& getColumn() { return static_cast<ColumnOf<T>&>(*m_columns[m_columnIndices[ComponentTypes::id<T>()]]); }
+
+        [[nodiscard]] const Signature& getSignature() const { return m_signature; }
+        [[nodiscard]] const std::vector<Entity>& getEntities() const { return m_entities; }
+        [[nodiscard]] size_t size() const { return m_entities.size(); }
+    private:
+        friend class Registry;
+
+        Signature m_signature;
+        //Sorted by type id, so the components of an entity are always visited in the same order
+        std::vector<ComponentTypeId> m_types;
+        std::vector<std::unique_ptr<Column>> m_columns;
+        std::array<int8_t, MAX_COMPONENT_TYPES> m_columnIndices;
+        std::vector<Entity> m_entities;
+    };
+
+    //Archetype storage for every GameObject's components. Adding or removing a component moves the entity's row to the
+    //archetype of its new type set; queries walk the matching archetypes column by column. Not thread safe for
+    //structural changes, reads from many threads are fine
+    class Registry
+    {
+    public:
+        static Registry& instance();
+
+        Registry();
+
+        Entity create();
+        //Destroys the entity's components, the handle turns stale
+        void destroy(Entity entity);
+        [[nodiscard]] bool isAlive(Entity entity) const;
+
+        //Replaces a component of the same type if there is one. Throws on a stale entity, there is nothing to return
+        template<typename T, typename... Args>
+        T& add(Entity entity, Args&&... args)
+        {
+            if (!isAlive(entity))
+                throw std::invalid_argument("Registry::add(): entity is not alive");
+
+            const ComponentTypeId type = ComponentTypes::id<T>();
+            Record& record = m_records[entity.index];
+
+            if (m_archetypes[record.archetype]->has(type))
+            {
+                auto& stored = m_archetypes[record.archetype]->getColumn<T>().values[record.row];
+                stored = makeStored<T>(std::forward<Args>(args)...);
+                return m_archetypes[record.archetype]->getColumn<T>().get(record.row);
+            }
+
+            Signature signature = m_archetypes[record.archetype]->getSignature();
+            signature.set(type);
+
+            const uint32_t target = findArchetype(signature, record.archetype, type, []() -> std::unique_ptr<Archetype::Column> { return std::make_unique<Archetype::ColumnOf<T>>(); });
+            move(entity, target);
+
+            auto& column = m_archetypes[target]->getColumn<T>();
+            column.values.push_back(makeStored<T>(std::forward<Args>(args)...));
+            return column.get(column.values.size() - 1);
+        }
+
+        template<typename T>
+        void remove(Entity entity)
+        {
+            const ComponentTypeId type = ComponentTypes::id<T>();
+
+            if (!isAlive(entity) || !m_archetypes[m_records[entity.index].archetype]->has(type))
+                return;
+
+            const Record& record = m_records[entity.index];
+
+            Signature signature = m_archetypes[record.archetype]->getSignature();
+            signature.reset(type);
+
+            move(entity, findArchetype(signature, record.archetype, type, nullptr));
+        }
+
+        //nullptr for stale entities too
+        template<typename T>
+        [[nodiscard]] T* get(Entity entity)
+        {
+            if (!isAlive(entity))
+                return nullptr;
+
+            const Record& record = m_records[entity.index];
+            Archetype& archetype = *m_archetypes[record.archetype];
+
+            return archetype.has(ComponentTypes::id<T>()) ? &archetype.getColumn<T>().get(record.row) : nullptr;
+        }
+
+        template<typename T>
+        [[nodiscard]] bool has(Entity entity) const
+        {
+            return isAlive(entity) && m_archetypes[m_records[entity.index].archetype]->has(ComponentTypes::id<T>());
+        }
+
+        //Every Component of an entity, in type id order. function takes (Component&) or (ComponentTypeId, Component&)
+        template<typename F>
+        void forEachComponent(Entity entity, F&& function)
+        {
+            if (!isAlive(entity))
+                return;
+
+            const Record& record = m_records[entity.index];
+            Archetype& archetype = *m_archetypes[record.archetype];
+
+            for (size_t index = 0; index < archetype.m_columns.size(); ++index)
+            {
+                Component* component = archetype.m_columns[index]->getComponent(record.row);
+
+                if (!component)
+                    continue;
+
+                if constexpr (std::is_invocable_v<F, ComponentTypeId, Component&>)
+                    function(archetype.m_types[index], *component);
+                else
+                    function(*component);
+            }
+        }
+
+        //Calls function(Entity, Ts&...) for every entity that has all of Ts, archetype by archetype. No structural
+        //changes while it runs
+        template<typename... Ts, typename F>
+        void each(F&& function)
+        {
+            const Signature signature = makeSignature<Ts...>();
+
+            for (const auto& archetype : m_archetypes)
+            {
+                if ((archetype->getSignature() & signature) != signature || archetype->size() == 0)
+                    continue;
+
+                eachIn<Ts...>(*archetype, function, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        //Range over the entities with all of Ts, for structured bindings: for (auto [entity, transform] : query<Transform>())
+        template<typename... Ts>
+        class Query
+        {
+        public:
+            class Iterator
+            {
+            public:
+                Iterator(std::vector<Archetype*>::const_iterator archetype, std::vector<Archetype*>::const_iterator end) : m_archetype(archetype), m_end(end)
+                {
+                    bindColumns();
+                }
+
+                std::tuple<Entity, Ts&...> operator*() const
+                {
+                    return getRow(std::index_sequence_for<Ts...>{});
+                }
+
+                Iterator& operator++()
+                {
+                    if (++m_row >= (*m_archetype)->size())
+                    {
+                        ++m_archetype;
+                        m_row = 0;
+                        bindColumns();
+                    }
+
+                    return *this;
+                }
+
+                bool operator==(const Iterator& other) const { return m_archetype == other.m_archetype && m_row == other.m_row; }
+            private:
+                void bindColumns()
+                {
+                    if (m_archetype != m_end)
+                        m_columns = {&(*m_archetype)->template getColumn<Ts>()...};
+                }
+
+                template<size_t... I>
+                std::tuple<Entity, Ts&...> getRow(std::index_sequence<I...>) const
+                {
+                    return {(*m_archetype)->getEntities()[m_row], std::get<I>(m_columns)->get(m_row)...};
+                }
+
+                std::vector<Archetype*>::const_iterator m_archetype;
+                std::vector<Archetype*>::const_iterator m_end;
+                size_t m_row{0};
+                std::tuple<Archetype::ColumnOf<Ts>*...> m_columns{};
+            };
+
+            explicit Query(std::vector<Archetype*> archetypes) : m_archetypes(std::move(archetypes)) {}
+
+            [[nodiscard]] Iterator begin() const { return {m_archetypes.begin(), m_archetypes.end()}; }
+            [[nodiscard]] Iterator end() const { return {m_archetypes.end(), m_archetypes.end()}; }
+        private:
+            std::vector<Archetype*> m_archetypes;
+        };
+
+        template<typename... Ts>
+        [[nodiscard]] Query<Ts...> query()
+        {
+            const Signature signature = makeSignature<Ts...>();
+            std::vector<Archetype*> archetypes;
+
+            for (const auto& archetype : m_archetypes)
+                if ((archetype->getSignature() & signature) == signature && archetype->size() > 0)
+                    archetypes.push_back(archetype.get());
+
+            return Query<Ts...>(std::move(archetypes));
+        }
+
+        [[nodiscard]] size_t getEntityCount() const;
+        [[nodiscard]] size_t getArchetypeCount() const;
+    private:
+        struct Record
+        {
+            uint32_t archetype{0};
+            uint32_t row{0};
+            uint32_t generation{0};
+            bool isAlive{false};
+        };
+
+        template<typename T, typename... Args>
+        static Stored<T> makeStored(Args&&... args)
+        {
+            if constexpr (std::is_base_of_v<Component, T>)
+                return std::make_unique<T>(std::forward<Args>(args)...);
+            else
+                return T{std::forward<Args>(args)...};
+        }
+
+        template<typename... Ts>
+        static Signature makeSignature()
+        {
+            Signature signature;
+            (signature.set(ComponentTypes::id<Ts>()), ...);
+            return signature;
+        }
+
+        template<typename... Ts, typename F, size_t... I>
+        static void eachIn(Archetype& archetype, F& function, std::index_sequence<I...>)
+        {
+            const std::tuple<Archetype::ColumnOf<Ts>*...> columns{&archetype.getColumn<Ts>()...};
+            const auto& entities = archetype.getEntities();
+
+            for (size_t row = 0; row < entities.size(); ++row)
+                function(entities[row], std::get<I>(columns)->get(row)...);
+        }
+
+        using ColumnFactory = std::unique_ptr<Archetype::Column>(*)();
+
+        //Archetype with signature, built from source's columns plus one made by createColumn when it does not exist yet
+        uint32_t findArchetype(const Signature& signature, uint32_t source, ComponentTypeId changedType, ColumnFactory createColumn);
+
+        //Moves the entity's row to target, dropping the columns target does not have
+        void move(Entity entity, uint32_t target);
+
+        std::vector<Record> m_records;
+        std::vector<uint32_t> m_freeIndices;
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        std::unordered_map<Signature, uint32_t> m_archetypeIndices;
+        size_t m_entityCount{0};
+    };
+} //namespace elix
+
+#endif //REGISTRY_HPP
@@ -11,6 +11,9 @@ public:
     explicit RigidbodyComponent(const std::shared_ptr<GameObject>& object);
 
     void update(float deltaTime) override;
+    //Copies the simulated pose into the owner, whose position callback feeds it back to the actor
+    [[nodiscard]] elix::UpdatePhase getUpdatePhase() const override { return elix::UpdatePhase::Physics; }
+    [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::PHYSICS, elix::Resource::PHYSICS | elix::Resource::TRANSFORMS}; }
 
     [[nodiscard]] physx::PxRigidActor* getRigidActor() const;
 
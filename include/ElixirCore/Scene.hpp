@@ -1,10 +1,17 @@
 #ifndef SCENE_HPP
 #define SCENE_HPP
 
+#include <span>
+#include <string>
+#include <unordered_map>
+
 #include "Drawable.hpp"
 #include "GameObject.hpp"
+#include "Scheduler.hpp"
 #include "Skybox.hpp"
 
+//Objects are kept dense and addressed by their generational elix::Entity through a sparse index, so adding, finding
+//and removing one is O(1) whatever the object count. Removal is deferred to the end of the frame
 class Scene
 {
 public:
@@ -12,28 +19,82 @@ public:
 
     virtual ~Scene();
 
+    //Runs the scheduler over the objects, then destroys the ones deleted during the frame
     void update(float deltaTime);
 
     void setSkybox(const std::shared_ptr<elix::Skybox>& skybox);
 
     std::shared_ptr<elix::Skybox> getSkybox() const;
 
+    //Adding an object that is already in a scene does nothing
     void addGameObject(const std::shared_ptr<GameObject>& gameObject);
 
     void addDrawable(const std::shared_ptr<Drawable>& drawable);
 
     void setGameObjects(const std::vector<std::shared_ptr<GameObject>>& gameObjects);
 
+    //Queues the object for destruction, it stays valid until the end of the current frame. Returns false if it is not
+    //in this scene or already queued
     bool deleteGameObject(GameObject* gameObject);
+    bool deleteGameObject(elix::Entity entity);
+
+    //Destroys the queued objects now, update does it at the end of every frame
+    void destroyDeletedObjects();
+
+    //nullptr if the object left the scene or the handle is stale
+    [[nodiscard]] GameObject* getGameObject(elix::Entity entity) const;
+    //Any object with that name, nullptr if there is none
+    [[nodiscard]] GameObject* findGameObject(const std::string& name) const;
+
+    [[nodiscard]] std::span<const elix::Entity> getEntitiesByName(const std::string& name) const;
+    [[nodiscard]] std::span<const elix::Entity> getEntitiesByTag(const std::string& tag) const;
+    //Objects sharing at least one bit with layerMask
+    [[nodiscard]] std::vector<elix::Entity> getEntitiesInLayer(common::LayerMask layerMask) const;
 
+    //Swap and pop removal, the order changes whenever an object is destroyed
     const std::vector<std::shared_ptr<GameObject>>& getGameObjects();
 
     const std::vector<std::shared_ptr<Drawable>>& getDrawables();
 
+    //Add game systems here, the engine's are registered by the constructor
+    elix::Scheduler& getScheduler();
+
 private:
+    friend class GameObject;
+
+    static constexpr uint32_t INVALID_POSITION = 0xFFFFFFFF;
+
+    //Sparse side of the object array, one per entity index
+    struct Record
+    {
+        uint32_t dense{INVALID_POSITION};
+        //Positions in the name, tag and layer buckets
+        uint32_t namePosition{0};
+        uint32_t tagPosition{0};
+        uint32_t layerPosition{0};
+        bool isDeleted{false};
+    };
+
+    template<typename Key>
+    using Index = std::unordered_map<Key, std::vector<elix::Entity>>;
+
+    //Files an object under its name, tag and layer mask. GameObject calls these around changes of any of them
+    void addToIndices(const GameObject& gameObject);
+    void removeFromIndices(const GameObject& gameObject);
+
+    void removeGameObject(elix::Entity entity);
+
     std::vector<std::shared_ptr<GameObject>> m_objects;
+    std::vector<Record> m_records;
+    std::vector<elix::Entity> m_deletedEntities;
+
+    Index<std::string> m_objectsByName;
+    Index<std::string> m_objectsByTag;
+    Index<uint32_t> m_objectsByLayer;
+
     std::vector<std::shared_ptr<Drawable>> m_drawables;
     std::shared_ptr<elix::Skybox> m_skybox;
+    elix::Scheduler m_scheduler;
 };
 
-#endif //SCENE_HPP
\ No newline at end of file
+#endif //SCENE_HPP
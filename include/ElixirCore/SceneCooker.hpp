@@ -0,0 +1,171 @@
+#ifndef SCENE_COOKER_HPP
+#define SCENE_COOKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace elix
+{
+    class MappedFile;
+
+    //Binary layout of a cooked scene (.escene). Little endian, every table is SECTION_ALIGNMENT aligned like the
+    //cooked models so the records are read in place from the mapping. Objects point into the other tables by index,
+    //strings by offset and length
+    namespace cooked
+    {
+        constexpr uint32_t SCENE_MAGIC = 0x4E435345; // "ESCN"
+        constexpr uint32_t SCENE_VERSION = 1;
+        constexpr uint32_t NO_INDEX = 0xFFFFFFFF;
+
+        enum AssetType : uint32_t
+        {
+            ASSET_MODEL = 0,
+            ASSET_MATERIAL = 1,
+            ASSET_SKYBOX = 2,
+        };
+
+        enum ObjectFlags : uint32_t
+        {
+            OBJECT_FLAG_HAS_ANIMATOR = 1 << 0,
+            OBJECT_FLAG_HAS_SCRIPTS = 1 << 1,
+        };
+
+        struct SceneHeader
+        {
+            uint32_t magic{SCENE_MAGIC};
+            uint32_t version{SCENE_VERSION};
+            uint64_t fileSize{0};
+
+            uint32_t objectCount{0};
+            uint32_t assetCount{0};
+            uint32_t materialCount{0};
+            uint32_t lightCount{0};
+            uint32_t scriptCount{0};
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+            uint32_t skyboxAsset{NO_INDEX};
+
+            uint64_t objectTableOffset{0};
+            uint64_t assetTableOffset{0};
+            uint64_t materialTableOffset{0};
+            uint64_t lightTableOffset{0};
+            uint64_t scriptTableOffset{0};
+            uint64_t stringTableOffset{0};
+            uint64_t stringTableSize{0};
+        };
+
+        //Every asset appears once, however many objects use it, so the loader resolves each name a single time
+        struct AssetRecord
+        {
+            uint32_t type{ASSET_MODEL};
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+            uint32_t reserved{0};
+        };
+
+        struct ObjectRecord
+        {
+            float position[3]{};
+            //Euler angles in degrees, as GameObject::setRotation takes them
+            float rotation[3]{};
+            float scale[3]{1.0f, 1.0f, 1.0f};
+            //common::LayerMask::DEFAULT
+            uint32_t layerMask{1};
+
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+            uint32_t tagOffset{0};
+            uint32_t tagLength{0};
+
+            //Index of the parent object
+            uint32_t parent{NO_INDEX};
+            uint32_t modelAsset{NO_INDEX};
+            uint32_t firstMaterial{0};
+            uint32_t materialCount{0};
+            uint32_t firstScript{0};
+            uint32_t scriptCount{0};
+            uint32_t light{NO_INDEX};
+            uint32_t flags{0};
+        };
+
+        //Override material of one mesh of the object's model
+        struct MaterialRecord
+        {
+            uint32_t meshIndex{0};
+            uint32_t asset{NO_INDEX};
+        };
+
+        struct LightRecord
+        {
+            uint32_t lightType{0};
+            float direction[3]{};
+            float color[3]{};
+            float position[3]{};
+            float strength{0.0f};
+            float radius{0.0f};
+        };
+
+        struct ScriptRecord
+        {
+            uint32_t nameOffset{0};
+            uint32_t nameLength{0};
+        };
+    } //namespace cooked
+
+    //Scenes are authored as JSON and cooked for shipping, SceneManager::loadSceneFromFile takes either
+    class SceneCooker
+    {
+    public:
+        static constexpr const char* EXTENSION = ".escene";
+
+        //Validated view over the bytes of a cooked scene. Every table lies inside the bytes, and every index, range and
+        //string a record holds points inside its table
+        struct SceneView
+        {
+            const cooked::SceneHeader* header{nullptr};
+            std::span<const cooked::ObjectRecord> objects;
+            std::span<const cooked::AssetRecord> assets;
+            std::span<const cooked::MaterialRecord> materials;
+            std::span<const cooked::LightRecord> lights;
+            std::span<const cooked::ScriptRecord> scripts;
+            std::string_view strings;
+
+            [[nodiscard]] std::string_view getString(uint32_t offset, uint32_t length) const
+            {
+                return strings.substr(offset, length);
+            }
+
+            [[nodiscard]] std::string_view getAssetName(uint32_t asset) const
+            {
+                return getString(assets[asset].nameOffset, assets[asset].nameLength);
+            }
+
+            [[nodiscard]] std::span<const cooked::MaterialRecord> getMaterials(const cooked::ObjectRecord& object) const
+            {
+                return materials.subspan(object.firstMaterial, object.materialCount);
+            }
+
+            [[nodiscard]] std::span<const cooked::ScriptRecord> getScripts(const cooked::ObjectRecord& object) const
+            {
+                return scripts.subspan(object.firstScript, object.scriptCount);
+            }
+        };
+
+        static bool cook(const std::string& jsonPath, const std::string& outputPath);
+
+        //Writes a cooked scene back as JSON, in the layout SceneManager::saveSceneToFile uses
+        static bool uncook(const std::string& cookedPath, const std::string& jsonPath);
+
+        static bool parse(std::span<const std::byte> bytes, SceneView& view);
+
+        //Maps and parses a cooked scene, nullptr if it is missing, corrupt or of another version. The view points into
+        //the returned mapping
+        static std::shared_ptr<MappedFile> open(const std::string& filePath, SceneView& view);
+    };
+} //namespace elix
+
+#endif //SCENE_COOKER_HPP
@@ -14,11 +14,14 @@ public:
 
     void updateCurrentScene(float deltaTime);
 
+    //Saves as JSON, the authoring format. elix::SceneCooker turns it into a cooked scene
     static void saveSceneToFile(Scene* scene, const std::string& filePath);
+    //Cooked scenes (elix::SceneCooker::EXTENSION) are read in place from a mapping, anything else is parsed as JSON
     static std::shared_ptr<Scene> loadSceneFromFile(const std::string& filePath, elix::AssetsCache& cache);
 
     ~SceneManager() = default;
 private:
+    static std::shared_ptr<Scene> loadCookedScene(const std::string& filePath, elix::AssetsCache& cache);
 
     std::shared_ptr<Scene> m_currentScene{nullptr};
 
@@ -0,0 +1,91 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Registry.hpp"
+#include "UpdatePhase.hpp"
+
+class GameObject;
+
+namespace elix
+{
+    //Runs the work of a frame phase by phase. The component updates of a phase form one job per component type and
+    //systems are jobs of their own. A job waits for the earlier jobs of its phase its Access conflicts with and runs
+    //on the ThreadPool otherwise, so conflicting work always runs in declaration order: component types by type id,
+    //then systems in the order they were added
+    class Scheduler
+    {
+    public:
+        using SystemFunction = std::function<void(float deltaTime)>;
+
+        struct JobTiming
+        {
+            std::string name;
+            UpdatePhase phase{UpdatePhase::Gameplay};
+            //Zero for systems
+            size_t componentCount{0};
+            double milliseconds{0.0};
+        };
+
+        //Replaces a system of the same name
+        void addSystem(const std::string& name, UpdatePhase phase, const Access& access, const SystemFunction& function);
+        bool removeSystem(const std::string& name);
+
+        //Ticks every component of objects and runs the systems, phase by phase. Components are gathered when their
+        //phase starts, the ones added during a phase wait for the next frame and none may be removed during its own
+        //phase. If a job throws, the rest of its phase still runs and the first exception is rethrown afterwards
+        void run(const std::vector<std::shared_ptr<GameObject>>& objects, float deltaTime);
+
+        //Disabled runs every job one after the other on the calling thread, in the same order
+        void setParallelEnabled(bool isEnabled);
+        [[nodiscard]] bool isParallelEnabled() const;
+
+        //Wall time of every phase in the last run
+        [[nodiscard]] const std::array<double, UPDATE_PHASE_COUNT>& getPhaseMilliseconds() const;
+        //Every job of the last run, in declaration order
+        [[nodiscard]] const std::vector<JobTiming>& getJobTimings() const;
+        void logTimings() const;
+
+        [[nodiscard]] static const char* getPhaseName(UpdatePhase phase);
+    private:
+        struct System
+        {
+            std::string name;
+            UpdatePhase phase;
+            Access access;
+            SystemFunction function;
+        };
+
+        struct Job
+        {
+            Access access;
+            //Component jobs, the thread safe instances are split over the pool, the others follow one by one
+            std::vector<Component*> parallelComponents;
+            std::vector<Component*> serialComponents;
+            const System* system{nullptr};
+            //Later jobs of the phase waiting for this one
+            std::vector<size_t> dependents;
+            bool isOnCallingThread{false};
+        };
+
+        void gather(const std::vector<std::shared_ptr<GameObject>>& objects, UpdatePhase phase);
+        void runJobs(float deltaTime);
+        void execute(size_t jobIndex, float deltaTime);
+
+        std::vector<System> m_systems;
+        //Jobs of the phase being run and their timings
+        std::vector<Job> m_jobs;
+        size_t m_firstTiming{0};
+
+        std::vector<JobTiming> m_jobTimings;
+        std::array<double, UPDATE_PHASE_COUNT> m_phaseMilliseconds{};
+        bool m_isParallelEnabled{true};
+    };
+} //namespace elix
+
+#endif //SCHEDULER_HPP
@@ -13,6 +13,9 @@ public:
     virtual void onStart() = 0;
     virtual void onUpdate(float deltaTime) = 0;
     virtual std::string getScriptName() const = 0;
+    //True if onUpdate only touches the script and its owner. Such scripts update in parallel with other objects, the
+    //owner's rigidbody follows it under a lock
+    [[nodiscard]] virtual bool isThreadSafe() const { return false; }
 
     void setOwner(GameObject* owner) { owner_ = owner; }
 
@@ -11,9 +11,14 @@
 class ScriptComponent final : public Component
 {
 public:
+    ScriptComponent();
+
     void addScript(const std::string& name);
 
     void update(float deltaTime) override;
+    //Scripts run alone on the calling thread unless every one of them is thread safe
+    [[nodiscard]] elix::Access getAccess() const override;
+    [[nodiscard]] bool isThreadSafe() const override;
 
     void setUpdateScripts(bool flag);
 
@@ -1,6 +1,7 @@
 #ifndef SHADER_HPP
 #define SHADER_HPP
 
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +19,10 @@ namespace elix
         void load(const std::string& vertexPath, const std::string& fragmentPath, const std::string& geometryPath = {});
 
         void loadBinaries(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr);
+
+        //Vertex only program whose varyings are captured interleaved, in the given order, by transform feedback
+        void loadTransformFeedback(const char* vertexSource, const std::vector<const char*>& varyings);
+
         void bind() const;
         void unbind() const;
 
@@ -25,7 +30,7 @@ namespace elix
         [[nodiscard]] bool isValid() const;
 
 
-        void setMat4Array(const std::string& name, const std::vector<glm::mat4>& value) const;
+        void setMat4Array(const std::string& name, std::span<const glm::mat4> value) const;
         void setMat4(const std::string& name, const glm::mat4& value) const;
         void setVec3(const std::string& name, const glm::vec3& value) const;
         void setVec4(const std::string& name, const glm::vec4& value) const;
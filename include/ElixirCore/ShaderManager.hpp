@@ -20,6 +20,16 @@ public:
         SKELETON_STENCIL = 8,
         SKYBOX = 9,
         EQUIRECTANGULAR_TO_CUBEMAP = 10,
+        //Transform feedback only, see elix::SkinningCache
+        SKINNING = 11,
+        //Shader storage palettes, see elix::SkinnedRenderer. Only loaded on OpenGL 4.3 and up
+        SKELETON_INSTANCED = 12,
+        SKELETON_SHADOW_INSTANCED = 13,
+        SKELETON_STENCIL_INSTANCED = 14,
+        //Baked clips, see elix::VertexAnimationRenderer. OpenGL 4.3 and up as well
+        VERTEX_ANIMATION = 15,
+        VERTEX_ANIMATION_SHADOW = 16,
+        VERTEX_ANIMATION_STENCIL = 17,
     };
 
     static ShaderManager& instance();
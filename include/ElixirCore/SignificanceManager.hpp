@@ -0,0 +1,38 @@
+#ifndef SIGNIFICANCE_MANAGER_HPP
+#define SIGNIFICANCE_MANAGER_HPP
+
+#include <memory>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace elix
+{
+    class CameraComponent;
+
+    //Scores every object by camera distance, visibility and its priority. Components throttle their updates on the
+    //score through their TickBudget, so distant and off screen objects cost less as their count grows
+    class SignificanceManager
+    {
+    public:
+        struct Settings
+        {
+            //Objects closer than this are fully significant
+            float fullDistance{15.0f};
+            //Significance falls linearly to zero at this distance
+            float zeroDistance{150.0f};
+            //Multiplies the significance of objects outside the view frustum
+            float offscreenScale{0.25f};
+        };
+
+        //Call once per frame before Scene::update
+        static void update(const std::vector<std::shared_ptr<GameObject>>& objects, const CameraComponent& camera);
+
+        [[nodiscard]] static float computeScore(float distance, bool isVisible, float priority);
+
+        static void setSettings(const Settings& settings);
+        [[nodiscard]] static const Settings& getSettings();
+    };
+} //namespace elix
+
+#endif //SIGNIFICANCE_MANAGER_HPP
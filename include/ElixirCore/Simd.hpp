@@ -0,0 +1,92 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define ELIX_SIMD_AVX 1
+    #define ELIX_SIMD_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ELIX_SIMD_SSE 1
+#endif
+
+//Thin lane wrapper so SoA kernels are written once. WIDTH floats per register: 8 with AVX, 4 with SSE, 1 otherwise
+namespace elix::simd
+{
+#if defined(ELIX_SIMD_AVX)
+    using Float = __m256;
+    constexpr size_t WIDTH = 8;
+
+    inline Float load(const float* source) { return _mm256_loadu_ps(source); }
+    inline void store(float* destination, Float value) { _mm256_storeu_ps(destination, value); }
+    inline Float set(float value) { return _mm256_set1_ps(value); }
+    inline Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    inline Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    inline Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    inline Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    inline Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+    //+1 or -1 with the sign of value
+    inline Float sign(Float value) { return _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.0f)), _mm256_set1_ps(1.0f)); }
+#elif defined(ELIX_SIMD_SSE)
+    using Float = __m128;
+    constexpr size_t WIDTH = 4;
+
+    inline Float load(const float* source) { return _mm_loadu_ps(source); }
+    inline void store(float* destination, Float value) { _mm_storeu_ps(destination, value); }
+    inline Float set(float value) { return _mm_set1_ps(value); }
+    inline Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    inline Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    inline Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    inline Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+    inline Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+    inline Float sign(Float value) { return _mm_or_ps(_mm_and_ps(value, _mm_set1_ps(-0.0f)), _mm_set1_ps(1.0f)); }
+#else
+    using Float = float;
+    constexpr size_t WIDTH = 1;
+
+    inline Float load(const float* source) { return *source; }
+    inline void store(float* destination, Float value) { *destination = value; }
+    inline Float set(float value) { return value; }
+    inline Float add(Float a, Float b) { return a + b; }
+    inline Float sub(Float a, Float b) { return a - b; }
+    inline Float mul(Float a, Float b) { return a * b; }
+    inline Float div(Float a, Float b) { return a / b; }
+    inline Float sqrt(Float a) { return std::sqrt(a); }
+    inline Float sign(Float value) { return std::copysign(1.0f, value); }
+#endif
+
+    inline Float lerp(Float start, Float end, Float t) { return add(start, mul(sub(end, start), t)); }
+
+    //out = a * b for column major matrices, out may alias either input
+    inline void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+    {
+#if defined(ELIX_SIMD_SSE)
+        const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+        const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+        const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+        const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+        __m128 columns[4];
+
+        for (int column = 0; column < 4; ++column)
+        {
+            const float* b0 = &b[column][0];
+
+            columns[column] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(b0[0])), _mm_mul_ps(a1, _mm_set1_ps(b0[1]))),
+                                         _mm_add_ps(_mm_mul_ps(a2, _mm_set1_ps(b0[2])), _mm_mul_ps(a3, _mm_set1_ps(b0[3]))));
+        }
+
+        for (int column = 0; column < 4; ++column)
+            _mm_storeu_ps(&out[column][0], columns[column]);
+#else
+        out = a * b;
+#endif
+    }
+} //namespace elix::simd
+
+#endif //SIMD_HPP
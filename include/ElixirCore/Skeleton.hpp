@@ -2,6 +2,7 @@
 #define SKELETON_HPP
 
 #include "Common.hpp"
+#include <span>
 #include <unordered_map>
 #include <assimp/mesh.h>
 
@@ -23,20 +24,38 @@ public:
     common::BoneInfo* getBone(int boneID);
     common::BoneInfo* getParent();
 
+    //Flattens the bones into arrays sorted parents first and computes the bind pose. Has to run once the hierarchy is
+    //complete, everything below works in that order
     void calculateBindPoseTransforms();
 
+    //Clip track index for every bone in evaluation order, -1 for bones the clip does not animate
+    std::vector<int> bindTracks(const elix::AnimationClip& clip) const;
+
+    //One pass over the bones in evaluation order. localTransforms are relative to the parent, modelTransforms receives
+    //the bones in model space and palette the skinning matrices, indexed by bone id like the vertices are. The skeleton
+    //itself holds no pose, every instance brings its own buffers
+    void evaluatePose(std::span<const glm::mat4> localTransforms, std::span<glm::mat4> modelTransforms, std::span<glm::mat4> palette) const;
+
+    //Evaluation order
+    const std::vector<int>& getParentIndices() const;
+    const std::vector<glm::mat4>& getLocalBindTransforms() const;
+
+    //Skinning palette of the bind pose by bone id
     const std::vector<glm::mat4>& getBindPoses() const;
 
-    const std::vector<glm::mat4>& getFinalMatrices();
+    size_t getMemorySize() const;
 
     glm::mat4 globalInverseTransform;
 private:
-    bool m_isBaked{false};
     std::vector<glm::mat4> m_bindPoseTransform;
     std::unordered_map<std::string, unsigned int> m_boneMap;
     std::vector<common::BoneInfo> m_bonesInfo;
 
-    std::vector<glm::mat4> m_finalBoneMatrices;
+    //Evaluation order, parents before children. m_boneIds maps back to the bone id the palette and vertices use
+    std::vector<int> m_parentIndices;
+    std::vector<int> m_boneIds;
+    std::vector<glm::mat4> m_offsetMatrices;
+    std::vector<glm::mat4> m_localBindTransforms;
 };
 
 #endif //SKELETON_HPP
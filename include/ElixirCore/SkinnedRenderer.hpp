@@ -0,0 +1,52 @@
+#ifndef SKINNED_RENDERER_HPP
+#define SKINNED_RENDERER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Model.hpp"
+#include "Shader.hpp"
+
+namespace elix
+{
+    //Draws skinned characters instanced. Every frame the palettes of all animators are packed into one shader storage
+    //buffer and every instance gets its model matrix and palette offset in a second one, so instances sharing a model
+    //go out in one call per mesh with no limit on the bone count. Objects with override materials are left to their
+    //MeshComponent. Needs OpenGL 4.3, off by default
+    class SkinnedRenderer
+    {
+    public:
+        //Instances of one model at one detail level, a range of the instance buffer
+        struct Batch
+        {
+            elix::Model* model{nullptr};
+            size_t lod{0};
+            uint32_t firstInstance{0};
+            uint32_t instanceCount{0};
+        };
+
+        //Packs the palettes and instances of every skinned MeshComponent not culled and not pre-skinned, and marks
+        //them instanced so MeshComponent::render skips them. Scene::update calls it, needs the OpenGL thread
+        static void update(const std::vector<std::shared_ptr<GameObject>>& objects);
+
+        //Draws every batch with shader, which has to be bound with its camera or light uniforms set: SKELETON_INSTANCED,
+        //SKELETON_SHADOW_INSTANCED or SKELETON_STENCIL_INSTANCED. Materials are bound unless a depth only pass is active
+        static void draw(elix::Shader& shader);
+
+        [[nodiscard]] static const std::vector<Batch>& getBatches();
+        [[nodiscard]] static size_t getInstanceCount();
+        [[nodiscard]] static size_t getPaletteMatrixCount();
+
+        //Whether the context has shader storage buffers
+        [[nodiscard]] static bool isSupported();
+
+        static void setEnabled(bool isEnabled);
+        [[nodiscard]] static bool isEnabled();
+
+        //Frees the buffers, call before the context goes away
+        static void release();
+    };
+} //namespace elix
+
+#endif //SKINNED_RENDERER_HPP
@@ -0,0 +1,91 @@
+#ifndef SKINNING_CACHE_HPP
+#define SKINNING_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Model.hpp"
+
+namespace elix
+{
+    //Skinned vertices of one instance, skinned once per pose and drawn as a static mesh by every pass (main, stencil,
+    //shadows). Owned by the MeshComponent of an animated object
+    class SkinningCache
+    {
+    public:
+        enum class Mode
+        {
+            //No pre-skinning, the SKELETON shaders skin in every pass
+            Shader,
+            //Transform feedback pass with the SKINNING shader
+            Gpu,
+            //skinVertices on the ThreadPool, uploaded every time the pose changes
+            Cpu
+        };
+
+        SkinningCache() = default;
+        ~SkinningCache();
+
+        SkinningCache(const SkinningCache&) = delete;
+        SkinningCache& operator=(const SkinningCache&) = delete;
+
+        //Skins packed skinned vertices with a palette by bone id into the static layout, UVs are copied over. Spread
+        //over the ThreadPool, touches no OpenGL so it works headless
+        static void skinVertices(std::span<const std::byte> vertices, std::span<const glm::mat4> palette, std::span<StaticVertex> output);
+
+        //Pre-skins every animated object with a MeshComponent whose pose changed since its last pass. Scene::update
+        //calls it after the poses were sampled, needs the OpenGL thread. Does nothing in Mode::Shader
+        static void update(const std::vector<std::shared_ptr<GameObject>>& objects);
+
+        //Skins the skinned meshes of model with palette into this instance's buffers
+        void skin(elix::Model& model, std::span<const glm::mat4> palette);
+
+        //Like Model::draw and Model::drawWithMaterials, but the skinned meshes come from this cache. Bind the STATIC
+        //shaders (STATIC_SHADOW, STATIC_STENCIL) for them
+        void draw(const elix::Model& model, size_t lod = 0) const;
+        void drawWithMaterials(const elix::Model& model, std::unordered_map<int, Material*>& materials, size_t lod = 0) const;
+
+        //Whether the cache holds skinned vertices and pre-skinning is on
+        [[nodiscard]] bool isValid() const;
+
+        //Pose version of AnimatorComponent the cache was skinned with
+        [[nodiscard]] uint32_t getPoseVersion() const;
+        void setPoseVersion(uint32_t poseVersion);
+
+        //Reads the skinned vertices of one mesh back from the GPU
+        [[nodiscard]] std::vector<StaticVertex> readBack(size_t meshIndex) const;
+
+        //Skins model on the GPU and on the CPU and compares the results. Returns the largest position difference
+        static float validate(elix::Model& model, std::span<const glm::mat4> palette);
+
+        //Frees the buffers, the next skin() creates them again
+        void release();
+
+        static void setMode(Mode mode);
+        [[nodiscard]] static Mode getMode();
+    private:
+        struct Output
+        {
+            elix::VertexArray vertexArray;
+            std::shared_ptr<elix::Buffer> vertexBuffer{nullptr};
+            //CPU mode only
+            std::vector<StaticVertex> vertices;
+            size_t vertexCount{0};
+        };
+
+        //Creates the outputs on first use or when the model changed
+        void prepare(elix::Model& model);
+        void skinOnGpu(const elix::Model& model, std::span<const glm::mat4> palette);
+        void upload();
+
+        std::vector<Output> m_outputs;
+        const elix::Model* m_model{nullptr};
+        uint32_t m_poseVersion{0};
+        bool m_isValid{false};
+    };
+} //namespace elix
+
+#endif //SKINNING_CACHE_HPP
@@ -1,10 +1,15 @@
 #ifndef TEXTURE_HPP
 #define TEXTURE_HPP
 
+#include <memory>
 #include <string>
 
+#include "TextureCooker.hpp"
+
 namespace elix
 {
+    class MappedFile;
+
     class Texture {
     public:
         struct TextureData
@@ -87,6 +92,9 @@ namespace elix
 
 
             bool useFloat{false};
+
+            //Cooked textures only. Starts with the smallest mips resident and lets TextureStreamer manage the rest
+            bool streamMips{false};
         };
 
         explicit Texture(const std::string& filePath, TextureParams* params = nullptr);
@@ -97,16 +105,40 @@ namespace elix
 
         void load(const std::string& filePath, TextureParams* params = nullptr);
 
+        //Maps a cooked texture (.etex). Every level is uploaded as stored by bake(), no mips are generated at runtime
+        bool loadCooked(const std::string& filePath, TextureParams* params = nullptr);
+
+        [[nodiscard]] bool isCooked() const;
+
+        //Mip streaming of cooked textures. Mip 0 is the full resolution level, the resident mip is the largest one uploaded
+        static constexpr uint32_t STREAMING_INITIAL_SIZE = 64;
+
+        [[nodiscard]] bool isStreaming() const;
+        [[nodiscard]] uint32_t getMipCount() const;
+        [[nodiscard]] uint32_t getResidentMip() const;
+        [[nodiscard]] uint32_t getMipWidth(uint32_t mip) const;
+        [[nodiscard]] size_t getMipChainMemorySize(uint32_t firstMip) const;
+
+        //Uploads mips [firstMip, last] into a new texture object. Must be called from the OpenGL thread
+        void setResidentMip(uint32_t firstMip);
+
         [[nodiscard]]const std::string& getName() const;
 
         [[nodiscard]]unsigned int getId() const;
 
+        //CPU side pixels, only valid until bake()
+        [[nodiscard]] const TextureData& getTextureData() const;
+
         void bake();
 
         void bakeCubemap(int width, int height);
 
         [[nodiscard]] bool isBaked() const;
 
+        //Size of the decoded pixels still held on the CPU and of the uploaded texture including its mip chain
+        [[nodiscard]] size_t getCpuMemorySize() const;
+        [[nodiscard]] size_t getGpuMemorySize() const;
+
         void bind(unsigned int slot = 0) const;
 
         void unbind(unsigned int slot) const;
@@ -118,6 +150,15 @@ namespace elix
         TextureData m_textureData;
         std::string m_name;
         TextureParams m_parameters;
+
+        void bakeCooked();
+        //False if the context cannot sample the cooked encoding
+        bool uploadCookedLevels(uint32_t firstMip);
+
+        std::shared_ptr<const elix::MappedFile> m_cookedSource{nullptr};
+        TextureCooker::TextureView m_cookedView;
+        size_t m_cookedGpuMemorySize{0};
+        uint32_t m_residentMip{0};
     };
 
 } //namespace elix
@@ -0,0 +1,111 @@
+#ifndef TEXTURE_COOKER_HPP
+#define TEXTURE_COOKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace elix
+{
+    //Binary layout of a cooked texture (.etex). Modeled after KTX2: a fixed header, a level index with one
+    //record per mip level and the level payloads, each 16 byte aligned, ready to be handed to the driver as is
+    namespace cooked
+    {
+        constexpr uint32_t TEXTURE_MAGIC = 0x58455445; // "ETEX"
+        constexpr uint32_t TEXTURE_VERSION = 1;
+
+        enum class TextureEncoding : uint32_t
+        {
+            RGBA8,
+            BC1,
+            BC3,
+            BC5,
+            BC7
+        };
+
+        enum TextureFlags : uint32_t
+        {
+            //Color data is sRGB encoded, mips were filtered in linear space
+            TEXTURE_FLAG_SRGB = 1 << 0,
+        };
+
+        struct TextureHeader
+        {
+            uint32_t magic{TEXTURE_MAGIC};
+            uint32_t version{TEXTURE_VERSION};
+            uint64_t fileSize{0};
+
+            TextureEncoding encoding{TextureEncoding::RGBA8};
+            uint32_t flags{0};
+            uint32_t width{0};
+            uint32_t height{0};
+
+            uint32_t levelCount{0};
+            uint32_t reserved{0};
+            uint64_t levelTableOffset{0};
+        };
+
+        struct TextureLevelRecord
+        {
+            uint64_t offset{0};
+            uint64_t size{0};
+            uint32_t width{0};
+            uint32_t height{0};
+        };
+    } //namespace cooked
+
+    //CPU only texture pipeline: mip generation, block compression and the container. Nothing in here touches OpenGL
+    class TextureCooker
+    {
+    public:
+        static constexpr const char* EXTENSION = ".etex";
+
+        //Tightly packed RGBA8 pixels
+        struct Image
+        {
+            uint32_t width{0};
+            uint32_t height{0};
+            std::vector<uint8_t> pixels;
+        };
+
+        struct Options
+        {
+            cooked::TextureEncoding encoding{cooked::TextureEncoding::BC7};
+            bool sRGB{true};
+            bool generateMips{true};
+            bool flipVertically{false};
+        };
+
+        //Validated view over the bytes of a cooked texture, usually a mapped file
+        struct TextureView
+        {
+            const cooked::TextureHeader* header{nullptr};
+            std::span<const cooked::TextureLevelRecord> levels;
+            std::span<const std::byte> bytes;
+
+            [[nodiscard]] std::span<const std::byte> getLevel(size_t level) const
+            {
+                return bytes.subspan(levels[level].offset, levels[level].size);
+            }
+        };
+
+        static bool cook(const std::string& sourcePath, const std::string& outputPath);
+        static bool cook(const std::string& sourcePath, const std::string& outputPath, const Options& options);
+
+        //Box filtered mip chain down to 1x1, base level included. sRGB color is filtered in linear space, alpha never is.
+        //Rows are split across the shared thread pool
+        static std::vector<Image> generateMipChain(const Image& base, bool sRGB);
+
+        static std::vector<uint8_t> encode(const Image& image, cooked::TextureEncoding encoding);
+
+        static std::vector<std::byte> serialize(const std::vector<Image>& levels, const Options& options);
+
+        static bool parse(std::span<const std::byte> bytes, TextureView& view);
+
+        [[nodiscard]] static size_t getEncodedSize(uint32_t width, uint32_t height, cooked::TextureEncoding encoding);
+    };
+} //namespace elix
+
+#endif //TEXTURE_COOKER_HPP
@@ -0,0 +1,60 @@
+#ifndef TEXTURE_STREAMER_HPP
+#define TEXTURE_STREAMER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class GameObject;
+
+namespace elix
+{
+    class Texture;
+    class CameraComponent;
+
+    //Keeps the mips of streamed cooked textures resident according to how large the meshes using them are on screen
+    class TextureStreamer
+    {
+    public:
+        static TextureStreamer& instance();
+
+        //Budget for every streamed texture together. 0 disables streaming, cooked textures then upload all their mips
+        void setMemoryBudget(size_t bytes);
+        [[nodiscard]] size_t getMemoryBudget() const;
+
+        //Streaming in a mip re-uploads the chain, this caps how many textures grow per update
+        void setMaxUploadsPerUpdate(size_t count);
+
+        //Computes the requested mip of every streamed texture from the MeshComponents in objects, then streams mips in
+        //or drops them to fit the budget. The engine has no camera or viewport of its own, so nothing calls this for
+        //you: the application calls it once per frame from the OpenGL thread, after Scene::update and before rendering.
+        //Without it streamed textures stay at their baked tail mips
+        void update(const std::vector<std::shared_ptr<GameObject>>& objects, const CameraComponent& camera, float viewportHeight);
+
+        [[nodiscard]] size_t getResidentMemorySize() const;
+
+        void registerTexture(Texture* texture);
+        void unregisterTexture(Texture* texture);
+
+    private:
+        struct StreamedTexture
+        {
+            Texture* texture{nullptr};
+            //Mip the texture was baked with, never dropped below
+            uint32_t tailMip{0};
+            uint32_t requestedMip{0};
+            //Largest on screen size in pixels of any mesh using the texture this frame
+            float screenSize{0.0f};
+        };
+
+        void requestMip(Texture* texture, float screenSize);
+
+        std::vector<StreamedTexture> m_textures;
+        std::unordered_map<Texture*, size_t> m_textureIndices;
+        size_t m_memoryBudget{0};
+        size_t m_maxUploadsPerUpdate{4};
+    };
+} //namespace elix
+
+#endif //TEXTURE_STREAMER_HPP
@@ -0,0 +1,133 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace elix
+{
+    //Work stealing pool. Every worker owns a deque: it pushes and pops its own tasks at the back, idle workers steal
+    //from the front of the others. Waiting for tasks runs queued ones on the waiting thread, so tasks may wait for
+    //tasks they spawned (nested parallelFor) without deadlocking
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t threadsCount = std::max(1u, std::thread::hardware_concurrency()));
+
+        //Shared pool for engine systems (asset import, animation, ...)
+        static ThreadPool& instance();
+
+        template<typename F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+
+            auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packagedTask->get_future();
+
+            push([packagedTask]() { (*packagedTask)(); });
+
+            return future;
+        }
+
+        //Splits [0, count) into chunks, calls function(begin, end) for each on the pool and waits for all of them,
+        //running chunks on the calling thread meanwhile. Safe to call from a task of this pool. Rethrows the first
+        //exception a chunk threw
+        template<typename F>
+        void parallelFor(size_t count, const F& function)
+        {
+            const size_t chunks = std::min(count, getThreadsCount() * 4);
+
+            if (chunks <= 1)
+            {
+                if (count > 0)
+                    function(size_t{0}, count);
+                return;
+            }
+
+            std::atomic<size_t> remaining{chunks};
+            std::exception_ptr exception;
+            std::mutex exceptionMutex;
+
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+            {
+                const size_t begin = count * chunk / chunks;
+                const size_t end = count * (chunk + 1) / chunks;
+
+                push([&function, &remaining, &exception, &exceptionMutex, begin, end]
+                {
+                    try
+                    {
+                        function(begin, end);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(exceptionMutex);
+
+                        if (!exception)
+                            exception = std::current_exception();
+                    }
+
+                    remaining.fetch_sub(1, std::memory_order_release);
+                });
+            }
+
+            wait([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+
+        //Runs queued tasks on the calling thread until isDone returns true
+        template<typename Predicate>
+        void wait(const Predicate& isDone)
+        {
+            while (!isDone())
+                if (!runPendingTask())
+                    std::this_thread::yield();
+        }
+
+        //Runs one queued task on the calling thread, preferring its own queue if it is a worker. False if there was
+        //nothing to run
+        bool runPendingTask();
+
+        [[nodiscard]] size_t getThreadsCount() const;
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        //Onto the calling worker's own queue, round robin over the queues from other threads
+        void push(std::function<void()> task);
+        bool pop(std::function<void()>& task);
+        void workerLoop(size_t queueIndex);
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        //Raised before a task is queued and lowered once it is taken, never below the number of queued tasks
+        std::atomic<size_t> m_pendingCount{0};
+        std::atomic<size_t> m_nextQueue{0};
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_isStopping{false};
+    };
+} //namespace elix
+
+#endif //THREAD_POOL_HPP
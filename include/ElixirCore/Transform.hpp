@@ -0,0 +1,23 @@
+#ifndef TRANSFORM_HPP
+#define TRANSFORM_HPP
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace elix
+{
+    //Local placement of a GameObject relative to its parent, kept by value in the Registry so systems can walk all of
+    //them contiguously. Parent links and world matrices live in TransformSystem
+    struct Transform
+    {
+        glm::vec3 position{0.0f};
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 scale{1.0f};
+        //Node of the transform in TransformSystem
+        uint32_t node{0xFFFFFFFF};
+    };
+} //namespace elix
+
+#endif //TRANSFORM_HPP
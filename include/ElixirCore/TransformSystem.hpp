@@ -0,0 +1,61 @@
+#ifndef TRANSFORM_SYSTEM_HPP
+#define TRANSFORM_SYSTEM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+#include "Registry.hpp"
+#include "Transform.hpp"
+
+namespace elix
+{
+    //Parent links and world matrices of every Transform. Nodes sit in contiguous arrays sorted by depth, so parents
+    //always come before their children and one linear pass per frame turns the flagged local changes into world
+    //matrices. Setters only flag their node: however often they run, a node is recomputed once per frame
+    class TransformSystem
+    {
+    public:
+        static constexpr uint32_t INVALID_NODE = 0xFFFFFFFF;
+
+        //Root node for the Transform of entity. Nodes are ids that stay valid until destroyNode
+        static uint32_t createNode(Entity entity);
+        //The node must not have children left, GameObject detaches them first
+        static void destroyNode(uint32_t node);
+
+        //INVALID_NODE makes the node a root. Returns false and changes nothing if parent is the node or one of its
+        //descendants
+        static bool setParent(uint32_t node, uint32_t parent);
+        [[nodiscard]] static uint32_t getParent(uint32_t node);
+
+        //Flags the local transform of node as changed, the next update recomputes it and its subtree
+        static void markDirty(uint32_t node);
+
+        //World matrix from the last update. If the node or one of its ancestors changed since, it is computed along
+        //the parent chain instead, without touching the cache
+        [[nodiscard]] static glm::mat4 getWorldMatrix(uint32_t node);
+
+        //Called from update with the new world matrix whenever it changed. An empty callback removes it
+        static void setChangedCallback(uint32_t node, const std::function<void(const glm::mat4&)>& callback);
+
+        //Re-sorts the nodes if the hierarchy changed, then propagates the dirty flags level by level. Levels wider
+        //than the parallel threshold are split over the ThreadPool. Callbacks run on the calling thread afterwards
+        static void update();
+
+        [[nodiscard]] static glm::mat4 computeLocalMatrix(const Transform& transform);
+
+        //World matrices in depth order, valid until the next structural change
+        [[nodiscard]] static std::span<const glm::mat4> getWorldMatrices();
+        [[nodiscard]] static size_t getNodeCount();
+        [[nodiscard]] static size_t getDepthCount();
+        //Nodes whose world matrix the last update recomputed
+        [[nodiscard]] static size_t getRecomputedCount();
+
+        //Minimum width of a level before it is processed in parallel
+        static void setParallelThreshold(size_t nodeCount);
+        [[nodiscard]] static size_t getParallelThreshold();
+    };
+} //namespace elix
+
+#endif //TRANSFORM_SYSTEM_HPP
@@ -0,0 +1,65 @@
+#ifndef UPDATE_PHASE_HPP
+#define UPDATE_PHASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace elix
+{
+    //Phases of a frame, run one after the other by the Scheduler
+    enum class UpdatePhase : uint8_t
+    {
+        Gameplay,
+        Animation,
+        Physics,
+        Transform,
+        Late,
+    };
+
+    constexpr size_t UPDATE_PHASE_COUNT = 5;
+
+    //Shared state a job touches, see Access
+    namespace Resource
+    {
+        enum : uint32_t
+        {
+            NONE = 0,
+            //The object list of the scene and the components attached to its objects
+            SCENE = 1 << 0,
+            TRANSFORMS = 1 << 1,
+            ANIMATION = 1 << 2,
+            PHYSICS = 1 << 3,
+            LIGHTS = 1 << 4,
+            CAMERA = 1 << 5,
+            SCRIPTS = 1 << 6,
+            RENDERING = 1 << 7,
+            //The context is only current on the thread running Scene::update, jobs touching it run there
+            OPENGL = 1 << 8,
+            ALL = 0xFFFFFFFF,
+        };
+    } //namespace Resource
+
+    //Read and write sets of a job. Two jobs of a phase conflict when one writes what the other reads or writes, the
+    //one declared first then runs first. Everything by default, which runs the job alone on the calling thread
+    struct Access
+    {
+        uint32_t reads{Resource::ALL};
+        uint32_t writes{Resource::ALL};
+
+        [[nodiscard]] bool conflictsWith(const Access& other) const
+        {
+            return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+        }
+
+        [[nodiscard]] bool touches(uint32_t resources) const { return ((reads | writes) & resources) != 0; }
+
+        Access& operator|=(const Access& other)
+        {
+            reads |= other.reads;
+            writes |= other.writes;
+            return *this;
+        }
+    };
+} //namespace elix
+
+#endif //UPDATE_PHASE_HPP
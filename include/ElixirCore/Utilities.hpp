@@ -131,24 +131,6 @@ namespace utilities
         return start + t * (end - start);
     }
 
-    inline std::pair<const common::SQT*, const common::SQT*> findKeyframes(const std::vector<common::SQT>& keyFrames, const float currentTime)
-    {
-        if (keyFrames.empty())
-            return {nullptr, nullptr};
-
-        if (currentTime <= keyFrames.front().timeStamp)
-            return {&keyFrames.front(), &keyFrames.front()};
-
-        if (currentTime >= keyFrames.back().timeStamp)
-            return {&keyFrames.back(), &keyFrames.back()};
-
-        for (size_t i = 1; i < keyFrames.size(); ++i)
-            if (currentTime < keyFrames[i].timeStamp)
-                return {&keyFrames[i - 1], &keyFrames[i]};
-
-        return {nullptr, nullptr};  // Should never reach here
-    }
-
     inline glm::mat4 convertMatrixToGLMFormat(const aiMatrix4x4& from)
     {
         glm::mat4 to;
@@ -0,0 +1,67 @@
+#ifndef VERTEX_ANIMATION_HPP
+#define VERTEX_ANIMATION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Buffer.hpp"
+#include "Model.hpp"
+
+namespace elix
+{
+    //Skeletal clips baked into per vertex positions and normals at a fixed rate. Playing them back is a buffer fetch
+    //and a lerp per vertex, no bones are evaluated at runtime. Meant for background crowds
+    class VertexAnimation
+    {
+    public:
+        struct Clip
+        {
+            std::string name;
+            //Frame rows of the clip in every mesh's buffer
+            uint32_t firstFrame{0};
+            uint32_t frameCount{0};
+            //Seconds
+            float duration{0.0f};
+        };
+
+        //Samples every clip of a skinned model at frameRate frames per second and skins the vertices on the CPU.
+        //Import time work, touches no OpenGL. Returns nullptr if the model has no skeleton or no clip matches it
+        static std::shared_ptr<VertexAnimation> bake(elix::Model& model, std::span<common::Animation* const> animations, float frameRate = 30.0f);
+
+        //Index into getClips(), -1 if there is no clip of that name
+        [[nodiscard]] int findClip(const std::string& name) const;
+
+        [[nodiscard]] const std::vector<Clip>& getClips() const;
+        [[nodiscard]] float getFrameRate() const;
+        [[nodiscard]] uint32_t getFrameCount() const;
+        [[nodiscard]] const elix::Model* getModel() const;
+
+        //Frame rows of one mesh, vertexCount texels each: xyz is the position, w the bits of the octahedral snorm16
+        //normal. Empty for meshes without bones
+        [[nodiscard]] std::span<const glm::vec4> getFrames(size_t meshIndex) const;
+
+        //Uploads the frames into one shader storage buffer per mesh. Has to run on the OpenGL thread, bindFrames does
+        //it lazily otherwise
+        void upload();
+        //Binds the frames of a mesh to the FRAME_BINDING point
+        void bindFrames(size_t meshIndex);
+
+        [[nodiscard]] size_t getMemorySize() const;
+
+        //Binding point of the frames in the vertex animation shaders
+        static constexpr unsigned int FRAME_BINDING = 2;
+    private:
+        elix::Model* m_model{nullptr};
+        float m_frameRate{30.0f};
+        uint32_t m_frameCount{0};
+        std::vector<Clip> m_clips;
+
+        std::vector<std::vector<glm::vec4>> m_frames;
+        std::vector<std::shared_ptr<elix::Buffer>> m_buffers;
+    };
+} //namespace elix
+
+#endif //VERTEX_ANIMATION_HPP
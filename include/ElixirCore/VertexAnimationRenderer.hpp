@@ -0,0 +1,42 @@
+#ifndef VERTEX_ANIMATION_RENDERER_HPP
+#define VERTEX_ANIMATION_RENDERER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Shader.hpp"
+#include "VertexAnimation.hpp"
+
+namespace elix
+{
+    //Instanced draws of VertexAnimatorComponent objects, one call per mesh for all instances of a bake at one detail
+    //level. Every instance costs a model matrix and a frame number per frame. Needs OpenGL 4.3
+    class VertexAnimationRenderer
+    {
+    public:
+        struct Batch
+        {
+            elix::VertexAnimation* animation{nullptr};
+            size_t lod{0};
+            uint32_t firstInstance{0};
+            uint32_t instanceCount{0};
+        };
+
+        //Gathers every playing VertexAnimatorComponent with a MeshComponent that is not culled and marks the
+        //MeshComponent instanced. Scene::update calls it after elix::SkinnedRenderer::update, needs the OpenGL thread
+        static void update(const std::vector<std::shared_ptr<GameObject>>& objects);
+
+        //Draws every batch with shader, which has to be bound with its camera or light uniforms set: VERTEX_ANIMATION,
+        //VERTEX_ANIMATION_SHADOW or VERTEX_ANIMATION_STENCIL. Meshes of the model without bones are not drawn
+        static void draw(elix::Shader& shader);
+
+        [[nodiscard]] static const std::vector<Batch>& getBatches();
+        [[nodiscard]] static size_t getInstanceCount();
+
+        //Frees the instance buffer, call before the context goes away
+        static void release();
+    };
+} //namespace elix
+
+#endif //VERTEX_ANIMATION_RENDERER_HPP
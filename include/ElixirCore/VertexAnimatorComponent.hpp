@@ -0,0 +1,42 @@
+#ifndef VERTEX_ANIMATOR_COMPONENT_HPP
+#define VERTEX_ANIMATOR_COMPONENT_HPP
+
+#include "Component.hpp"
+#include "VertexAnimation.hpp"
+
+#include <memory>
+#include <string>
+
+//Plays baked clips of an elix::VertexAnimation. Only a clock per instance, elix::VertexAnimationRenderer draws every
+//instance of the same bake in one call
+class VertexAnimatorComponent final : public Component
+{
+public:
+    explicit VertexAnimatorComponent(std::shared_ptr<elix::VertexAnimation> animation);
+
+    void update(float deltaTime) override;
+    [[nodiscard]] elix::UpdatePhase getUpdatePhase() const override { return elix::UpdatePhase::Animation; }
+    [[nodiscard]] elix::Access getAccess() const override { return {elix::Resource::NONE, elix::Resource::ANIMATION}; }
+    [[nodiscard]] bool isThreadSafe() const override { return true; }
+
+    //Loops clipName starting timeOffset seconds in, so instances sharing a clip do not move in lockstep. Returns false
+    //if the bake has no such clip
+    bool play(const std::string& clipName, float timeOffset = 0.0f);
+
+    void setSpeed(float speed);
+    [[nodiscard]] float getSpeed() const;
+
+    //Playing clip, nullptr before play
+    [[nodiscard]] const elix::VertexAnimation::Clip* getClip() const;
+    //Fractional frame within the clip
+    [[nodiscard]] float getFrame() const;
+
+    [[nodiscard]] const std::shared_ptr<elix::VertexAnimation>& getAnimation() const;
+private:
+    std::shared_ptr<elix::VertexAnimation> m_animation{nullptr};
+    int m_clip{-1};
+    float m_time{0.0f};
+    float m_speed{1.0f};
+};
+
+#endif //VERTEX_ANIMATOR_COMPONENT_HPP
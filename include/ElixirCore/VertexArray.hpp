@@ -11,17 +11,28 @@ namespace elix
         enum class Type
         {
             Float,
-            Int
+            Int,
+            HalfFloat,
+            Byte,
+            UnsignedByte,
+            Short,
+            UnsignedShort
         };
 
         VertexArray();
 
         void create();
 
+        void destroy();
+
         void bind() const;
 
+        //Int attributes stay integers in the shader, every other type is converted to float
         void setAttribute(int index, size_t size, Type type, bool normalized, size_t stride, const void* data);
 
+        //Integer attribute of any integer type, read as ivec/uvec in the shader
+        void setIntegerAttribute(int index, size_t size, Type type, size_t stride, const void* data);
+
         unsigned int getId() const;
 
         void unbind() const;
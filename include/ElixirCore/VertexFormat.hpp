@@ -0,0 +1,97 @@
+#ifndef VERTEX_FORMAT_HPP
+#define VERTEX_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Common.hpp"
+
+namespace elix
+{
+    //GPU vertex layouts. common::Vertex stays the full precision format the importers and offline passes work with,
+    //meshes only keep the packed form
+    enum class VertexLayout : uint32_t
+    {
+        Static,
+        Skinned
+    };
+
+    enum class IndexType : uint32_t
+    {
+        UInt16,
+        UInt32
+    };
+
+    //24 bytes. Normal and tangent are octahedral encoded, the tangent's z holds the bitangent sign
+    //or zero if the mesh has no tangents
+    struct StaticVertex
+    {
+        glm::vec3 position;
+        int16_t normal[2];
+        int8_t tangent[4];
+        uint16_t textureCoordinates[2];
+    };
+
+    //36 bytes. Unused influences have a zero weight, the bone index does not matter then
+    struct SkinnedVertex
+    {
+        glm::vec3 position;
+        int16_t normal[2];
+        int8_t tangent[4];
+        uint16_t textureCoordinates[2];
+        uint8_t boneIds[4];
+        uint16_t weights[4];
+    };
+
+    //24 bytes, all the depth only passes fetch from a skinned mesh. Static meshes keep a bare glm::vec3
+    struct SkinnedDepthVertex
+    {
+        glm::vec3 position;
+        uint8_t boneIds[4];
+        uint16_t weights[4];
+    };
+
+    static_assert(sizeof(StaticVertex) == 24 && sizeof(SkinnedVertex) == 36, "Vertex layouts are uploaded and cooked as is");
+    static_assert(sizeof(SkinnedDepthVertex) == 24, "Depth vertices are uploaded as is");
+
+    class VertexFormat
+    {
+    public:
+        //Bone indices are stored in a byte
+        static constexpr uint32_t MAX_SKINNED_BONES = 256;
+
+        [[nodiscard]] static size_t getStride(VertexLayout layout);
+        [[nodiscard]] static size_t getIndexSize(IndexType type);
+        [[nodiscard]] static size_t getDepthStride(VertexLayout layout);
+
+        [[nodiscard]] static VertexLayout selectLayout(std::span<const common::Vertex> vertices);
+        [[nodiscard]] static IndexType selectIndexType(size_t vertexCount);
+
+        //False if a vertex references a bone id the skinned layout cannot hold, packing drops those influences
+        [[nodiscard]] static bool areBonesPackable(std::span<const common::Vertex> vertices);
+
+        static std::vector<std::byte> packVertices(std::span<const common::Vertex> vertices, VertexLayout layout);
+        static std::vector<std::byte> packIndices(std::span<const unsigned int> indices, IndexType type);
+
+        //Decodes a packed vertex back to the full format, tangent and bitangent are rebuilt from the encoded frame
+        [[nodiscard]] static common::Vertex unpackVertex(std::span<const std::byte> vertices, VertexLayout layout, size_t index);
+
+        //Position is the first member of every layout
+        [[nodiscard]] static glm::vec3 getPosition(std::span<const std::byte> vertices, VertexLayout layout, size_t index);
+
+        //Keeps only position and skinning data and merges vertices that differed just in attributes the depth passes
+        //ignore (UV seams, hard normals). Indices are remapped into depthIndices with the same index type. False and
+        //empty streams if an index points past the vertices
+        static bool extractDepthStream(std::span<const std::byte> vertices, VertexLayout layout, std::span<const std::byte> indices, IndexType indexType,
+                                       std::vector<std::byte>& depthVertices, std::vector<std::byte>& depthIndices);
+
+        [[nodiscard]] static uint32_t getIndex(std::span<const std::byte> indices, IndexType type, size_t index);
+
+        [[nodiscard]] static glm::vec2 encodeOctahedral(const glm::vec3& direction);
+        [[nodiscard]] static glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+    };
+} //namespace elix
+
+#endif //VERTEX_FORMAT_HPP
@@ -1,7 +1,7 @@
 #version 330 core
 
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 1) in vec2 aNormal; // octahedral
 layout (location = 2) in vec2 aTexCoords;
 #define MAX_LIGHTS 4
 
@@ -19,11 +19,19 @@ uniform mat4 projection;
 uniform mat4 lightSpaceMatrices[MAX_LIGHTS];
 
 
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+
 void main()
 {
     vec4 worldPosition = model * vec4(aPos, 1.0);
     vs_out.FragPos = worldPosition.xyz;
-    vs_out.Normal = mat3(transpose(inverse(model))) * aNormal;
+    vs_out.Normal = mat3(transpose(inverse(model))) * decodeOctahedral(aNormal);
     vs_out.TexCoords = aTexCoords;
 
     for (int i = 0; i < MAX_LIGHTS; ++i)
@@ -1,7 +1,7 @@
 #version 330 core
 
 layout (location = 0) in vec3 pos;
-layout (location = 5) in ivec4 boneIds;
+layout (location = 5) in uvec4 boneIds;
 layout (location = 6) in vec4 weights;
 #define MAX_LIGHTS 4
 
@@ -17,7 +17,7 @@ void main()
 {
     mat4 boneTransform = mat4(0.0);
     for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
-        if (boneIds[i] >= 0)
+        if (weights[i] > 0.0)
             boneTransform += finalBonesMatrices[boneIds[i]] * weights[i];
     }
     if (boneTransform == mat4(0.0))
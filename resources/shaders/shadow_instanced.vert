@@ -0,0 +1,43 @@
+#version 430 core
+
+layout (location = 0) in vec3 pos;
+layout (location = 5) in uvec4 boneIds;
+layout (location = 6) in vec4 weights;
+#define MAX_LIGHTS 4
+
+const int MAX_BONE_INFLUENCE = 4;
+
+struct Instance
+{
+    mat4 model;
+    uint paletteOffset;
+};
+
+layout(std430, binding = 0) readonly buffer BonePalettes
+{
+    mat4 bonePalettes[];
+};
+
+layout(std430, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+uniform mat4 lightSpaceMatrices[MAX_LIGHTS];
+uniform int lightIndex;
+uniform int instanceOffset;
+
+void main()
+{
+    Instance instance = instances[instanceOffset + gl_InstanceID];
+
+    mat4 boneTransform = mat4(0.0);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; ++i) {
+        if (weights[i] > 0.0)
+            boneTransform += bonePalettes[instance.paletteOffset + boneIds[i]] * weights[i];
+    }
+    if (boneTransform == mat4(0.0))
+        boneTransform = mat4(1.0);
+
+    gl_Position = lightSpaceMatrices[lightIndex] * instance.model * boneTransform * vec4(pos, 1.0);
+}
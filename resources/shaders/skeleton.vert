@@ -1,11 +1,10 @@
 #version 330 core
 
 layout(location = 0) in vec3 pos;
-layout(location = 1) in vec3 norm;
+layout(location = 1) in vec2 norm; // octahedral
 layout(location = 2) in vec2 tex;
-layout(location = 3) in vec3 tangent;
-layout(location = 4) in vec3 bitangent;
-layout(location = 5) in ivec4 boneIds;
+layout(location = 3) in vec4 tangent; // octahedral xy, bitangent sign in z
+layout(location = 5) in uvec4 boneIds;
 layout(location = 6) in vec4 weights;
 
 const int MAX_BONES = 100;
@@ -25,12 +24,20 @@ out VS_OUT {
 } vs_out;
 
 
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+
 void main()
 {
     mat4 boneTransform = mat4(0.0);
     for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
     {
-        if (boneIds[i] >= 0)
+        if (weights[i] > 0.0)
         {
             boneTransform += finalBonesMatrices[boneIds[i]] * weights[i];
         }
@@ -41,7 +48,7 @@ void main()
 
     vec4 worldPos = model * boneTransform * vec4(pos, 1.0);
     vs_out.FragPos = vec3(worldPos);
-    vs_out.Normal = mat3(transpose(inverse(model * boneTransform))) * norm;
+    vs_out.Normal = mat3(transpose(inverse(model * boneTransform))) * decodeOctahedral(norm);
     vs_out.TexCoords = tex;
     vs_out.FragPosLightSpace = lightSpaceMatrix * worldPos;
 
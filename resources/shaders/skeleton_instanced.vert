@@ -0,0 +1,74 @@
+#version 430 core
+
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec2 norm; // octahedral
+layout(location = 2) in vec2 tex;
+layout(location = 3) in vec4 tangent; // octahedral xy, bitangent sign in z
+layout(location = 5) in uvec4 boneIds;
+layout(location = 6) in vec4 weights;
+
+const int MAX_BONE_INFLUENCE = 4;
+
+struct Instance
+{
+    mat4 model;
+    uint paletteOffset;
+};
+
+// Palettes of every skinned instance this frame, back to back. No bone limit
+layout(std430, binding = 0) readonly buffer BonePalettes
+{
+    mat4 bonePalettes[];
+};
+
+layout(std430, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+// First instance of the batch in the instance buffer
+uniform int instanceOffset;
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 lightSpaceMatrix;
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    vec4 FragPosLightSpace;
+} vs_out;
+
+
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+
+void main()
+{
+    Instance instance = instances[instanceOffset + gl_InstanceID];
+
+    mat4 boneTransform = mat4(0.0);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+    {
+        if (weights[i] > 0.0)
+        {
+            boneTransform += bonePalettes[instance.paletteOffset + boneIds[i]] * weights[i];
+        }
+    }
+
+    if (boneTransform == mat4(0.0))
+    boneTransform = mat4(1.0);
+
+    vec4 worldPos = instance.model * boneTransform * vec4(pos, 1.0);
+    vs_out.FragPos = vec3(worldPos);
+    vs_out.Normal = mat3(transpose(inverse(instance.model * boneTransform))) * decodeOctahedral(norm);
+    vs_out.TexCoords = tex;
+    vs_out.FragPosLightSpace = lightSpaceMatrix * worldPos;
+
+    gl_Position = projection * view * worldPos;
+}
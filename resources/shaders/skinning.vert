@@ -0,0 +1,90 @@
+#version 330 core
+
+// Pre-skinning pass, captured with transform feedback. The outputs are laid out exactly like a static vertex
+// (position, octahedral snorm16 normal, snorm8 tangent, half UVs) so the result draws with the static shaders
+
+layout(location = 0) in vec3 pos;
+layout(location = 1) in vec2 norm; // octahedral
+layout(location = 2) in vec2 tex;
+layout(location = 3) in vec4 tangent; // octahedral xy, bitangent sign in z
+layout(location = 5) in uvec4 boneIds;
+layout(location = 6) in vec4 weights;
+
+const int MAX_BONES = 100;
+const int MAX_BONE_INFLUENCE = 4;
+
+uniform mat4 finalBonesMatrices[MAX_BONES];
+
+out vec3 skinnedPosition;
+flat out uint skinnedNormal;
+flat out uint skinnedTangent;
+flat out uint skinnedTextureCoordinates;
+
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+
+vec2 encodeOctahedral(vec3 direction)
+{
+    vec2 encoded = direction.xy / max(abs(direction.x) + abs(direction.y) + abs(direction.z), 1e-20);
+
+    if (direction.z < 0.0)
+    {
+        vec2 folded = 1.0 - abs(encoded.yx);
+        encoded = vec2(encoded.x >= 0.0 ? folded.x : -folded.x, encoded.y >= 0.0 ? folded.y : -folded.y);
+    }
+
+    return encoded;
+}
+
+// GLSL 3.30 has no packing functions
+uint packSnorm(float value, float scale, uint mask)
+{
+    return uint(int(round(clamp(value, -1.0, 1.0) * scale))) & mask;
+}
+
+uint packHalf(float value)
+{
+    uint bits = floatBitsToUint(value);
+    uint sign = (bits >> 16) & 0x8000u;
+    int exponent = int((bits >> 23) & 0xFFu) - 112;
+
+    if (exponent <= 0)
+        return sign;
+
+    if (exponent >= 31)
+        return sign | 0x7C00u;
+
+    return sign | (uint(exponent) << 10) | ((bits >> 13) & 0x3FFu);
+}
+
+void main()
+{
+    mat4 boneTransform = mat4(0.0);
+    for (int i = 0; i < MAX_BONE_INFLUENCE; i++)
+    {
+        if (weights[i] > 0.0)
+            boneTransform += finalBonesMatrices[boneIds[i]] * weights[i];
+    }
+
+    if (boneTransform == mat4(0.0))
+        boneTransform = mat4(1.0);
+
+    mat3 linear = mat3(boneTransform);
+
+    skinnedPosition = vec3(boneTransform * vec4(pos, 1.0));
+
+    vec2 normal = encodeOctahedral(transpose(inverse(linear)) * decodeOctahedral(norm));
+    skinnedNormal = packSnorm(normal.x, 32767.0, 0xFFFFu) | (packSnorm(normal.y, 32767.0, 0xFFFFu) << 16);
+
+    // A zero sign marks a mesh without tangents, it stays that way
+    vec2 tangentDirection = tangent.z != 0.0 ? encodeOctahedral(linear * decodeOctahedral(tangent.xy)) : tangent.xy;
+    skinnedTangent = packSnorm(tangentDirection.x, 127.0, 0xFFu) | (packSnorm(tangentDirection.y, 127.0, 0xFFu) << 8) |
+                     (packSnorm(tangent.z, 127.0, 0xFFu) << 16);
+
+    skinnedTextureCoordinates = packHalf(tex.x) | (packHalf(tex.y) << 16);
+}
@@ -0,0 +1,76 @@
+#version 430 core
+
+// Plays clips baked by elix::VertexAnimation. Position and normal come from the frame buffer by gl_VertexID,
+// the vertex attributes only bring the texture coordinates
+
+layout(location = 2) in vec2 tex;
+
+struct Instance
+{
+    mat4 model;
+    uint firstFrame;
+    uint frameCount;
+    // Fractional frame within the clip
+    float frame;
+};
+
+layout(std430, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+// xyz position, w the bits of the octahedral snorm16 normal
+layout(std430, binding = 2) readonly buffer Frames
+{
+    vec4 frames[];
+};
+
+uniform int instanceOffset;
+uniform int vertexCount;
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 lightSpaceMatrix;
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    vec4 FragPosLightSpace;
+} vs_out;
+
+
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-direction.z, 0.0);
+    direction.xy += vec2(direction.x >= 0.0 ? -fold : fold, direction.y >= 0.0 ? -fold : fold);
+    return normalize(direction);
+}
+
+vec3 decodeNormal(float packedNormal)
+{
+    return decodeOctahedral(unpackSnorm2x16(floatBitsToUint(packedNormal)));
+}
+
+void main()
+{
+    Instance instance = instances[instanceOffset + gl_InstanceID];
+
+    uint frame = uint(instance.frame) % instance.frameCount;
+    uint nextFrame = (frame + 1u) % instance.frameCount;
+    float blend = fract(instance.frame);
+
+    vec4 start = frames[(instance.firstFrame + frame) * uint(vertexCount) + uint(gl_VertexID)];
+    vec4 end = frames[(instance.firstFrame + nextFrame) * uint(vertexCount) + uint(gl_VertexID)];
+
+    vec3 position = mix(start.xyz, end.xyz, blend);
+    vec3 normal = normalize(mix(decodeNormal(start.w), decodeNormal(end.w), blend));
+
+    vec4 worldPos = instance.model * vec4(position, 1.0);
+    vs_out.FragPos = vec3(worldPos);
+    vs_out.Normal = mat3(transpose(inverse(instance.model))) * normal;
+    vs_out.TexCoords = tex;
+    vs_out.FragPosLightSpace = lightSpaceMatrix * worldPos;
+
+    gl_Position = projection * view * worldPos;
+}
@@ -0,0 +1,39 @@
+#version 430 core
+
+#define MAX_LIGHTS 4
+
+struct Instance
+{
+    mat4 model;
+    uint firstFrame;
+    uint frameCount;
+    float frame;
+};
+
+layout(std430, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std430, binding = 2) readonly buffer Frames
+{
+    vec4 frames[];
+};
+
+uniform mat4 lightSpaceMatrices[MAX_LIGHTS];
+uniform int lightIndex;
+uniform int instanceOffset;
+uniform int vertexCount;
+
+void main()
+{
+    Instance instance = instances[instanceOffset + gl_InstanceID];
+
+    uint frame = uint(instance.frame) % instance.frameCount;
+    uint nextFrame = (frame + 1u) % instance.frameCount;
+
+    vec3 start = frames[(instance.firstFrame + frame) * uint(vertexCount) + uint(gl_VertexID)].xyz;
+    vec3 end = frames[(instance.firstFrame + nextFrame) * uint(vertexCount) + uint(gl_VertexID)].xyz;
+
+    gl_Position = lightSpaceMatrices[lightIndex] * instance.model * vec4(mix(start, end, fract(instance.frame)), 1.0);
+}
@@ -0,0 +1,465 @@
+#include "AnimationClip.hpp"
+
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr float MAX_QUANTIZED = static_cast<float>(std::numeric_limits<uint16_t>::max());
+    //Smallest three components lie in [-1/sqrt(2), 1/sqrt(2)] and get 15 bits each, the top bits hold the dropped index
+    constexpr float MAX_ROTATION_QUANTIZED = 32767.0f;
+    constexpr float SQRT_2 = 1.41421356237f;
+
+    using Quantized = std::array<uint16_t, 3>;
+
+    uint16_t quantizeUnit(float value, float scale)
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * scale));
+    }
+
+    Quantized quantizeVector(const glm::vec3& value, const glm::vec3& rangeMin, const glm::vec3& rangeExtent)
+    {
+        Quantized result{};
+
+        for (int i = 0; i < 3; ++i)
+            result[i] = rangeExtent[i] > 0.0f ? quantizeUnit((value[i] - rangeMin[i]) / rangeExtent[i], MAX_QUANTIZED) : 0;
+
+        return result;
+    }
+
+    glm::vec3 dequantizeVector(const uint16_t* value, const glm::vec3& rangeMin, const glm::vec3& rangeExtent)
+    {
+        return rangeMin + rangeExtent * glm::vec3(value[0], value[1], value[2]) * (1.0f / MAX_QUANTIZED);
+    }
+
+    Quantized quantizeRotation(glm::quat rotation)
+    {
+        rotation = glm::normalize(rotation);
+
+        const float components[4]{rotation.x, rotation.y, rotation.z, rotation.w};
+        int largest = 0;
+
+        for (int i = 1; i < 4; ++i)
+            if (std::abs(components[i]) > std::abs(components[largest]))
+                largest = i;
+
+        //q and -q are the same rotation, the dropped component is always rebuilt as positive
+        const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+        Quantized result{};
+
+        for (int i = 0, j = 0; i < 4; ++i)
+            if (i != largest)
+                result[j++] = quantizeUnit((components[i] * sign * SQRT_2 + 1.0f) * 0.5f, MAX_ROTATION_QUANTIZED);
+
+        result[0] |= static_cast<uint16_t>((largest >> 1) << 15);
+        result[1] |= static_cast<uint16_t>((largest & 1) << 15);
+
+        return result;
+    }
+
+    glm::quat dequantizeRotation(const uint16_t* value)
+    {
+        const int largest = ((value[0] >> 15) << 1) | (value[1] >> 15);
+
+        float components[4];
+        float sum = 0.0f;
+
+        for (int i = 0, j = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+
+            components[i] = (static_cast<float>(value[j++] & 0x7fff) * (2.0f / MAX_ROTATION_QUANTIZED) - 1.0f) * (1.0f / SQRT_2);
+            sum += components[i] * components[i];
+        }
+
+        components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+        return glm::quat(components[3], components[0], components[1], components[2]);
+    }
+
+    glm::quat nlerp(const glm::quat& start, glm::quat end, float t)
+    {
+        if (glm::dot(start, end) < 0.0f)
+            end = -end;
+
+        return glm::normalize(start * (1.0f - t) + end * t);
+    }
+
+    float angleBetween(const glm::quat& a, const glm::quat& b)
+    {
+        return 2.0f * std::acos(std::min(1.0f, std::abs(glm::dot(a, b))));
+    }
+
+    //Dequantized channel being built, only used while compressing
+    template<typename T>
+    struct ChannelKeys
+    {
+        std::vector<uint16_t> times;
+        std::vector<Quantized> values;
+        std::vector<T> decoded;
+    };
+
+    template<typename T, typename Interpolate, typename Error>
+    std::vector<size_t> reduceKeys(const std::vector<elix::AnimationClip::Key<T>>& raw, const ChannelKeys<T>& keys, float tolerance,
+                                   Interpolate interpolate, Error error)
+    {
+        std::vector<size_t> kept{0};
+
+        if (raw.size() == 1)
+            return kept;
+
+        const bool isConstant = std::ranges::all_of(raw, [&](const auto& key) {return error(keys.decoded.front(), key.value) <= tolerance;});
+
+        if (isConstant)
+            return kept;
+
+        //Greedy: from the last kept key, extend the segment while linear interpolation of its ends still reproduces every
+        //source key inside it
+        size_t anchor = 0;
+
+        while (anchor + 1 < raw.size())
+        {
+            size_t end = anchor + 1;
+
+            while (end + 1 < raw.size())
+            {
+                const size_t candidate = end + 1;
+                const float start = keys.times[anchor];
+                const float span = static_cast<float>(keys.times[candidate]) - start;
+                bool isValid = true;
+
+                for (size_t i = anchor + 1; i < candidate && isValid; ++i)
+                {
+                    const float t = span > 0.0f ? (keys.times[i] - start) / span : 0.0f;
+                    isValid = error(interpolate(keys.decoded[anchor], keys.decoded[candidate], t), raw[i].value) <= tolerance;
+                }
+
+                if (!isValid)
+                    break;
+
+                end = candidate;
+            }
+
+            kept.push_back(end);
+            anchor = end;
+        }
+
+        return kept;
+    }
+} //namespace
+
+elix::AnimationClip elix::AnimationClip::compress(const std::string &name, float duration, float ticksPerSecond, const std::vector<RawTrack> &tracks)
+{
+    return compress(name, duration, ticksPerSecond, tracks, Settings{});
+}
+
+elix::AnimationClip elix::AnimationClip::compress(const std::string &name, float duration, float ticksPerSecond, const std::vector<RawTrack> &tracks,
+                                                  const Settings &settings)
+{
+    AnimationClip clip;
+    clip.m_name = name;
+    clip.m_duration = duration;
+    clip.m_ticksPerSecond = ticksPerSecond;
+    clip.m_tracks.reserve(tracks.size());
+    clip.m_trackNames.reserve(tracks.size());
+
+    size_t rawKeyCount = 0;
+
+    const auto quantizeTime = [duration](float time)
+    {
+        return duration > 0.0f ? quantizeUnit(time / duration, MAX_QUANTIZED) : uint16_t{0};
+    };
+
+    const auto appendKeys = [&clip](ChannelRange& channel, const auto& keys, const std::vector<size_t>& kept)
+    {
+        channel.firstKey = static_cast<uint32_t>(clip.m_keyTimes.size());
+        channel.keyCount = static_cast<uint32_t>(kept.size());
+
+        for (const size_t index : kept)
+        {
+            clip.m_keyTimes.push_back(keys.times[index]);
+            clip.m_keyValues.insert(clip.m_keyValues.end(), keys.values[index].begin(), keys.values[index].end());
+        }
+    };
+
+    const auto compressVector = [&](ChannelRange& channel, const std::vector<Key<glm::vec3>>& raw, float tolerance)
+    {
+        if (raw.empty())
+            return;
+
+        glm::vec3 rangeMax = raw.front().value;
+        channel.rangeMin = raw.front().value;
+
+        for (const auto& key : raw)
+        {
+            channel.rangeMin = glm::min(channel.rangeMin, key.value);
+            rangeMax = glm::max(rangeMax, key.value);
+        }
+
+        channel.rangeExtent = rangeMax - channel.rangeMin;
+
+        ChannelKeys<glm::vec3> keys;
+
+        for (const auto& key : raw)
+        {
+            keys.times.push_back(quantizeTime(key.time));
+            keys.values.push_back(quantizeVector(key.value, channel.rangeMin, channel.rangeExtent));
+            keys.decoded.push_back(dequantizeVector(keys.values.back().data(), channel.rangeMin, channel.rangeExtent));
+        }
+
+        const auto kept = reduceKeys(raw, keys, tolerance,
+                                     [](const glm::vec3& start, const glm::vec3& end, float t) {return start + (end - start) * t;},
+                                     [](const glm::vec3& a, const glm::vec3& b) {return glm::length(a - b);});
+
+        appendKeys(channel, keys, kept);
+    };
+
+    const auto compressRotation = [&](ChannelRange& channel, const std::vector<Key<glm::quat>>& raw, float tolerance)
+    {
+        if (raw.empty())
+            return;
+
+        ChannelKeys<glm::quat> keys;
+
+        for (const auto& key : raw)
+        {
+            keys.times.push_back(quantizeTime(key.time));
+            keys.values.push_back(quantizeRotation(key.value));
+            keys.decoded.push_back(dequantizeRotation(keys.values.back().data()));
+        }
+
+        const auto kept = reduceKeys(raw, keys, tolerance, nlerp, angleBetween);
+
+        appendKeys(channel, keys, kept);
+    };
+
+    for (const auto& track : tracks)
+    {
+        Track& compressed = clip.m_tracks.emplace_back();
+        clip.m_trackNames.push_back(track.name);
+
+        compressVector(compressed.channels[TRANSLATION], track.translations, settings.translationError);
+        compressRotation(compressed.channels[ROTATION], track.rotations, settings.rotationError);
+        compressVector(compressed.channels[SCALE], track.scales, settings.scaleError);
+
+        rawKeyCount += track.translations.size() + track.rotations.size() + track.scales.size();
+    }
+
+    const size_t rawBytes = rawKeyCount * (sizeof(float) + sizeof(glm::quat));
+
+    ELIX_LOG_INFO("Compressed animation ", name, ": keys ", rawKeyCount, " -> ", clip.getKeyCount(), ", bytes ", rawBytes, " -> ", clip.getMemorySize());
+
+    return clip;
+}
+
+elix::AnimationClip::Transform elix::AnimationClip::sample(size_t track, float time) const
+{
+    const float normalizedTime = normalizeTime(time);
+    const auto& channels = m_tracks[track].channels;
+
+    Transform transform;
+
+    if (channels[TRANSLATION].keyCount > 0)
+        transform.translation = sampleVector(channels[TRANSLATION], findKey(channels[TRANSLATION], normalizedTime), normalizedTime);
+
+    if (channels[ROTATION].keyCount > 0)
+        transform.rotation = sampleRotation(channels[ROTATION], findKey(channels[ROTATION], normalizedTime), normalizedTime);
+
+    if (channels[SCALE].keyCount > 0)
+        transform.scale = sampleVector(channels[SCALE], findKey(channels[SCALE], normalizedTime), normalizedTime);
+
+    return transform;
+}
+
+elix::AnimationClip::Transform elix::AnimationClip::sample(size_t track, float time, Cursor &cursor) const
+{
+    const float normalizedTime = normalizeTime(time);
+    const auto& channels = m_tracks[track].channels;
+    uint32_t* hints = getHints(track, cursor);
+
+    Transform transform;
+
+    if (channels[TRANSLATION].keyCount > 0)
+        transform.translation = sampleVector(channels[TRANSLATION], findKey(channels[TRANSLATION], normalizedTime, hints[TRANSLATION]), normalizedTime);
+
+    if (channels[ROTATION].keyCount > 0)
+        transform.rotation = sampleRotation(channels[ROTATION], findKey(channels[ROTATION], normalizedTime, hints[ROTATION]), normalizedTime);
+
+    if (channels[SCALE].keyCount > 0)
+        transform.scale = sampleVector(channels[SCALE], findKey(channels[SCALE], normalizedTime, hints[SCALE]), normalizedTime);
+
+    return transform;
+}
+
+void elix::AnimationClip::sampleKeys(size_t track, float time, Cursor &cursor, Transform &start, Transform &end, glm::vec3 &factors) const
+{
+    const float normalizedTime = normalizeTime(time);
+    const auto& channels = m_tracks[track].channels;
+    uint32_t* hints = getHints(track, cursor);
+
+    start = end = Transform{};
+    factors = glm::vec3(0.0f);
+
+    //The next key is the same one at the end of a channel, the factor stays zero then
+    const auto getNextKey = [](const ChannelRange& channel, uint32_t key) {return key + 1 < channel.firstKey + channel.keyCount ? key + 1 : key;};
+
+    if (const auto& channel = channels[TRANSLATION]; channel.keyCount > 0)
+    {
+        const uint32_t key = findKey(channel, normalizedTime, hints[TRANSLATION]);
+        const uint32_t nextKey = getNextKey(channel, key);
+
+        start.translation = dequantizeVector(&m_keyValues[key * 3], channel.rangeMin, channel.rangeExtent);
+        end.translation = dequantizeVector(&m_keyValues[nextKey * 3], channel.rangeMin, channel.rangeExtent);
+        factors[TRANSLATION] = nextKey != key ? getInterpolation(key, normalizedTime) : 0.0f;
+    }
+
+    if (const auto& channel = channels[ROTATION]; channel.keyCount > 0)
+    {
+        const uint32_t key = findKey(channel, normalizedTime, hints[ROTATION]);
+        const uint32_t nextKey = getNextKey(channel, key);
+
+        start.rotation = dequantizeRotation(&m_keyValues[key * 3]);
+        end.rotation = dequantizeRotation(&m_keyValues[nextKey * 3]);
+        factors[ROTATION] = nextKey != key ? getInterpolation(key, normalizedTime) : 0.0f;
+    }
+
+    if (const auto& channel = channels[SCALE]; channel.keyCount > 0)
+    {
+        const uint32_t key = findKey(channel, normalizedTime, hints[SCALE]);
+        const uint32_t nextKey = getNextKey(channel, key);
+
+        start.scale = dequantizeVector(&m_keyValues[key * 3], channel.rangeMin, channel.rangeExtent);
+        end.scale = dequantizeVector(&m_keyValues[nextKey * 3], channel.rangeMin, channel.rangeExtent);
+        factors[SCALE] = nextKey != key ? getInterpolation(key, normalizedTime) : 0.0f;
+    }
+}
+
+int elix::AnimationClip::findTrack(const std::string &name) const
+{
+    const auto it = std::ranges::find(m_trackNames, name);
+    return it == m_trackNames.end() ? -1 : static_cast<int>(it - m_trackNames.begin());
+}
+
+size_t elix::AnimationClip::getTrackCount() const
+{
+    return m_tracks.size();
+}
+
+const std::string & elix::AnimationClip::getTrackName(size_t track) const
+{
+    return m_trackNames[track];
+}
+
+const std::string & elix::AnimationClip::getName() const
+{
+    return m_name;
+}
+
+float elix::AnimationClip::getDuration() const
+{
+    return m_duration;
+}
+
+float elix::AnimationClip::getTicksPerSecond() const
+{
+    return m_ticksPerSecond;
+}
+
+size_t elix::AnimationClip::getKeyCount() const
+{
+    return m_keyTimes.size();
+}
+
+size_t elix::AnimationClip::getMemorySize() const
+{
+    size_t size = sizeof(AnimationClip) + m_name.capacity() + m_tracks.capacity() * sizeof(Track) + m_keyTimes.capacity() * sizeof(uint16_t) +
+                  m_keyValues.capacity() * sizeof(uint16_t) + m_trackNames.capacity() * sizeof(std::string);
+
+    for (const auto& trackName : m_trackNames)
+        size += trackName.capacity();
+
+    return size;
+}
+
+uint32_t * elix::AnimationClip::getHints(size_t track, Cursor &cursor) const
+{
+    if (cursor.clip != this)
+    {
+        cursor.clip = this;
+        cursor.keys.assign(m_tracks.size() * CHANNEL_COUNT, 0);
+
+        for (size_t index = 0; index < m_tracks.size(); ++index)
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel)
+                cursor.keys[index * CHANNEL_COUNT + channel] = m_tracks[index].channels[channel].firstKey;
+    }
+
+    return &cursor.keys[track * CHANNEL_COUNT];
+}
+
+float elix::AnimationClip::normalizeTime(float time) const
+{
+    return m_duration > 0.0f ? std::clamp(time / m_duration, 0.0f, 1.0f) * MAX_QUANTIZED : 0.0f;
+}
+
+glm::vec3 elix::AnimationClip::sampleVector(const ChannelRange &channel, uint32_t key, float normalizedTime) const
+{
+    const glm::vec3 start = dequantizeVector(&m_keyValues[key * 3], channel.rangeMin, channel.rangeExtent);
+
+    if (key + 1 == channel.firstKey + channel.keyCount)
+        return start;
+
+    const glm::vec3 end = dequantizeVector(&m_keyValues[(key + 1) * 3], channel.rangeMin, channel.rangeExtent);
+
+    return start + (end - start) * getInterpolation(key, normalizedTime);
+}
+
+glm::quat elix::AnimationClip::sampleRotation(const ChannelRange &channel, uint32_t key, float normalizedTime) const
+{
+    const glm::quat start = dequantizeRotation(&m_keyValues[key * 3]);
+
+    if (key + 1 == channel.firstKey + channel.keyCount)
+        return start;
+
+    return nlerp(start, dequantizeRotation(&m_keyValues[(key + 1) * 3]), getInterpolation(key, normalizedTime));
+}
+
+float elix::AnimationClip::getInterpolation(uint32_t key, float normalizedTime) const
+{
+    const float startTime = m_keyTimes[key];
+    const float span = static_cast<float>(m_keyTimes[key + 1]) - startTime;
+
+    return span > 0.0f ? std::clamp((normalizedTime - startTime) / span, 0.0f, 1.0f) : 0.0f;
+}
+
+uint32_t elix::AnimationClip::findKey(const ChannelRange &channel, float normalizedTime) const
+{
+    const auto begin = m_keyTimes.begin() + channel.firstKey;
+    const auto end = begin + channel.keyCount;
+    const auto it = std::upper_bound(begin, end, normalizedTime, [](float time, uint16_t keyTime) {return time < static_cast<float>(keyTime);});
+
+    return it == begin ? channel.firstKey : static_cast<uint32_t>(it - m_keyTimes.begin()) - 1;
+}
+
+uint32_t elix::AnimationClip::findKey(const ChannelRange &channel, float normalizedTime, uint32_t &hint) const
+{
+    const uint32_t lastKey = channel.firstKey + channel.keyCount - 1;
+    uint32_t key = hint;
+
+    if (key >= channel.firstKey && key <= lastKey && (key == channel.firstKey || static_cast<float>(m_keyTimes[key]) <= normalizedTime))
+    {
+        //Frame steps rarely cross more than one key, anything further is treated as a seek
+        if (key < lastKey && static_cast<float>(m_keyTimes[key + 1]) <= normalizedTime)
+            ++key;
+
+        if (key == lastKey || normalizedTime < static_cast<float>(m_keyTimes[key + 1]))
+            return hint = key;
+    }
+
+    return hint = findKey(channel, normalizedTime);
+}
@@ -0,0 +1,294 @@
+#include "AnimationSystem.hpp"
+
+#include "AnimatorComponent.hpp"
+#include "GameObject.hpp"
+#include "Logger.hpp"
+#include "Simd.hpp"
+#include "Skeleton.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    bool g_isBatchingEnabled{true};
+
+    //SoA rows of one batch: both keys and factors going in, the 3x4 part of the local matrix coming out
+    enum BatchRow : size_t
+    {
+        START_TRANSLATION_X, START_TRANSLATION_Y, START_TRANSLATION_Z,
+        END_TRANSLATION_X, END_TRANSLATION_Y, END_TRANSLATION_Z,
+        START_ROTATION_X, START_ROTATION_Y, START_ROTATION_Z, START_ROTATION_W,
+        END_ROTATION_X, END_ROTATION_Y, END_ROTATION_Z, END_ROTATION_W,
+        START_SCALE_X, START_SCALE_Y, START_SCALE_Z,
+        END_SCALE_X, END_SCALE_Y, END_SCALE_Z,
+        TRANSLATION_FACTOR, ROTATION_FACTOR, SCALE_FACTOR,
+        //Column major, the translation is the last column
+        OUT_00, OUT_01, OUT_02,
+        OUT_10, OUT_11, OUT_12,
+        OUT_20, OUT_21, OUT_22,
+        OUT_30, OUT_31, OUT_32,
+        BATCH_ROW_COUNT
+    };
+
+    struct Batch
+    {
+        std::vector<float> data;
+        size_t stride{0};
+
+        void resize(size_t count)
+        {
+            stride = (count + elix::simd::WIDTH - 1) / elix::simd::WIDTH * elix::simd::WIDTH;
+            data.resize(stride * BATCH_ROW_COUNT);
+        }
+
+        float* row(BatchRow batchRow) { return data.data() + batchRow * stride; }
+
+        void write(size_t lane, const elix::AnimationClip::Transform& start, const elix::AnimationClip::Transform& end, const glm::vec3& factors)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                row(static_cast<BatchRow>(START_TRANSLATION_X + i))[lane] = start.translation[i];
+                row(static_cast<BatchRow>(END_TRANSLATION_X + i))[lane] = end.translation[i];
+                row(static_cast<BatchRow>(START_SCALE_X + i))[lane] = start.scale[i];
+                row(static_cast<BatchRow>(END_SCALE_X + i))[lane] = end.scale[i];
+            }
+
+            const float startRotation[4]{start.rotation.x, start.rotation.y, start.rotation.z, start.rotation.w};
+            const float endRotation[4]{end.rotation.x, end.rotation.y, end.rotation.z, end.rotation.w};
+
+            for (int i = 0; i < 4; ++i)
+            {
+                row(static_cast<BatchRow>(START_ROTATION_X + i))[lane] = startRotation[i];
+                row(static_cast<BatchRow>(END_ROTATION_X + i))[lane] = endRotation[i];
+            }
+
+            row(TRANSLATION_FACTOR)[lane] = factors.x;
+            row(ROTATION_FACTOR)[lane] = factors.y;
+            row(SCALE_FACTOR)[lane] = factors.z;
+        }
+    };
+
+    //Every worker keeps its own scratch across frames
+    thread_local Batch g_batch;
+
+    //Lerp translation and scale, nlerp rotation, then T * R * S
+    void interpolateBatch(Batch& batch)
+    {
+        using namespace elix::simd;
+
+        const Float one = set(1.0f);
+        const Float two = set(2.0f);
+
+        for (size_t lane = 0; lane < batch.stride; lane += WIDTH)
+        {
+            const auto in = [&batch, lane](BatchRow row) { return load(batch.row(row) + lane); };
+            const auto out = [&batch, lane](BatchRow row, Float value) { store(batch.row(row) + lane, value); };
+
+            const Float translationFactor = in(TRANSLATION_FACTOR);
+            const Float rotationFactor = in(ROTATION_FACTOR);
+            const Float scaleFactor = in(SCALE_FACTOR);
+
+            //Shortest arc: flip the end rotation into the start's hemisphere
+            const Float startX = in(START_ROTATION_X), startY = in(START_ROTATION_Y), startZ = in(START_ROTATION_Z), startW = in(START_ROTATION_W);
+            Float endX = in(END_ROTATION_X), endY = in(END_ROTATION_Y), endZ = in(END_ROTATION_Z), endW = in(END_ROTATION_W);
+
+            const Float hemisphere = sign(add(add(mul(startX, endX), mul(startY, endY)), add(mul(startZ, endZ), mul(startW, endW))));
+            endX = mul(endX, hemisphere);
+            endY = mul(endY, hemisphere);
+            endZ = mul(endZ, hemisphere);
+            endW = mul(endW, hemisphere);
+
+            Float x = lerp(startX, endX, rotationFactor);
+            Float y = lerp(startY, endY, rotationFactor);
+            Float z = lerp(startZ, endZ, rotationFactor);
+            Float w = lerp(startW, endW, rotationFactor);
+
+            const Float inverseLength = div(one, sqrt(add(add(mul(x, x), mul(y, y)), add(mul(z, z), mul(w, w)))));
+            x = mul(x, inverseLength);
+            y = mul(y, inverseLength);
+            z = mul(z, inverseLength);
+            w = mul(w, inverseLength);
+
+            const Float xx = mul(x, x), yy = mul(y, y), zz = mul(z, z);
+            const Float xy = mul(x, y), xz = mul(x, z), yz = mul(y, z);
+            const Float wx = mul(w, x), wy = mul(w, y), wz = mul(w, z);
+
+            const Float scaleX = lerp(in(START_SCALE_X), in(END_SCALE_X), scaleFactor);
+            const Float scaleY = lerp(in(START_SCALE_Y), in(END_SCALE_Y), scaleFactor);
+            const Float scaleZ = lerp(in(START_SCALE_Z), in(END_SCALE_Z), scaleFactor);
+
+            out(OUT_00, mul(sub(one, mul(two, add(yy, zz))), scaleX));
+            out(OUT_01, mul(mul(two, add(xy, wz)), scaleX));
+            out(OUT_02, mul(mul(two, sub(xz, wy)), scaleX));
+
+            out(OUT_10, mul(mul(two, sub(xy, wz)), scaleY));
+            out(OUT_11, mul(sub(one, mul(two, add(xx, zz))), scaleY));
+            out(OUT_12, mul(mul(two, add(yz, wx)), scaleY));
+
+            out(OUT_20, mul(mul(two, add(xz, wy)), scaleZ));
+            out(OUT_21, mul(mul(two, sub(yz, wx)), scaleZ));
+            out(OUT_22, mul(sub(one, mul(two, add(xx, yy))), scaleZ));
+
+            out(OUT_30, lerp(in(START_TRANSLATION_X), in(END_TRANSLATION_X), translationFactor));
+            out(OUT_31, lerp(in(START_TRANSLATION_Y), in(END_TRANSLATION_Y), translationFactor));
+            out(OUT_32, lerp(in(START_TRANSLATION_Z), in(END_TRANSLATION_Z), translationFactor));
+        }
+    }
+} //namespace
+
+void elix::AnimationSystem::update(const std::vector<std::shared_ptr<GameObject>> &objects)
+{
+    std::vector<AnimatorComponent*> animators;
+
+    for (const auto& object : objects)
+        if (const auto animator = object->getComponent<AnimatorComponent>(); animator && animator->hasPendingPose())
+            animators.push_back(animator);
+
+    ThreadPool::instance().parallelFor(animators.size(), [&animators](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+            animators[index]->samplePose();
+    });
+}
+
+void elix::AnimationSystem::bind(common::Animation &animation)
+{
+    if (animation.boundSkeleton == animation.skeletonForAnimation || !animation.skeletonForAnimation)
+        return;
+
+    animation.boneTracks = animation.skeletonForAnimation->bindTracks(animation.clip);
+    animation.boundSkeleton = animation.skeletonForAnimation;
+}
+
+void elix::AnimationSystem::samplePose(const common::Animation &animation, float time, Pose &pose)
+{
+    const auto* skeleton = animation.skeletonForAnimation;
+    const auto& bindTransforms = skeleton->getLocalBindTransforms();
+    const size_t boneCount = bindTransforms.size();
+
+    pose.localTransforms.resize(boneCount);
+    pose.modelTransforms.resize(boneCount);
+
+    if (pose.finalMatrices.size() != boneCount)
+        pose.finalMatrices = skeleton->getBindPoses();
+
+    Batch& batch = g_batch;
+    batch.resize(boneCount);
+
+    const AnimationClip::Transform identity;
+    AnimationClip::Transform start;
+    AnimationClip::Transform end;
+    glm::vec3 factors;
+
+    //Untracked bones and the padding go through the kernel as identity so no lane divides by zero
+    for (size_t index = 0; index < batch.stride; ++index)
+    {
+        if (index < boneCount && animation.boneTracks[index] >= 0)
+        {
+            animation.clip.sampleKeys(animation.boneTracks[index], time, pose.cursor, start, end, factors);
+            batch.write(index, start, end, factors);
+        }
+        else
+            batch.write(index, identity, identity, glm::vec3(0.0f));
+    }
+
+    interpolateBatch(batch);
+
+    for (size_t index = 0; index < boneCount; ++index)
+    {
+        glm::mat4& local = pose.localTransforms[index];
+
+        if (animation.boneTracks[index] < 0)
+        {
+            local = bindTransforms[index];
+            continue;
+        }
+
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 3; ++row)
+                local[column][row] = batch.row(static_cast<BatchRow>(OUT_00 + column * 3 + row))[index];
+
+            local[column][3] = column == 3 ? 1.0f : 0.0f;
+        }
+    }
+
+    skeleton->evaluatePose(pose.localTransforms, pose.modelTransforms, pose.finalMatrices);
+}
+
+elix::AnimationSystem::BenchmarkResult elix::AnimationSystem::benchmark(common::Animation &animation, size_t characterCount, size_t frameCount)
+{
+    BenchmarkResult result;
+
+    if (!animation.skeletonForAnimation || characterCount == 0 || frameCount == 0)
+    {
+        ELIX_LOG_WARN("Animation benchmark needs a skeletal animation and at least one character and frame");
+        return result;
+    }
+
+    bind(animation);
+
+    const float duration = animation.clip.getDuration();
+    const float frameTicks = animation.clip.getTicksPerSecond() / 60.0f;
+
+    std::vector<Pose> poses(characterCount);
+    auto& pool = ThreadPool::instance();
+
+    const auto poseFrame = [&](size_t frame)
+    {
+        pool.parallelFor(characterCount, [&](size_t begin, size_t end)
+        {
+            for (size_t character = begin; character < end; ++character)
+            {
+                const float phase = duration * static_cast<float>(character) / static_cast<float>(characterCount);
+                const float time = duration > 0.0f ? std::fmod(phase + static_cast<float>(frame) * frameTicks, duration) : 0.0f;
+                samplePose(animation, time, poses[character]);
+            }
+        });
+    };
+
+    //Sizes the buffers and the cursors outside the measurement
+    poseFrame(0);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t frame = 1; frame <= frameCount; ++frame)
+        poseFrame(frame);
+
+    const auto end = std::chrono::steady_clock::now();
+
+    result.characterCount = characterCount;
+    result.boneCount = animation.skeletonForAnimation->getBonesCount();
+    result.frameCount = frameCount;
+    result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    result.bonesPerMillisecond = result.milliseconds > 0.0 ? static_cast<double>(characterCount * result.boneCount * frameCount) / result.milliseconds : 0.0;
+
+    return result;
+}
+
+void elix::AnimationSystem::runBenchmarks(common::Animation &animation)
+{
+    for (const size_t characterCount : {size_t{1}, size_t{100}, size_t{1000}})
+    {
+        const auto result = benchmark(animation, characterCount);
+
+        if (result.frameCount == 0)
+            return;
+
+        ELIX_LOG_INFO("Animation benchmark ", animation.name, ": ", result.characterCount, " characters x ", result.boneCount, " bones, ",
+                      result.milliseconds / static_cast<double>(result.frameCount), " ms per frame, ", result.bonesPerMillisecond, " bones/ms on ",
+                      ThreadPool::instance().getThreadsCount(), " threads, simd width ", simd::WIDTH);
+    }
+}
+
+void elix::AnimationSystem::setBatchingEnabled(bool isEnabled)
+{
+    g_isBatchingEnabled = isEnabled;
+}
+
+bool elix::AnimationSystem::isBatchingEnabled()
+{
+    return g_isBatchingEnabled;
+}
@@ -6,7 +6,11 @@
 #include "Utilities.hpp"
 #include "Skeleton.hpp"
 
-AnimatorComponent::AnimatorComponent() = default;
+AnimatorComponent::AnimatorComponent()
+{
+    //Distant characters animate at 10 Hz
+    setTickBudget({10.0f, 0.5f});
+}
 
 void AnimatorComponent::update(float deltaTime)
 {
@@ -45,8 +49,14 @@ void AnimatorComponent::update(float deltaTime)
 
     if (m_currentAnimation->skeletonForAnimation)
     {
-        const auto parent = m_currentAnimation->skeletonForAnimation->getParent();
-        calculateBoneTransform(parent, glm::mat4(1.0f), m_currentAnimation, m_currentTime);
+        elix::AnimationSystem::bind(*m_currentAnimation);
+
+        //Off screen characters keep their clock running but nobody sees their bones
+        const auto* owner = getOwner();
+        m_hasPendingPose = !owner || owner->getSignificance().isVisible;
+
+        if (!elix::AnimationSystem::isBatchingEnabled())
+            samplePose();
     }
     else if (m_currentAnimation->gameObject)
     {
@@ -59,20 +69,9 @@ void AnimatorComponent::update(float deltaTime)
 
 void AnimatorComponent::calculateObjectTransform(common::Animation *animation, float currentTime)
 {
-    if (auto track = animation->getAnimationTrack("door"))
+    if (const int track = animation->clip.findTrack("door"); track >= 0)
     {
-        auto [startFrame, endFrame] = utilities::findKeyframes(track->keyFrames, currentTime);
-
-        if (!startFrame || !endFrame)
-            return;
-
-        float deltaTime = endFrame->timeStamp - startFrame->timeStamp;
-        float t = (deltaTime == 0) ? 0.0f : (currentTime - startFrame->timeStamp) / deltaTime;
-        t = glm::clamp(t, 0.0f, 1.0f);
-
-        glm::vec3 position = utilities::interpolate(startFrame->position, endFrame->position, t);
-        glm::quat rotation = glm::normalize(glm::slerp(startFrame->rotation, endFrame->rotation, t));
-        glm::vec3 scale = utilities::interpolate(startFrame->scale, endFrame->scale, t);
+        auto [position, rotation, scale] = animation->clip.sample(track, currentTime, m_pose.cursor);
 
         auto* gameObject = animation->gameObject;
 
@@ -105,6 +104,12 @@ void AnimatorComponent::playAnimation(common::Animation *animation, const bool r
 {
     m_isAnimationLooped = repeat;
 
+    if (animation && animation->skeletonForAnimation && m_pose.finalMatrices.empty())
+    {
+        m_pose.finalMatrices = animation->skeletonForAnimation->getBindPoses();
+        ++m_poseVersion;
+    }
+
     if (!m_currentAnimation) {
         m_currentAnimation = animation;
         return;
@@ -130,49 +135,37 @@ void AnimatorComponent::stopAnimation()
     m_currentAnimation = nullptr;
 }
 
-void AnimatorComponent::calculateBoneTransform(common::BoneInfo *boneInfo, const glm::mat4 &parentTransform, common::Animation *animation, const float currentTime)
+void AnimatorComponent::samplePose()
 {
-    std::string nodeName = boneInfo->name;
-    glm::mat4 boneTransform = boneInfo->offsetMatrix;
-
-    if (const auto* boneAnimation = animation->getAnimationTrack(nodeName))
-    {
-        auto [startFrame, endFrame] = utilities::findKeyframes(boneAnimation->keyFrames, currentTime);
-
-        if (!startFrame || !endFrame)
-            return;
-
-        float deltaTime = endFrame->timeStamp - startFrame->timeStamp;
-        float t = (deltaTime == 0) ? 0.0f : (currentTime - startFrame->timeStamp) / deltaTime;
-        t = glm::clamp(t, 0.0f, 1.0f);
-
-        const glm::vec3 position = utilities::interpolate(startFrame->position, endFrame->position, t);
-        const glm::quat rotation = glm::normalize(glm::slerp(startFrame->rotation, endFrame->rotation, t));
-        const glm::vec3 scale = utilities::interpolate(startFrame->scale, endFrame->scale, t);
+    if (!m_hasPendingPose || !m_currentAnimation)
+        return;
 
-        boneTransform = glm::translate(glm::mat4(1.0f), position) *
-                    glm::toMat4(rotation) *
-                    glm::scale(glm::mat4(1.0f), scale);
-    }
+    elix::AnimationSystem::samplePose(*m_currentAnimation, m_currentTime, m_pose);
+    m_hasPendingPose = false;
+    ++m_poseVersion;
+}
 
-    glm::mat4 globalTransformation = parentTransform * boneTransform;
+bool AnimatorComponent::hasPendingPose() const
+{
+    return m_hasPendingPose;
+}
 
-    auto* skeleton = animation->skeletonForAnimation;
+bool AnimatorComponent::isAnimationPlaying() const
+{
+    return m_currentAnimation != nullptr;
+}
 
-    if (const auto bone = skeleton->getBone(nodeName))
-    {
-        glm::mat4 offset = bone->offsetMatrix;
-        boneInfo->finalTransformation = globalTransformation * offset;
-    }
+const std::vector<glm::mat4>& AnimatorComponent::getFinalMatrices() const
+{
+    return m_pose.finalMatrices;
+}
 
-    for (const auto& i : boneInfo->children)
-    {
-        const auto child = skeleton->getBone(i);
-        calculateBoneTransform(child, globalTransformation, animation, currentTime);
-    }
+const std::vector<glm::mat4>& AnimatorComponent::getModelTransforms() const
+{
+    return m_pose.modelTransforms;
 }
 
-bool AnimatorComponent::isAnimationPlaying() const
+uint32_t AnimatorComponent::getPoseVersion() const
 {
-    return m_currentAnimation != nullptr;
+    return m_poseVersion;
 }
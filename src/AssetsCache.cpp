@@ -1,7 +1,343 @@
 #include "AssetsCache.hpp"
 
+#include "AssetsLoader.hpp"
+#include "ThreadPool.hpp"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace
+{
+    template<typename T>
+    elix::AssetHandle<T> addTypedAsset(elix::AssetStorage<T>& storage, const std::string& path, std::unique_ptr<elix::Asset> asset)
+    {
+        return storage.add(path, std::unique_ptr<T>(static_cast<T*>(asset.release())));
+    }
+
+    //Same binding loadCookedModel does when it is given the cache
+    void bindMaterialSlots(elix::Model& model, const elix::AssetsCache& cache)
+    {
+        for (size_t meshIndex = 0; meshIndex < model.getNumMeshes(); ++meshIndex)
+        {
+            auto* mesh = model.getMesh(static_cast<int>(meshIndex));
+
+            if (mesh->getMaterial() || mesh->getMaterialSlot().empty())
+                continue;
+
+            if (const auto material = cache.findAsset<elix::AssetMaterial>(mesh->getMaterialSlot()))
+                mesh->setMaterial(material->getMaterial());
+        }
+    }
+
+    struct EvictionCandidate
+    {
+        uint64_t lastUsed;
+        size_t bytes;
+        std::function<void()> evict;
+    };
+
+    template<typename T>
+    void collectEvictionCandidates(elix::AssetStorage<T>& storage, std::vector<EvictionCandidate>& candidates)
+    {
+        storage.forEach([&storage, &candidates](elix::AssetHandle<T> handle, T* asset)
+        {
+            if (storage.getReferences(handle) == 0)
+                candidates.push_back({storage.getLastUsed(handle), asset->getMemoryUsage().total(), [&storage, handle] { storage.evict(handle); }});
+        });
+    }
+
+    template<typename T>
+    elix::Asset::MemoryUsage getStorageMemoryUsage(const elix::AssetStorage<T>& storage)
+    {
+        elix::Asset::MemoryUsage usage;
+        storage.forEach([&usage](elix::AssetHandle<T>, T* asset) { usage += asset->getMemoryUsage(); });
+        return usage;
+    }
+} //namespace
+
 elix::Asset* elix::AssetsCache::addAsset(const std::string &path, std::unique_ptr<elix::Asset> asset)
 {
-    m_assets[path] = std::move(asset);
-    return m_assets[path].get();
+    if (!asset)
+        return nullptr;
+
+    elix::Asset* result{nullptr};
+
+    switch (asset->getType())
+    {
+        case AssetType::Model:
+        {
+            auto& storage = std::get<AssetStorage<AssetModel>>(m_storages);
+            const auto handle = addTypedAsset(storage, path, std::move(asset));
+            const auto modelAsset = storage.get(handle);
+
+            //Cooked models are looked up by the name of the model they were cooked from
+            if (const auto model = modelAsset->getModel())
+                storage.addName(model->getName(), handle.index);
+
+            storage.touch(handle, ++m_accessTick);
+            result = modelAsset;
+            break;
+        }
+        case AssetType::Texture:
+        {
+            auto& storage = std::get<AssetStorage<AssetTexture>>(m_storages);
+            const auto handle = addTypedAsset(storage, path, std::move(asset));
+            storage.touch(handle, ++m_accessTick);
+            result = storage.get(handle);
+            break;
+        }
+        case AssetType::Material:
+        {
+            auto& storage = std::get<AssetStorage<AssetMaterial>>(m_storages);
+
+            if (storage.isReplaceable(path))
+            {
+                acquireDependencies(static_cast<AssetMaterial*>(asset.get()));
+
+                //Replacing a cached material drops the references its previous version held
+                releaseDependencies(storage.get(storage.find(path)));
+            }
+
+            const auto handle = addTypedAsset(storage, path, std::move(asset));
+            storage.touch(handle, ++m_accessTick);
+            result = storage.get(handle);
+            break;
+        }
+        case AssetType::Animation:
+        {
+            auto& storage = std::get<AssetStorage<AssetAnimation>>(m_storages);
+            const auto handle = addTypedAsset(storage, path, std::move(asset));
+            storage.touch(handle, ++m_accessTick);
+            result = storage.get(handle);
+            break;
+        }
+        case AssetType::Custom:
+        default:
+            result = m_customAssets.get(m_customAssets.add(path, std::move(asset)));
+            break;
+    }
+
+    trim();
+
+    return result;
+}
+
+void elix::AssetsCache::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    trim();
+}
+
+size_t elix::AssetsCache::getMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+elix::Asset::MemoryUsage elix::AssetsCache::getMemoryUsage(AssetType type) const
+{
+    switch (type)
+    {
+        case AssetType::Model: return getStorageMemoryUsage(std::get<AssetStorage<AssetModel>>(m_storages));
+        case AssetType::Texture: return getStorageMemoryUsage(std::get<AssetStorage<AssetTexture>>(m_storages));
+        case AssetType::Material: return getStorageMemoryUsage(std::get<AssetStorage<AssetMaterial>>(m_storages));
+        case AssetType::Animation: return getStorageMemoryUsage(std::get<AssetStorage<AssetAnimation>>(m_storages));
+        case AssetType::Custom:
+        default: return getStorageMemoryUsage(m_customAssets);
+    }
+}
+
+elix::Asset::MemoryUsage elix::AssetsCache::getMemoryUsage() const
+{
+    Asset::MemoryUsage usage;
+
+    for (const auto type : {AssetType::Model, AssetType::Texture, AssetType::Material, AssetType::Animation, AssetType::Custom})
+        usage += getMemoryUsage(type);
+
+    return usage;
+}
+
+void elix::AssetsCache::trim()
+{
+    if (m_memoryBudget == 0)
+        return;
+
+    size_t residentBytes = getMemoryUsage().total();
+
+    if (residentBytes <= m_memoryBudget)
+        return;
+
+    //Materials point at their textures and are cheap, custom assets are opaque to the cache. Neither is evicted.
+    //Animations aren't either, no loader brings one back and animators hold them by raw pointer
+    std::vector<EvictionCandidate> candidates;
+    collectEvictionCandidates(std::get<AssetStorage<AssetModel>>(m_storages), candidates);
+    collectEvictionCandidates(std::get<AssetStorage<AssetTexture>>(m_storages), candidates);
+
+    //The asset touched last is the one the caller is about to use, it is never evicted here
+    std::erase_if(candidates, [this](const EvictionCandidate& candidate) { return candidate.lastUsed == m_accessTick; });
+    std::ranges::sort(candidates, {}, &EvictionCandidate::lastUsed);
+
+    size_t evictedCount = 0;
+    size_t evictedBytes = 0;
+
+    for (auto& candidate : candidates)
+    {
+        if (residentBytes <= m_memoryBudget)
+            break;
+
+        candidate.evict();
+
+        residentBytes -= std::min(residentBytes, candidate.bytes);
+        evictedBytes += candidate.bytes;
+        ++evictedCount;
+    }
+
+    ELIX_LOG_INFO("Evicted ", evictedCount, " assets (", evictedBytes / 1024, " KB) to fit the ", m_memoryBudget / 1024, " KB budget");
+
+    if (residentBytes > m_memoryBudget)
+        ELIX_LOG_WARN("Referenced assets alone exceed the memory budget");
+}
+
+std::unique_ptr<elix::Asset> elix::AssetsCache::loadFromPath(const std::string &path)
+{
+    return elix::AssetsLoader::loadAsset(path, this);
+}
+
+void elix::AssetsCache::acquireDependencies(const AssetMaterial *material)
+{
+    if (!material)
+        return;
+
+    for (const auto texture : material->getTextureDependencies())
+        acquire(texture);
+}
+
+void elix::AssetsCache::releaseDependencies(const AssetMaterial *material)
+{
+    if (!material)
+        return;
+
+    for (const auto texture : material->getTextureDependencies())
+        release(texture);
+}
+
+std::vector<elix::Asset*> elix::AssetsCache::importAssets(const std::vector<std::string> &paths)
+{
+    struct DecodedAsset
+    {
+        std::string path;
+        std::unique_ptr<elix::Asset> asset;
+    };
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    //Nothing is evicted mid import, materials of this batch still have to find the textures of this batch
+    const size_t memoryBudget = std::exchange(m_memoryBudget, 0);
+
+    auto& pool = elix::ThreadPool::instance();
+
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    std::deque<DecodedAsset> readyAssets;
+
+    std::vector<std::string> immediatePaths;
+    std::vector<std::string> deferredPaths;
+
+    //Materials resolve their textures through the cache, so they are decoded after everything else is in it
+    for (const auto& path : paths)
+        (elix::AssetsLoader::requiresCache(path) ? deferredPaths : immediatePaths).push_back(path);
+
+    for (const auto& path : immediatePaths)
+        pool.submit([path, &readyMutex, &readyCondition, &readyAssets]()
+        {
+            std::unique_ptr<elix::Asset> asset;
+
+            //Every path has to report back, the loop below waits for exactly one result per path
+            try
+            {
+                asset = elix::AssetsLoader::decodeAsset(path);
+            }
+            catch (const std::exception& e)
+            {
+                ELIX_LOG_ERROR("Decoding ", path, " threw: ", e.what());
+            }
+
+            std::lock_guard<std::mutex> lock(readyMutex);
+            readyAssets.push_back({path, std::move(asset)});
+            readyCondition.notify_one();
+        });
+
+    std::vector<elix::Asset*> importedAssets;
+    importedAssets.reserve(paths.size());
+
+    for (size_t pendingCount = immediatePaths.size(); pendingCount > 0; --pendingCount)
+    {
+        DecodedAsset decoded;
+
+        {
+            std::unique_lock<std::mutex> lock(readyMutex);
+            readyCondition.wait(lock, [&readyAssets] { return !readyAssets.empty(); });
+            decoded = std::move(readyAssets.front());
+            readyAssets.pop_front();
+        }
+
+        if (!decoded.asset)
+        {
+            ELIX_LOG_WARN("Failed to load asset from ", decoded.path);
+            continue;
+        }
+
+        decoded.asset->bake();
+        importedAssets.push_back(addAsset(decoded.path, std::move(decoded.asset)));
+    }
+
+    //Second pass only reads the cache from the workers, nothing is added until every future is done
+    std::vector<std::future<std::unique_ptr<elix::Asset>>> deferredAssets;
+    deferredAssets.reserve(deferredPaths.size());
+
+    for (const auto& path : deferredPaths)
+        deferredAssets.push_back(pool.submit([this, path]() { return elix::AssetsLoader::decodeAsset(path, this); }));
+
+    std::vector<std::unique_ptr<elix::Asset>> decodedDeferred;
+    decodedDeferred.reserve(deferredAssets.size());
+
+    for (size_t i = 0; i < deferredAssets.size(); ++i)
+    {
+        try
+        {
+            decodedDeferred.push_back(deferredAssets[i].get());
+        }
+        catch (const std::exception& e)
+        {
+            ELIX_LOG_ERROR("Decoding ", deferredPaths[i], " threw: ", e.what());
+            decodedDeferred.emplace_back();
+        }
+    }
+
+    for (size_t i = 0; i < decodedDeferred.size(); ++i)
+    {
+        if (!decodedDeferred[i])
+        {
+            ELIX_LOG_WARN("Failed to load asset from ", deferredPaths[i]);
+            continue;
+        }
+
+        decodedDeferred[i]->bake();
+        importedAssets.push_back(addAsset(deferredPaths[i], std::move(decodedDeferred[i])));
+    }
+
+    //Models of the first pass were decoded without the cache, their slots are bound now that this batch's materials are in it
+    for (auto* asset : importedAssets)
+        if (asset && asset->getType() == AssetType::Model)
+            if (const auto model = static_cast<AssetModel*>(asset)->getModel())
+                bindMaterialSlots(*model, *this);
+
+    m_memoryBudget = memoryBudget;
+    trim();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    ELIX_LOG_INFO("Imported ", importedAssets.size(), "/", paths.size(), " assets in ", elapsed.count(), " ms on ", pool.getThreadsCount(), " threads");
+
+    return importedAssets;
 }
@@ -5,45 +5,352 @@
 #include <assimp/scene.h>
 
 #include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "ModelCooker.hpp"
+#include "TextureCooker.hpp"
+#include "TextureStreamer.hpp"
+#include "VertexFormat.hpp"
 #include "stb/stb_image.h"
 
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
 #include <filesystem>
 #include <json/json.hpp>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
 
 #include "Logger.hpp"
 #include "Utilities.hpp"
 
 std::unique_ptr<elix::Asset> elix::AssetsLoader::loadAsset(const std::string &filePath, elix::AssetsCache* cache)
 {
-    if (auto texture = loadTexture(filePath))
-        return texture;
+    auto asset = decodeAsset(filePath, cache);
 
-    if (auto model = loadModel(filePath))
-        return model;
-
-    if (cache)
-        if (auto material = loadMaterial(filePath, cache))
-            return material;
+    if (!asset)
+    {
+        ELIX_LOG_WARN("Failed to load asset from ", filePath);
+        return nullptr;
+    }
 
-    ELIX_LOG_WARN("Failed to load asset from %s", filePath.c_str());
+    asset->bake();
 
-    return nullptr;
+    return asset;
 }
 
-std::unique_ptr<elix::AssetTexture> elix::AssetsLoader::loadTexture(const std::string &filePath)
+namespace
 {
-    int width, height, channels;
+    constexpr size_t PROBE_HEADER_SIZE = 64;
+
+    bool startsWith(std::span<const unsigned char> header, std::string_view magic)
+    {
+        return header.size() >= magic.size() && std::memcmp(header.data(), magic.data(), magic.size()) == 0;
+    }
+
+    std::string getLowerCaseExtension(const std::string& filePath)
+    {
+        std::string extension = std::filesystem::path(filePath).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension;
+    }
+
+    //Same signatures stb_image checks in its *_test functions, without decoding anything
+    bool isImageHeader(std::span<const unsigned char> header)
+    {
+        return startsWith(header, "\x89PNG\r\n\x1a\n") ||
+               startsWith(header, "\xFF\xD8\xFF") ||
+               startsWith(header, "BM") ||
+               startsWith(header, "GIF87a") || startsWith(header, "GIF89a") ||
+               startsWith(header, "8BPS") ||
+               startsWith(header, "#?RADIANCE") || startsWith(header, "#?RGBE") ||
+               startsWith(header, "P5") || startsWith(header, "P6");
+    }
+
+    bool isJsonHeader(std::span<const unsigned char> header)
+    {
+        size_t position = startsWith(header, "\xEF\xBB\xBF") ? 3 : 0;
+
+        while (position < header.size() && std::isspace(header[position]))
+            ++position;
+
+        return position < header.size() && header[position] == '{';
+    }
+
+    const std::unordered_set<std::string>& getAssimpExtensions()
+    {
+        static const std::unordered_set<std::string> extensions = []()
+        {
+            std::unordered_set<std::string> result;
+            std::string list;
+
+            Assimp::Importer().GetExtensionList(list);
+
+            //Format is "*.3ds;*.obj;..."
+            std::stringstream stream(list);
 
-    if (stbi_load(filePath.c_str(), &width, &height, &channels, 0))
+            for (std::string extension; std::getline(stream, extension, ';');)
+                if (extension.size() > 1)
+                    result.insert(extension.substr(1));
+
+            return result;
+        }();
+
+        return extensions;
+    }
+
+    size_t getModelDecodedSize(const elix::Model* model)
     {
-        auto texture = std::make_unique<elix::Texture>(filePath);
-        ELIX_LOG_INFO("Loaded texture ", filePath.c_str());
-        return std::make_unique<elix::AssetTexture>(std::move(texture));
+        size_t size = 0;
+
+        for (size_t meshIndex = 0; meshIndex < model->getNumMeshes(); ++meshIndex)
+        {
+            const auto* mesh = const_cast<elix::Model*>(model)->getMesh(static_cast<int>(meshIndex));
+            size += mesh->getVertexData().size_bytes() + mesh->getIndexData().size_bytes();
+        }
+
+        return size;
+    }
+
+    std::function<bool(const std::string&)> matchesExtensions(std::vector<std::string> extensions)
+    {
+        return [extensions = std::move(extensions)](const std::string& extension)
+        {
+            return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+        };
     }
 
+    std::vector<elix::AssetsLoader::Loader>& getLoaders()
+    {
+        static std::vector<elix::AssetsLoader::Loader> loaders;
+        return loaders;
+    }
+
+    std::mutex& getLoadersMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    std::atomic<bool> g_optimizeMeshes{false};
+} //namespace
+
+void elix::AssetsLoader::setMeshOptimization(bool enabled)
+{
+    g_optimizeMeshes.store(enabled, std::memory_order_relaxed);
+}
+
+bool elix::AssetsLoader::isMeshOptimizationEnabled()
+{
+    return g_optimizeMeshes.load(std::memory_order_relaxed);
+}
+
+void elix::AssetsLoader::registerLoader(const Loader &loader)
+{
+    registerDefaultLoaders();
+
+    std::lock_guard<std::mutex> lock(getLoadersMutex());
+
+    //User loaders win over the built-in ones
+    getLoaders().insert(getLoaders().begin(), loader);
+}
+
+void elix::AssetsLoader::registerDefaultLoaders()
+{
+    static std::once_flag registered;
+
+    std::call_once(registered, []()
+    {
+        auto& loaders = getLoaders();
+
+        loaders.push_back({
+            "CookedModel",
+            matchesExtensions({elix::ModelCooker::EXTENSION}),
+            [](std::span<const unsigned char> header) { return header.size() >= sizeof(uint32_t) && *reinterpret_cast<const uint32_t*>(header.data()) == cooked::MODEL_MAGIC; },
+            [](const std::string& filePath, AssetsCache* cache, Asset::LoadStatistics&) -> std::unique_ptr<Asset>
+            {
+                //Mapped in place, nothing gets decoded
+                return loadCookedModel(filePath, cache);
+            },
+            false
+        });
+
+        loaders.push_back({
+            "CookedTexture",
+            matchesExtensions({elix::TextureCooker::EXTENSION}),
+            [](std::span<const unsigned char> header) { return header.size() >= sizeof(uint32_t) && *reinterpret_cast<const uint32_t*>(header.data()) == cooked::TEXTURE_MAGIC; },
+            [](const std::string& filePath, AssetsCache*, Asset::LoadStatistics&) -> std::unique_ptr<Asset>
+            {
+                //Levels are uploaded straight from the mapping, nothing gets decoded
+                return loadCookedTexture(filePath);
+            },
+            false
+        });
+
+        loaders.push_back({
+            "Texture",
+            matchesExtensions({".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd", ".hdr", ".pic", ".pgm", ".ppm", ".pnm"}),
+            [](std::span<const unsigned char> header) { return isImageHeader(header); },
+            [](const std::string& filePath, AssetsCache*, Asset::LoadStatistics& statistics) -> std::unique_ptr<Asset>
+            {
+                auto texture = loadTexture(filePath);
+
+                if (texture)
+                {
+                    const auto& data = texture->getTexture()->getTextureData();
+                    statistics.bytesDecoded = static_cast<size_t>(data.width) * data.height * data.numberOfChannels * (data.dataFloat ? sizeof(float) : 1);
+                }
+
+                return texture;
+            },
+            false
+        });
+
+        loaders.push_back({
+            "Model",
+            [](const std::string& extension) { return getAssimpExtensions().contains(extension); },
+            [](std::span<const unsigned char> header) { return startsWith(header, "glTF") || startsWith(header, "Kaydara FBX Binary"); },
+            [](const std::string& filePath, AssetsCache*, Asset::LoadStatistics& statistics) -> std::unique_ptr<Asset>
+            {
+                auto model = loadModel(filePath);
+
+                if (model)
+                    statistics.bytesDecoded = getModelDecodedSize(model->getModel());
+
+                return model;
+            },
+            false
+        });
+
+        loaders.push_back({
+            "Material",
+            matchesExtensions({".json", ".mat", ".material"}),
+            [](std::span<const unsigned char> header) { return isJsonHeader(header); },
+            [](const std::string& filePath, AssetsCache* cache, Asset::LoadStatistics& statistics) -> std::unique_ptr<Asset>
+            {
+                if (!cache)
+                    return nullptr;
+
+                auto material = loadMaterial(filePath, cache);
+
+                if (material)
+                    statistics.bytesDecoded = statistics.bytesRead;
+
+                return material;
+            },
+            true
+        });
+    });
+}
+
+const elix::AssetsLoader::Loader* elix::AssetsLoader::findLoader(const std::string &filePath, std::span<const unsigned char> header)
+{
+    registerDefaultLoaders();
+
+    std::lock_guard<std::mutex> lock(getLoadersMutex());
+
+    const auto& loaders = getLoaders();
+    const std::string extension = getLowerCaseExtension(filePath);
+
+    auto hasExtension = [&extension](const Loader& loader) { return loader.matchesExtension && loader.matchesExtension(extension); };
+
+    //Extension and header agree
+    for (const auto& loader : loaders)
+        if (hasExtension(loader) && loader.probe(header))
+            return &loader;
+
+    //Extension alone, for formats without magic bytes (tga, obj, gltf, ...)
+    for (const auto& loader : loaders)
+        if (hasExtension(loader))
+            return &loader;
+
+    //Header alone, for files with an unknown or missing extension
+    for (const auto& loader : loaders)
+        if (loader.probe(header))
+            return &loader;
+
     return nullptr;
 }
 
+bool elix::AssetsLoader::requiresCache(const std::string &filePath)
+{
+    std::array<unsigned char, PROBE_HEADER_SIZE> header{};
+
+    std::ifstream file(filePath, std::ios::binary);
+    file.read(reinterpret_cast<char*>(header.data()), header.size());
+
+    const auto* loader = findLoader(filePath, std::span<const unsigned char>(header.data(), static_cast<size_t>(file.gcount())));
+
+    return loader && loader->requiresCache;
+}
+
+std::unique_ptr<elix::Asset> elix::AssetsLoader::decodeAsset(const std::string &filePath, elix::AssetsCache* cache)
+{
+    std::array<unsigned char, PROBE_HEADER_SIZE> header{};
+
+    std::ifstream file(filePath, std::ios::binary);
+
+    if (!file.is_open())
+        return nullptr;
+
+    file.read(reinterpret_cast<char*>(header.data()), header.size());
+    const auto headerSize = static_cast<size_t>(file.gcount());
+    file.close();
+
+    const auto* loader = findLoader(filePath, std::span<const unsigned char>(header.data(), headerSize));
+
+    if (!loader)
+        return nullptr;
+
+    Asset::LoadStatistics statistics;
+    statistics.loader = loader->name;
+
+    //The probed header is part of the file, it is not counted twice
+    std::error_code errorCode;
+    const auto fileSize = std::filesystem::file_size(filePath, errorCode);
+    statistics.bytesRead = errorCode ? 0 : static_cast<size_t>(fileSize);
+
+    auto asset = loader->decode(filePath, cache, statistics);
+
+    if (!asset)
+        return nullptr;
+
+    asset->setLoadStatistics(statistics);
+
+    ELIX_LOG_INFO("Decoded ", filePath, " with ", statistics.loader, " loader: read ", statistics.bytesRead, " bytes, decoded ", statistics.bytesDecoded, " bytes");
+
+    return asset;
+}
+
+std::unique_ptr<elix::AssetTexture> elix::AssetsLoader::loadTexture(const std::string &filePath)
+{
+    auto texture = std::make_unique<elix::Texture>(filePath);
+
+    if (!texture->getTextureData().data && !texture->getTextureData().dataFloat)
+        return nullptr;
+
+    ELIX_LOG_INFO("Loaded texture ", filePath.c_str());
+
+    return std::make_unique<elix::AssetTexture>(std::move(texture));
+}
+
+std::unique_ptr<elix::AssetTexture> elix::AssetsLoader::loadCookedTexture(const std::string &filePath)
+{
+    auto texture = std::make_unique<elix::Texture>();
+
+    elix::Texture::TextureParams params;
+    params.flipVertically = false;
+    params.streamMips = elix::TextureStreamer::instance().getMemoryBudget() > 0;
+
+    if (!texture->loadCooked(filePath, &params))
+        return nullptr;
+
+    ELIX_LOG_INFO("Loaded cooked texture ", filePath.c_str());
+
+    return std::make_unique<elix::AssetTexture>(std::move(texture));
+}
 
 void generateBoneHierarchy(const int parentId, const aiNode* src, Skeleton* skeleton, const glm::mat4& parentTransform)
 {
@@ -66,7 +373,7 @@ void generateBoneHierarchy(const int parentId, const aiNode* src, Skeleton* skel
         // If the bone isn't in the skeleton, create a new one to preserve hierarchy
         boneID = skeleton->getBonesCount();
 
-        common::BoneInfo newBone(nodeName, boneID, utilities::convertMatrixToGLMFormat(src->mTransformation), glm::mat4(1.0f));
+        common::BoneInfo newBone(nodeName, boneID, utilities::convertMatrixToGLMFormat(src->mTransformation));
 
         boneID = skeleton->addBone(newBone);
     }
@@ -79,7 +386,6 @@ void generateBoneHierarchy(const int parentId, const aiNode* src, Skeleton* skel
     {
         currentBone->parentId = parent->id;
         parent->children.push_back(boneID);
-        parent->childrenInfo.push_back(currentBone);
     }
 
     for (unsigned int i = 0; i < src->mNumChildren; i++)
@@ -95,10 +401,15 @@ void assignLocalBindTransforms(aiNode* node, Skeleton* skeleton)
         assignLocalBindTransforms(node->mChildren[i], skeleton);
 }
 
-elix::Mesh processMesh(aiMesh* mesh, const aiScene* const scene, Skeleton* skeleton)
+common::MeshData processMesh(aiMesh* mesh, const aiScene* const scene, Skeleton* skeleton)
 {
-    std::vector<common::Vertex> vertices;
-    std::vector<unsigned int> indices;
+    common::MeshData meshData;
+
+    auto& vertices = meshData.vertices;
+    auto& indices = meshData.indices;
+
+    if (mesh->mMaterialIndex < scene->mNumMaterials)
+        meshData.materialSlot = scene->mMaterials[mesh->mMaterialIndex]->GetName().C_Str();
 
     for(unsigned int j = 0; j < mesh->mNumVertices; j++)
     {
@@ -171,10 +482,10 @@ elix::Mesh processMesh(aiMesh* mesh, const aiScene* const scene, Skeleton* skele
         assignLocalBindTransforms(scene->mRootNode, skeleton);
     }
 
-    return {vertices, indices};
+    return meshData;
 }
 
-void processMeshes(const aiNode* const node, const aiScene* const scene, std::vector<elix::Mesh>& meshes, Skeleton* skeleton)
+void processMeshes(const aiNode* const node, const aiScene* const scene, std::vector<common::MeshData>& meshes, Skeleton* skeleton)
 {
     for (unsigned int i = 0; i < node->mNumMeshes; ++i)
     {
@@ -186,21 +497,49 @@ void processMeshes(const aiNode* const node, const aiScene* const scene, std::ve
         processMeshes(node->mChildren[i], scene, meshes, skeleton);
 }
 
-std::unique_ptr<elix::AssetModel> elix::AssetsLoader::loadModel(const std::string &filePath)
+bool elix::AssetsLoader::importModel(const std::string &filePath, std::vector<common::MeshData> &meshes, Skeleton &skeleton)
 {
     Assimp::Importer importer;
 
     const aiScene* scene = importer.ReadFile(filePath, aiProcess_Triangulate | aiProcess_FlipUVs);
 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        return false;
+
+    processMeshes(scene->mRootNode, scene, meshes, &skeleton);
+
+    return true;
+}
+
+std::unique_ptr<elix::AssetModel> elix::AssetsLoader::loadModel(const std::string &filePath)
+{
+    std::vector<common::MeshData> meshesData;
+    auto skeleton = std::make_unique<Skeleton>();
+
+    if (!importModel(filePath, meshesData, *skeleton))
         return nullptr;
 
+    if (isMeshOptimizationEnabled())
+    {
+        const auto statistics = MeshOptimizer::optimize(meshesData);
+
+        ELIX_LOG_INFO("Optimized model ", filePath, ": vertices ", statistics.vertexCountBefore, " -> ", statistics.vertexCountAfter,
+            ", ACMR ", statistics.acmrBefore, " -> ", statistics.acmrAfter);
+
+        for (auto& meshData : meshesData)
+            MeshSimplifier::generateLods(meshData);
+    }
+
     std::vector<elix::Mesh> meshes;
-    auto skeleton = std::make_unique<Skeleton>();
+    meshes.reserve(meshesData.size());
 
-    const std::string name = std::filesystem::path(filePath).filename().string();
+    for (const auto& meshData : meshesData)
+    {
+        if (!elix::VertexFormat::areBonesPackable(meshData.vertices))
+            ELIX_LOG_ERROR("Model ", filePath, " has vertices weighted to bones past ", elix::VertexFormat::MAX_SKINNED_BONES - 1, ", their influences are dropped");
 
-    processMeshes(scene->mRootNode, scene, meshes, skeleton.get());
+        meshes.emplace_back(meshData);
+    }
 
     std::unique_ptr<elix::Model> model{nullptr};
 
@@ -221,6 +560,88 @@ std::unique_ptr<elix::AssetModel> elix::AssetsLoader::loadModel(const std::strin
     return std::make_unique<elix::AssetModel>(std::move(model));
 }
 
+std::unique_ptr<elix::AssetModel> elix::AssetsLoader::loadCookedModel(const std::string &filePath, elix::AssetsCache* cache)
+{
+    const auto file = elix::MappedFile::open(filePath);
+
+    if (!file)
+        return nullptr;
+
+    ModelCooker::ModelView view;
+
+    if (!ModelCooker::parse({file->data(), file->size()}, view))
+    {
+        ELIX_LOG_ERROR("Cooked model is corrupt or of another version ", filePath, ", expected version ", cooked::MODEL_VERSION);
+        return nullptr;
+    }
+
+    std::vector<elix::Mesh> meshes;
+    meshes.reserve(view.meshes.size());
+
+    for (const auto& record : view.meshes)
+    {
+        const VertexLayout vertexLayout = record.flags & cooked::MESH_FLAG_HAS_BONES ? VertexLayout::Skinned : VertexLayout::Static;
+        const IndexType indexType = record.flags & cooked::MESH_FLAG_16BIT_INDICES ? IndexType::UInt16 : IndexType::UInt32;
+
+        std::vector<elix::Mesh::Lod> lods;
+        lods.reserve(record.lodCount);
+
+        for (const auto& lodRecord : view.getLods(record))
+            lods.push_back({lodRecord.indexOffset, lodRecord.indexCount, lodRecord.error});
+
+        auto& mesh = meshes.emplace_back(file, vertexLayout, view.getVertices(record), indexType, view.getIndices(record), std::move(lods));
+        mesh.setMaterialSlot(std::string(view.getString(record.materialSlotOffset, record.materialSlotLength)));
+
+        if (cache && !mesh.getMaterialSlot().empty())
+            if (const auto material = cache->findAsset<elix::AssetMaterial>(mesh.getMaterialSlot()))
+                mesh.setMaterial(material->getMaterial());
+    }
+
+    const std::string modelName(view.getString(view.header->nameOffset, view.header->nameLength));
+
+    std::unique_ptr<elix::Model> model{nullptr};
+
+    if (view.bones.empty())
+        model = std::make_unique<elix::Model>(modelName, std::move(meshes));
+    else
+    {
+        auto skeleton = std::make_unique<Skeleton>();
+
+        std::memcpy(&skeleton->globalInverseTransform, view.header->globalInverseTransform, sizeof(glm::mat4));
+
+        for (size_t boneIndex = 0; boneIndex < view.bones.size(); ++boneIndex)
+        {
+            const auto& record = view.bones[boneIndex];
+
+            common::BoneInfo bone;
+            bone.name = view.getString(record.nameOffset, record.nameLength);
+            bone.id = static_cast<int>(boneIndex);
+            bone.parentId = record.parentId;
+            std::memcpy(&bone.offsetMatrix, record.offsetMatrix, sizeof(glm::mat4));
+            std::memcpy(&bone.localBindTransform, record.localBindTransform, sizeof(glm::mat4));
+            std::memcpy(&bone.globalBindTransform, record.globalBindTransform, sizeof(glm::mat4));
+
+            skeleton->addBone(bone);
+        }
+
+        //Parent ids were checked against the bone count by parse
+        for (size_t boneIndex = 0; boneIndex < view.bones.size(); ++boneIndex)
+        {
+            if (view.bones[boneIndex].parentId < 0)
+                continue;
+
+            if (auto* parent = skeleton->getBone(view.bones[boneIndex].parentId))
+                parent->children.push_back(static_cast<int>(boneIndex));
+        }
+
+        model = std::make_unique<elix::Model>(modelName, std::move(meshes), std::move(skeleton));
+    }
+
+    ELIX_LOG_INFO("Loaded cooked model ", filePath.c_str());
+
+    return std::make_unique<elix::AssetModel>(std::move(model));
+}
+
 std::unique_ptr<elix::AssetMaterial> elix::AssetsLoader::loadMaterial(const std::string &filePath, elix::AssetsCache* cache)
 {
     std::ifstream file(filePath);
@@ -236,6 +657,7 @@ std::unique_ptr<elix::AssetMaterial> elix::AssetsLoader::loadMaterial(const std:
     }
 
     auto material = std::make_unique<Material>();
+    std::vector<elix::AssetHandle<elix::AssetTexture>> textureDependencies;
 
     if (json.contains("name"))
         material->setName(json["name"].get<std::string>());
@@ -253,14 +675,26 @@ std::unique_ptr<elix::AssetMaterial> elix::AssetsLoader::loadMaterial(const std:
                 continue;
 
             if (const auto textureType = utilities::fromStringToTextureType(key); textureType != elix::Texture::TextureType::Undefined)
-                if (auto asset = cache->getAsset<elix::AssetTexture>(value.get<std::string>()))
+            {
+                const auto textureHandle = cache->getHandle<elix::AssetTexture>(value.get<std::string>());
+
+                if (auto asset = cache->findAsset<elix::AssetTexture>(value.get<std::string>()))
+                {
                     material->addTexture(textureType, asset->getTexture());
+                    textureDependencies.push_back(textureHandle);
+                }
+            }
         }
 
 
     ELIX_LOG_INFO("Loaded material ", filePath.c_str());
 
-    return std::make_unique<elix::AssetMaterial>(std::move(material));
+    auto materialAsset = std::make_unique<elix::AssetMaterial>(std::move(material));
+
+    for (const auto texture : textureDependencies)
+        materialAsset->addTextureDependency(texture);
+
+    return materialAsset;
 }
 
 std::unique_ptr<elix::AssetAnimation> elix::AssetsLoader::loadAnimation(const std::string &filePath)
@@ -282,54 +716,39 @@ std::unique_ptr<elix::AssetAnimation> elix::AssetsLoader::loadAnimation(const st
      animation->name = anim->mName.C_Str();
      animation->duration = anim->mDuration;
      animation->ticksPerSecond = anim->mTicksPerSecond;
-     std::vector<common::AnimationTrack> boneAnimations;
+     std::vector<AnimationClip::RawTrack> tracks;
+     tracks.reserve(anim->mNumChannels);
 
      for(unsigned int animChannelIndex = 0; animChannelIndex < anim->mNumChannels; ++animChannelIndex)
      {
-         aiNodeAnim* channel = anim->mChannels[animChannelIndex];
-         common::AnimationTrack boneAnimation;
-
-         boneAnimation.objectName = channel->mNodeName.C_Str();
+         const aiNodeAnim* channel = anim->mChannels[animChannelIndex];
+         auto& track = tracks.emplace_back();
 
-         std::map<float, common::SQT> tempKeyFrames;
+         track.name = channel->mNodeName.C_Str();
+         track.translations.reserve(channel->mNumPositionKeys);
+         track.rotations.reserve(channel->mNumRotationKeys);
+         track.scales.reserve(channel->mNumScalingKeys);
 
          for (unsigned int j = 0; j < channel->mNumPositionKeys; j++)
          {
-             float time = channel->mPositionKeys[j].mTime;
-             tempKeyFrames[time].position = glm::vec3(channel->mPositionKeys[j].mValue.x,
-                                                      channel->mPositionKeys[j].mValue.y,
-                                                      channel->mPositionKeys[j].mValue.z);
-             tempKeyFrames[time].timeStamp = time;
+             const auto& key = channel->mPositionKeys[j];
+             track.translations.push_back({static_cast<float>(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
          }
 
          for (unsigned int j = 0; j < channel->mNumRotationKeys; j++)
          {
-             float time = channel->mRotationKeys[j].mTime;
-             tempKeyFrames[time].rotation = glm::quat(channel->mRotationKeys[j].mValue.w,
-                                                      channel->mRotationKeys[j].mValue.x,
-                                                      channel->mRotationKeys[j].mValue.y,
-                                                      channel->mRotationKeys[j].mValue.z);
-             tempKeyFrames[time].timeStamp = time;
+             const auto& key = channel->mRotationKeys[j];
+             track.rotations.push_back({static_cast<float>(key.mTime), glm::quat(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z)});
          }
 
          for (unsigned int j = 0; j < channel->mNumScalingKeys; j++)
          {
-             float time = channel->mScalingKeys[j].mTime;
-             tempKeyFrames[time].scale = glm::vec3(channel->mScalingKeys[j].mValue.x,
-                                                   channel->mScalingKeys[j].mValue.y,
-                                                   channel->mScalingKeys[j].mValue.z);
-             tempKeyFrames[time].timeStamp = time;
+             const auto& key = channel->mScalingKeys[j];
+             track.scales.push_back({static_cast<float>(key.mTime), glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z)});
          }
-
-         boneAnimation.keyFrames.reserve(tempKeyFrames.size());
-
-         for (auto& [time, sqt] : tempKeyFrames)
-             boneAnimation.keyFrames.push_back(sqt);
-
-         boneAnimations.push_back(boneAnimation);
      }
 
-     animation->boneAnimations = (boneAnimations);
+     animation->clip = AnimationClip::compress(animation->name, static_cast<float>(anim->mDuration), static_cast<float>(anim->mTicksPerSecond), tracks);
 
     ELIX_LOG_INFO("Loaded animation ", filePath.c_str());
 
@@ -10,6 +10,7 @@ namespace
             case elix::Buffer::BufferType::Vertex: return GL_ARRAY_BUFFER;
             case elix::Buffer::BufferType::Index: return GL_ELEMENT_ARRAY_BUFFER;
             case elix::Buffer::BufferType::Uniform: return GL_UNIFORM_BUFFER;
+            case elix::Buffer::BufferType::ShaderStorage: return GL_SHADER_STORAGE_BUFFER;
         }
 
         return 0;
@@ -55,6 +56,16 @@ void elix::Buffer::uploadRaw(const void *data, size_t size)
     // unbind();
 }
 
+void elix::Buffer::bindBase(unsigned int index) const
+{
+    glBindBufferBase(toGL(m_bufferType), index, m_id);
+}
+
+unsigned int elix::Buffer::getId() const
+{
+    return m_id;
+}
+
 elix::Buffer::~Buffer()
 {
     if (m_id)
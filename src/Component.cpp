@@ -0,0 +1,20 @@
+#include "Component.hpp"
+
+void Component::tick(float deltaTime, float significance)
+{
+    m_pendingTime += deltaTime;
+
+    //The interval grows from one frame at fullRateSignificance to 1 / minRate at zero significance
+    if (m_tickBudget.minRate > 0.0f && significance < m_tickBudget.fullRateSignificance)
+    {
+        const float fraction = m_tickBudget.fullRateSignificance > 0.0f ? 1.0f - significance / m_tickBudget.fullRateSignificance : 1.0f;
+
+        if (m_pendingTime < fraction / m_tickBudget.minRate)
+            return;
+    }
+
+    const float pendingTime = m_pendingTime;
+    m_pendingTime = 0.0f;
+
+    update(pendingTime);
+}
@@ -9,6 +9,7 @@ namespace
         {
             case elix::DrawCall::DrawMode::TRIANGLES: return GL_TRIANGLES;
             case elix::DrawCall::DrawMode::LINES: return GL_LINES;
+            case elix::DrawCall::DrawMode::POINTS: return GL_POINTS;
         }
 
         return GL_NONE;
@@ -19,6 +20,7 @@ namespace
         switch (type)
         {
             case elix::DrawCall::DrawType::UNSIGNED_INT: return GL_UNSIGNED_INT;
+            case elix::DrawCall::DrawType::UNSIGNED_SHORT: return GL_UNSIGNED_SHORT;
         }
 
         return GL_NONE;
@@ -30,6 +32,11 @@ void elix::DrawCall::draw(DrawMode drawMode, size_t count, DrawType drawType, co
     glDrawElements(toGL(drawMode), count, toGL(drawType), indices);
 }
 
+void elix::DrawCall::drawInstanced(DrawMode drawMode, size_t count, DrawType drawType, const void *indices, size_t instanceCount)
+{
+    glDrawElementsInstanced(toGL(drawMode), count, toGL(drawType), indices, instanceCount);
+}
+
 void elix::DrawCall::drawArrays(DrawMode drawMode, size_t first, size_t count)
 {
     glDrawArrays(toGL(drawMode), first, count);
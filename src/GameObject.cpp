@@ -1,49 +1,89 @@
 #include "GameObject.hpp"
 
-GameObject::GameObject(const std::string &name) : m_name(name) {}
+#include "Scene.hpp"
+#include "TransformSystem.hpp"
 
-GameObject::~GameObject() = default;
+#include <glm/gtx/euler_angles.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+GameObject::GameObject(const std::string &name) : m_entity(elix::Registry::instance().create()),
+    m_transformNode(elix::TransformSystem::createNode(m_entity)), m_name(name)
+{
+    elix::Registry::instance().add<elix::Transform>(m_entity).node = m_transformNode;
+}
+
+GameObject::~GameObject()
+{
+    //Children outlive their parent as roots
+    while (!m_children.empty())
+        m_children.back()->setParent(nullptr);
+
+    setParent(nullptr);
+
+    elix::TransformSystem::destroyNode(m_transformNode);
+    elix::Registry::instance().destroy(m_entity);
+}
 
 void GameObject::setLayerMask(const common::LayerMask &layerMask)
 {
+    if (m_scene)
+        m_scene->removeFromIndices(*this);
+
     m_layerMask = layerMask;
+
+    if (m_scene)
+        m_scene->addToIndices(*this);
 }
 
 void GameObject::setName(const std::string &name)
 {
+    if (m_scene)
+        m_scene->removeFromIndices(*this);
+
     m_name = name;
+
+    if (m_scene)
+        m_scene->addToIndices(*this);
+}
+
+void GameObject::setTag(const std::string &tag)
+{
+    if (m_scene)
+        m_scene->removeFromIndices(*this);
+
+    m_tag = tag;
+
+    if (m_scene)
+        m_scene->addToIndices(*this);
 }
 
 void GameObject::setRotation(const glm::vec3 &axis)
 {
-    m_rotation = axis;
+    const glm::vec3 radians = glm::radians(axis);
 
-    m_isTransformMatrixDirty = true;
+    setOrientation(glm::angleAxis(radians.y, glm::vec3(0, 1, 0)) * glm::angleAxis(radians.x, glm::vec3(1, 0, 0)) *
+                   glm::angleAxis(radians.z, glm::vec3(0, 0, 1)));
+}
 
-    if (m_transformationChangedCallback)
-        m_transformationChangedCallback(getTransformMatrix());
+void GameObject::setOrientation(const glm::quat &orientation)
+{
+    getTransform().rotation = orientation;
+    elix::TransformSystem::markDirty(m_transformNode);
 }
 
 void GameObject::setPosition(const glm::vec3 &position)
 {
-    m_position = position;
-
-    m_isTransformMatrixDirty = true;
+    getTransform().position = position;
+    elix::TransformSystem::markDirty(m_transformNode);
 
     if (m_positionChangedCallback)
         m_positionChangedCallback(position);
-
-    if (m_transformationChangedCallback)
-        m_transformationChangedCallback(getTransformMatrix());
 }
 
 void GameObject::setScale(const glm::vec3 &scale)
 {
-    m_scale = scale;
-    m_isTransformMatrixDirty = true;
-    
-    if (m_transformationChangedCallback)
-        m_transformationChangedCallback(getTransformMatrix());
+    getTransform().scale = scale;
+    elix::TransformSystem::markDirty(m_transformNode);
 }
 
 void GameObject::setPositionChangedCallback(const std::function<void(const glm::vec3 &)> &callback)
@@ -53,7 +93,7 @@ void GameObject::setPositionChangedCallback(const std::function<void(const glm::
 
 void GameObject::setTransformationChangedCallback(const std::function<void(const glm::mat4 &)> &callback)
 {
-    m_transformationChangedCallback = callback;
+    elix::TransformSystem::setChangedCallback(m_transformNode, callback);
 }
 
 const common::LayerMask& GameObject::getLayerMask() const
@@ -66,56 +106,120 @@ const std::string &GameObject::getName() const
     return m_name;
 }
 
+const std::string & GameObject::getTag() const
+{
+    return m_tag;
+}
+
+Scene * GameObject::getScene() const
+{
+    return m_scene;
+}
+
 glm::mat4 GameObject::getTransformMatrix()
 {
-    if (!m_isTransformMatrixDirty)
-        return m_transformMatrix;
+    return elix::TransformSystem::getWorldMatrix(m_transformNode);
+}
+
+void GameObject::setTransformMatrix(const glm::mat4 &transformMatrix)
+{
+    auto& transform = getTransform();
+    glm::vec3 skew;
+    glm::vec4 perspective;
+
+    glm::decompose(transformMatrix, transform.scale, transform.rotation, transform.position, skew, perspective);
+    elix::TransformSystem::markDirty(m_transformNode);
+}
+
+bool GameObject::setParent(GameObject *parent)
+{
+    if (parent == m_parent)
+        return true;
 
-    glm::mat4 translation = glm::translate(glm::mat4(1.0f), m_position);
+    if (!elix::TransformSystem::setParent(m_transformNode, parent ? parent->m_transformNode : elix::TransformSystem::INVALID_NODE))
+        return false;
 
-    glm::mat4 rotX = glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.x), glm::vec3(1, 0, 0));
-    glm::mat4 rotY = glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.y), glm::vec3(0, 1, 0));
-    glm::mat4 rotZ = glm::rotate(glm::mat4(1.0f), glm::radians(m_rotation.z), glm::vec3(0, 0, 1));
-    glm::mat4 rotation = rotY * rotX * rotZ;
+    if (m_parent)
+        std::erase(m_parent->m_children, this);
 
-    glm::mat4 scale = glm::scale(glm::mat4(1.0f), m_scale);
+    m_parent = parent;
 
-    m_transformMatrix = translation * rotation * scale;
+    if (m_parent)
+        m_parent->m_children.push_back(this);
 
-    m_isTransformMatrixDirty = false;
+    return true;
+}
 
-    return m_transformMatrix;
+GameObject * GameObject::getParent() const
+{
+    return m_parent;
 }
 
-void GameObject::setTransformMatrix(const glm::mat4 &transformMatrix)
+const std::vector<GameObject *>& GameObject::getChildren() const
 {
-    m_transformMatrix = transformMatrix;
-    m_isTransformMatrixDirty = false;
+    return m_children;
 }
 
 glm::vec3 GameObject::getPosition() const
 {
-    return m_position;
+    return getTransform().position;
 }
 
 glm::vec3 GameObject::getScale() const
 {
-    return m_scale;
+    return getTransform().scale;
 }
 
 glm::vec3 GameObject::getRotation() const
 {
-    return m_rotation;
+    glm::vec3 radians;
+    glm::extractEulerAngleYXZ(glm::mat4_cast(getTransform().rotation), radians.y, radians.x, radians.z);
+
+    return glm::degrees(radians);
+}
+
+glm::quat GameObject::getOrientation() const
+{
+    return getTransform().rotation;
+}
+
+elix::Entity GameObject::getEntity() const
+{
+    return m_entity;
+}
+
+elix::Transform & GameObject::getTransform() const
+{
+    return *elix::Registry::instance().get<elix::Transform>(m_entity);
 }
 
 void GameObject::destroy()
 {
-    for (auto& component : m_components)
-        component.second->destroy();
+    elix::Registry::instance().forEachComponent(m_entity, [](Component& component) { component.destroy(); });
 }
 
 void GameObject::update(float deltaTime)
 {
-    for (auto& [_, comp] : m_components)
-        comp->update(deltaTime);
+    //Type id order, the same every frame unlike the hash map the components used to live in
+    elix::Registry::instance().forEachComponent(m_entity, [this, deltaTime](Component& component) { component.tick(deltaTime, m_significance.score); });
+}
+
+void GameObject::setSignificancePriority(float priority)
+{
+    m_significancePriority = priority;
+}
+
+float GameObject::getSignificancePriority() const
+{
+    return m_significancePriority;
+}
+
+void GameObject::setSignificance(const common::Significance &significance)
+{
+    m_significance = significance;
+}
+
+const common::Significance& GameObject::getSignificance() const
+{
+    return m_significance;
 }
\ No newline at end of file
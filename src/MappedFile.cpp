@@ -0,0 +1,118 @@
+#include "MappedFile.hpp"
+#include "Logger.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+std::shared_ptr<elix::MappedFile> elix::MappedFile::open(const std::string &filePath)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->m_path = filePath;
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        ELIX_LOG_ERROR("Failed to open file for mapping ", filePath);
+        return nullptr;
+    }
+
+    file->m_fileHandle = fileHandle;
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        ELIX_LOG_ERROR("Failed to map empty file ", filePath);
+        return nullptr;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mappingHandle)
+    {
+        ELIX_LOG_ERROR("Failed to create file mapping ", filePath);
+        return nullptr;
+    }
+
+    file->m_mappingHandle = mappingHandle;
+    file->m_size = static_cast<size_t>(fileSize.QuadPart);
+    file->m_data = static_cast<const std::byte*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    const int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+
+    if (fileDescriptor == -1)
+    {
+        ELIX_LOG_ERROR("Failed to open file for mapping ", filePath);
+        return nullptr;
+    }
+
+    file->m_fileDescriptor = fileDescriptor;
+
+    struct stat fileStat{};
+
+    if (fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+    {
+        ELIX_LOG_ERROR("Failed to map empty file ", filePath);
+        return nullptr;
+    }
+
+    void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        ELIX_LOG_ERROR("Failed to map file ", filePath);
+        return nullptr;
+    }
+
+    file->m_size = static_cast<size_t>(fileStat.st_size);
+    file->m_data = static_cast<const std::byte*>(mapping);
+#endif
+
+    if (!file->m_data)
+        return nullptr;
+
+    return file;
+}
+
+const std::byte* elix::MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t elix::MappedFile::size() const
+{
+    return m_size;
+}
+
+const std::string& elix::MappedFile::getPath() const
+{
+    return m_path;
+}
+
+elix::MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+
+    if (m_mappingHandle)
+        CloseHandle(m_mappingHandle);
+
+    if (m_fileHandle)
+        CloseHandle(m_fileHandle);
+#else
+    if (m_data)
+        munmap(const_cast<std::byte*>(m_data), m_size);
+
+    if (m_fileDescriptor != -1)
+        close(m_fileDescriptor);
+#endif
+}
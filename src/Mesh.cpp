@@ -1,63 +1,297 @@
 #include "Mesh.hpp"
-#include "Buffer.hpp"
 #include "DrawCall.hpp"
+#include "Logger.hpp"
 
-elix::Mesh::Mesh(const std::vector<common::Vertex> &vertices, const std::vector<unsigned int> &indices) : m_vertices(vertices), m_indices(indices)
+#include <algorithm>
+
+namespace
+{
+    bool g_isDepthOnlyPass{false};
+    bool g_isDepthStreamsEnabled{true};
+} //namespace
+
+elix::Mesh::Mesh(const std::vector<common::Vertex> &vertices, const std::vector<unsigned int> &indices) :
+m_vertexLayout(VertexFormat::selectLayout(vertices)), m_indexType(VertexFormat::selectIndexType(vertices.size()))
+{
+    m_vertices = VertexFormat::packVertices(vertices, m_vertexLayout);
+    m_indices = VertexFormat::packIndices(indices, m_indexType);
+    m_lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+}
+
+elix::Mesh::Mesh(const common::MeshData &meshData) :
+m_vertexLayout(VertexFormat::selectLayout(meshData.vertices)), m_indexType(VertexFormat::selectIndexType(meshData.vertices.size())), m_materialSlot(meshData.materialSlot)
+{
+    std::vector<unsigned int> indices = meshData.indices;
+    m_lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+    for (const auto& lod : meshData.lods)
+    {
+        m_lods.push_back({static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error});
+        indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+    }
+
+    m_vertices = VertexFormat::packVertices(meshData.vertices, m_vertexLayout);
+    m_indices = VertexFormat::packIndices(indices, m_indexType);
+}
+
+elix::Mesh::Mesh(std::shared_ptr<const elix::MappedFile> source, VertexLayout vertexLayout, std::span<const std::byte> vertices, IndexType indexType, std::span<const std::byte> indices,
+                 std::vector<Lod> lods) :
+m_vertexLayout(vertexLayout), m_indexType(indexType), m_lods(std::move(lods)), m_source(std::move(source)), m_mappedVertices(vertices), m_mappedIndices(indices)
+{
+    if (m_lods.empty())
+        m_lods.push_back({0, static_cast<uint32_t>(getIndexCount()), 0.0f});
+}
+
+void elix::Mesh::bake()
+{
+    if (!m_isBaked)
+        upload();
+}
+
+bool elix::Mesh::isBaked() const
 {
+    return m_isBaked;
+}
+
+void elix::Mesh::release()
+{
+    if (!m_isBaked)
+        return;
+
+    m_vertexArray.destroy();
+    m_depthVertexArray.destroy();
+    m_indexBuffer.reset();
+    m_hasDepthStream = false;
+    m_gpuMemorySize = 0;
+    m_isBaked = false;
+}
+
+void elix::Mesh::upload() const
+{
+    const auto vertices = getVertexData();
+    const auto indices = getIndexData();
+
     elix::Buffer vbo(elix::Buffer::BufferType::Vertex, elix::Buffer::BufferUsage::StaticDraw);
-    elix::Buffer ebo(elix::Buffer::BufferType::Index, elix::Buffer::BufferUsage::StaticDraw);
+    m_indexBuffer = std::make_shared<elix::Buffer>(elix::Buffer::BufferType::Index, elix::Buffer::BufferUsage::StaticDraw);
 
     m_vertexArray.create();
     vbo.create();
-    ebo.create();
+    m_indexBuffer->create();
 
     m_vertexArray.bind();
 
-    vbo.uploadRaw(m_vertices.data(), m_vertices.size() * sizeof(common::Vertex));
+    vbo.uploadRaw(vertices.data(), vertices.size_bytes());
+
+    m_indexBuffer->uploadRaw(indices.data(), indices.size_bytes());
 
-    ebo.uploadRaw(m_indices.data(), m_indices.size() * sizeof(unsigned int));
+    //Both layouts share the leading members, the shaders decode normal and tangent from octahedral
+    const size_t stride = VertexFormat::getStride(m_vertexLayout);
 
-    m_vertexArray.setAttribute(0, 3, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, position));
-    m_vertexArray.setAttribute(1, 3, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, normal));
-    m_vertexArray.setAttribute(2, 2, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, textureCoordinates));
+    m_vertexArray.setAttribute(0, 3, elix::VertexArray::Type::Float, false, stride, (void*)offsetof(StaticVertex, position));
+    m_vertexArray.setAttribute(1, 2, elix::VertexArray::Type::Short, true, stride, (void*)offsetof(StaticVertex, normal));
+    m_vertexArray.setAttribute(2, 2, elix::VertexArray::Type::HalfFloat, false, stride, (void*)offsetof(StaticVertex, textureCoordinates));
+    m_vertexArray.setAttribute(3, 4, elix::VertexArray::Type::Byte, true, stride, (void*)offsetof(StaticVertex, tangent));
 
     if (hasBones())
     {
-        m_vertexArray.setAttribute(3, 3, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, tangent));
-        m_vertexArray.setAttribute(4, 3, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, bitangent));
-        m_vertexArray.setAttribute(5, 4, elix::VertexArray::Type::Int, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, boneID));
-        m_vertexArray.setAttribute(6, 4, elix::VertexArray::Type::Float, false, sizeof(common::Vertex),  (void*)offsetof(common::Vertex, weight));
+        m_vertexArray.setIntegerAttribute(5, 4, elix::VertexArray::Type::UnsignedByte, stride, (void*)offsetof(SkinnedVertex, boneIds));
+        m_vertexArray.setAttribute(6, 4, elix::VertexArray::Type::UnsignedShort, true, stride, (void*)offsetof(SkinnedVertex, weights));
     }
 
     m_vertexArray.unbind();
     vbo.unbind();
+    m_indexBuffer->unbind();
+
+    m_gpuMemorySize = vertices.size_bytes() + indices.size_bytes();
+
+    if (g_isDepthStreamsEnabled)
+        uploadDepthStream(vertices, indices);
+
+    m_isBaked = true;
+}
+
+void elix::Mesh::uploadDepthStream(std::span<const std::byte> vertices, std::span<const std::byte> indices) const
+{
+    std::vector<std::byte> depthVertices;
+    std::vector<std::byte> depthIndices;
+
+    //Depth passes fall back to the full vertex array
+    if (!VertexFormat::extractDepthStream(vertices, m_vertexLayout, indices, m_indexType, depthVertices, depthIndices))
+    {
+        ELIX_LOG_WARN("Mesh indices point past its vertices, skipping its depth stream");
+        return;
+    }
+
+    elix::Buffer vbo(elix::Buffer::BufferType::Vertex, elix::Buffer::BufferUsage::StaticDraw);
+    elix::Buffer ebo(elix::Buffer::BufferType::Index, elix::Buffer::BufferUsage::StaticDraw);
+
+    m_depthVertexArray.create();
+    vbo.create();
+    ebo.create();
+
+    m_depthVertexArray.bind();
+
+    vbo.uploadRaw(depthVertices.data(), depthVertices.size());
+    ebo.uploadRaw(depthIndices.data(), depthIndices.size());
+
+    //Same locations as the full layout so the shadow shaders work with either VAO
+    const size_t stride = VertexFormat::getDepthStride(m_vertexLayout);
+
+    m_depthVertexArray.setAttribute(0, 3, elix::VertexArray::Type::Float, false, stride, (void*)offsetof(SkinnedDepthVertex, position));
+
+    if (hasBones())
+    {
+        m_depthVertexArray.setIntegerAttribute(5, 4, elix::VertexArray::Type::UnsignedByte, stride, (void*)offsetof(SkinnedDepthVertex, boneIds));
+        m_depthVertexArray.setAttribute(6, 4, elix::VertexArray::Type::UnsignedShort, true, stride, (void*)offsetof(SkinnedDepthVertex, weights));
+    }
+
+    m_depthVertexArray.unbind();
+    vbo.unbind();
     ebo.unbind();
 
-    m_indicesCount = m_indices.size();
+    m_gpuMemorySize += depthVertices.size() + depthIndices.size();
+    m_hasDepthStream = true;
 }
 
 bool elix::Mesh::hasBones() const
 {
-    for (const auto& vertex : m_vertices)
-        if (vertex.boneID[0] != -1)
-            return true;
+    return m_vertexLayout == VertexLayout::Skinned;
+}
+
+elix::VertexLayout elix::Mesh::getVertexLayout() const
+{
+    return m_vertexLayout;
+}
+
+elix::IndexType elix::Mesh::getIndexType() const
+{
+    return m_indexType;
+}
+
+size_t elix::Mesh::getVertexCount() const
+{
+    return getVertexData().size() / VertexFormat::getStride(m_vertexLayout);
+}
+
+size_t elix::Mesh::getIndexCount() const
+{
+    return getIndexData().size() / VertexFormat::getIndexSize(m_indexType);
+}
+
+std::span<const std::byte> elix::Mesh::getVertexData() const
+{
+    return m_source ? m_mappedVertices : std::span<const std::byte>(m_vertices);
+}
+
+std::span<const std::byte> elix::Mesh::getIndexData() const
+{
+    return m_source ? m_mappedIndices : std::span<const std::byte>(m_indices);
+}
+
+void elix::Mesh::draw(size_t lod) const
+{
+    if (!m_isBaked)
+        upload();
+
+    draw(g_isDepthOnlyPass && m_hasDepthStream ? m_depthVertexArray : m_vertexArray, lod);
+}
+
+void elix::Mesh::drawInstanced(size_t lod, size_t instanceCount, bool useDepthStream) const
+{
+    if (!m_isBaked)
+        upload();
 
-    return false;
+    draw(useDepthStream && g_isDepthOnlyPass && m_hasDepthStream ? m_depthVertexArray : m_vertexArray, lod, instanceCount);
 }
 
-void elix::Mesh::draw() const
+void elix::Mesh::draw(const elix::VertexArray &vertexArray, size_t lod, size_t instanceCount) const
 {
+    const auto& range = getLod(lod);
+    const size_t indexOffset = range.indexOffset * VertexFormat::getIndexSize(m_indexType);
+    const auto indexType = m_indexType == IndexType::UInt16 ? elix::DrawCall::DrawType::UNSIGNED_SHORT : elix::DrawCall::DrawType::UNSIGNED_INT;
+
+    vertexArray.bind();
+
+    if (instanceCount == 1)
+        elix::DrawCall::draw(elix::DrawCall::DrawMode::TRIANGLES, range.indexCount, indexType, reinterpret_cast<const void*>(indexOffset));
+    else
+        elix::DrawCall::drawInstanced(elix::DrawCall::DrawMode::TRIANGLES, range.indexCount, indexType, reinterpret_cast<const void*>(indexOffset), instanceCount);
+
+    vertexArray.unbind();
+}
+
+void elix::Mesh::attachIndexBuffer() const
+{
+    if (m_indexBuffer)
+        m_indexBuffer->bind();
+}
+
+void elix::Mesh::drawVertices() const
+{
+    if (!m_isBaked)
+        upload();
+
     m_vertexArray.bind();
-    elix::DrawCall::draw(elix::DrawCall::DrawMode::TRIANGLES, m_indicesCount, elix::DrawCall::DrawType::UNSIGNED_INT, nullptr);
+    elix::DrawCall::drawArrays(elix::DrawCall::DrawMode::POINTS, 0, getVertexCount());
     m_vertexArray.unbind();
 }
 
+size_t elix::Mesh::getLodCount() const
+{
+    return m_lods.size();
+}
+
+const elix::Mesh::Lod& elix::Mesh::getLod(size_t lod) const
+{
+    return m_lods[std::min(lod, m_lods.size() - 1)];
+}
+
+void elix::Mesh::setDepthOnlyPass(bool isDepthOnly)
+{
+    g_isDepthOnlyPass = isDepthOnly;
+}
+
+bool elix::Mesh::isDepthOnlyPass()
+{
+    return g_isDepthOnlyPass;
+}
+
+void elix::Mesh::setDepthStreamsEnabled(bool enabled)
+{
+    g_isDepthStreamsEnabled = enabled;
+}
+
+bool elix::Mesh::isDepthStreamsEnabled()
+{
+    return g_isDepthStreamsEnabled;
+}
+
+bool elix::Mesh::hasDepthStream() const
+{
+    return m_hasDepthStream;
+}
+
+size_t elix::Mesh::getGpuMemorySize() const
+{
+    return m_gpuMemorySize;
+}
+
 void elix::Mesh::setMaterial(Material *material)
 {
     m_material = material;
 }
 
+void elix::Mesh::setMaterialSlot(const std::string &materialSlot)
+{
+    m_materialSlot = materialSlot;
+}
+
 Material * elix::Mesh::getMaterial() const
 {
     return m_material;
 }
+
+const std::string& elix::Mesh::getMaterialSlot() const
+{
+    return m_materialSlot;
+}
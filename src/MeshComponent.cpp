@@ -0,0 +1,99 @@
+#include "MeshComponent.hpp"
+
+#include "CameraComponent.hpp"
+#include "GameObject.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    MeshComponent::LodSettings g_lodSettings;
+} //namespace
+
+void MeshComponent::render(std::unordered_map<int, Material *> *overrideMaterials) const
+{
+    if (m_isCulled || m_isInstanced)
+        return;
+
+    //Shadows hide most of the detail anyway
+    const size_t lod = m_lod + (elix::Mesh::isDepthOnlyPass() ? g_lodSettings.shadowLodBias : 0);
+
+    if (isPreSkinned())
+        overrideMaterials ? m_skinningCache->drawWithMaterials(*m_model, *overrideMaterials, lod) : m_skinningCache->draw(*m_model, lod);
+    else
+        overrideMaterials ? m_model->drawWithMaterials(*overrideMaterials, lod) : m_model->draw(lod);
+}
+
+bool MeshComponent::isPreSkinned() const
+{
+    return m_skinningCache && m_skinningCache->isValid();
+}
+
+elix::SkinningCache& MeshComponent::getSkinningCache()
+{
+    if (!m_skinningCache)
+        m_skinningCache = std::make_unique<elix::SkinningCache>();
+
+    return *m_skinningCache;
+}
+
+void MeshComponent::selectLod(const elix::CameraComponent &camera, float viewportHeight)
+{
+    if (!m_model || !getOwner())
+        return;
+
+    const auto& bounds = m_model->getBoundingBox();
+    const glm::mat4 transform = getOwner()->getTransformMatrix();
+    const glm::vec3 scale = getOwner()->getScale();
+    const float maxScale = std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+
+    const glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.getCenter(), 1.0f));
+    const float radius = bounds.getRadius() * maxScale;
+    const float distance = std::max(glm::length(center - camera.getPosition()) - radius, 0.01f);
+
+    //Pixels a model unit covers at the distance of the object
+    const float pixelsPerUnit = camera.getProjectionMatrix()[1][1] * viewportHeight * 0.5f / distance * maxScale;
+    const float screenSize = 2.0f * bounds.getRadius() * pixelsPerUnit;
+
+    const float hysteresis = g_lodSettings.hysteresis;
+
+    m_isCulled = screenSize < g_lodSettings.cullScreenSize * (m_isCulled ? 1.0f + hysteresis : 1.0f);
+
+    const size_t lodCount = m_model->getLodCount();
+    const float maxError = g_lodSettings.maxScreenError;
+    auto getScreenError = [this, pixelsPerUnit](size_t lod) { return m_model->getLodError(lod) * pixelsPerUnit; };
+
+    size_t lod = std::min(m_lod, lodCount - 1);
+
+    //Refine only once the current level is clearly too coarse, coarsen only once the next level is clearly fine
+    if (getScreenError(lod) > maxError * (1.0f + hysteresis))
+    {
+        while (lod > 0 && getScreenError(lod) > maxError)
+            --lod;
+    }
+    else
+    {
+        while (lod + 1 < lodCount && getScreenError(lod + 1) <= maxError * (1.0f - hysteresis))
+            ++lod;
+    }
+
+    m_lod = lod;
+}
+
+void MeshComponent::selectLods(const std::vector<std::shared_ptr<GameObject>> &objects, const elix::CameraComponent &camera, float viewportHeight)
+{
+    for (const auto& object : objects)
+        if (const auto meshComponent = object->getComponent<MeshComponent>())
+            meshComponent->selectLod(camera, viewportHeight);
+}
+
+void MeshComponent::setLodSettings(const LodSettings &settings)
+{
+    g_lodSettings = settings;
+}
+
+const MeshComponent::LodSettings & MeshComponent::getLodSettings()
+{
+    return g_lodSettings;
+}
@@ -0,0 +1,405 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    //Forsyth's scoring constants
+    constexpr uint32_t SCORING_CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    float getVertexScore(int cachePosition, uint32_t remainingTriangles)
+    {
+        //Nothing left to draw with this vertex
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+
+        if (cachePosition >= 0)
+        {
+            //The last triangle's vertices get a fixed score so the next triangle does not just reuse the same edge
+            if (cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / static_cast<float>(SCORING_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+
+        //Vertices with few triangles left are finished first so they can leave the cache for good
+        return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    }
+
+    struct VertexHash
+    {
+        size_t operator()(const common::Vertex& vertex) const
+        {
+            return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(&vertex), sizeof(common::Vertex)));
+        }
+    };
+
+    struct VertexEqual
+    {
+        bool operator()(const common::Vertex& left, const common::Vertex& right) const
+        {
+            return std::memcmp(&left, &right, sizeof(common::Vertex)) == 0;
+        }
+    };
+} //namespace
+
+elix::MeshOptimizer::Statistics elix::MeshOptimizer::optimize(common::MeshData &mesh)
+{
+    Statistics statistics;
+    statistics.vertexCountBefore = mesh.vertices.size();
+    statistics.acmrBefore = computeACMR(mesh.indices, mesh.vertices.size());
+
+    weldVertices(mesh.vertices, mesh.indices);
+    optimizeVertexCache(mesh.indices, mesh.vertices.size());
+    optimizeOverdraw(mesh.indices, mesh.vertices);
+    optimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    statistics.vertexCountAfter = mesh.vertices.size();
+    statistics.acmrAfter = computeACMR(mesh.indices, mesh.vertices.size());
+
+    return statistics;
+}
+
+elix::MeshOptimizer::Statistics elix::MeshOptimizer::optimize(std::vector<common::MeshData> &meshes)
+{
+    Statistics total;
+    size_t totalTriangles = 0;
+
+    for (auto& mesh : meshes)
+    {
+        const Statistics statistics = optimize(mesh);
+        const size_t triangleCount = mesh.indices.size() / 3;
+
+        total.vertexCountBefore += statistics.vertexCountBefore;
+        total.vertexCountAfter += statistics.vertexCountAfter;
+        total.acmrBefore += statistics.acmrBefore * static_cast<float>(triangleCount);
+        total.acmrAfter += statistics.acmrAfter * static_cast<float>(triangleCount);
+        totalTriangles += triangleCount;
+    }
+
+    if (totalTriangles > 0)
+    {
+        total.acmrBefore /= static_cast<float>(totalTriangles);
+        total.acmrAfter /= static_cast<float>(totalTriangles);
+    }
+
+    return total;
+}
+
+size_t elix::MeshOptimizer::weldVertices(std::vector<common::Vertex> &vertices, std::vector<unsigned int> &indices)
+{
+    static_assert(sizeof(common::Vertex) == sizeof(float) * 22, "Vertices are compared bitwise and must not contain padding");
+
+    std::unordered_map<common::Vertex, unsigned int, VertexHash, VertexEqual> uniqueVertices;
+    uniqueVertices.reserve(vertices.size());
+
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<common::Vertex> weldedVertices;
+    weldedVertices.reserve(vertices.size());
+
+    for (size_t vertexIndex = 0; vertexIndex < vertices.size(); ++vertexIndex)
+    {
+        const auto [it, inserted] = uniqueVertices.try_emplace(vertices[vertexIndex], static_cast<unsigned int>(weldedVertices.size()));
+
+        if (inserted)
+            weldedVertices.push_back(vertices[vertexIndex]);
+
+        remap[vertexIndex] = it->second;
+    }
+
+    for (auto& index : indices)
+        index = remap[index];
+
+    vertices = std::move(weldedVertices);
+
+    return vertices.size();
+}
+
+void elix::MeshOptimizer::optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0)
+        return;
+
+    //Triangles of every vertex, compacted as triangles get emitted
+    std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+
+    for (const auto index : indices)
+        ++remainingTriangles[index];
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+
+    for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + remainingTriangles[vertex];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        for (size_t corner = 0; corner < 3; ++corner)
+            adjacency[fill[indices[triangle * 3 + corner]]++] = static_cast<uint32_t>(triangle);
+
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+
+    for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        vertexScores[vertex] = getVertexScore(-1, remainingTriangles[vertex]);
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> isEmitted(triangleCount, false);
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        triangleScores[triangle] = vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] + vertexScores[indices[triangle * 3 + 2]];
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(SCORING_CACHE_SIZE + 3);
+    nextCache.reserve(SCORING_CACHE_SIZE + 3);
+
+    uint32_t bestTriangle = 0;
+    size_t searchCursor = 0;
+
+    for (size_t emitted = 0; emitted < triangleCount; ++emitted)
+    {
+        //Nothing in the cache has triangles left, continue with the next triangle in the input order
+        if (bestTriangle == INVALID_INDEX)
+        {
+            while (isEmitted[searchCursor])
+                ++searchCursor;
+
+            bestTriangle = static_cast<uint32_t>(searchCursor);
+        }
+
+        isEmitted[bestTriangle] = true;
+
+        const unsigned int* triangleIndices = &indices[bestTriangle * 3];
+
+        nextCache.clear();
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t vertex = triangleIndices[corner];
+
+            result.push_back(vertex);
+            nextCache.push_back(vertex);
+
+            //Drop the triangle from the vertex's list
+            auto* triangles = &adjacency[adjacencyOffsets[vertex]];
+            const uint32_t count = remainingTriangles[vertex];
+
+            for (uint32_t i = 0; i < count; ++i)
+                if (triangles[i] == bestTriangle)
+                {
+                    triangles[i] = triangles[count - 1];
+                    break;
+                }
+
+            --remainingTriangles[vertex];
+        }
+
+        for (const uint32_t vertex : cache)
+            if (vertex != triangleIndices[0] && vertex != triangleIndices[1] && vertex != triangleIndices[2])
+                nextCache.push_back(vertex);
+
+        //Vertices pushed out of the scoring window go back to the cold score
+        for (size_t i = SCORING_CACHE_SIZE; i < nextCache.size(); ++i)
+        {
+            cachePositions[nextCache[i]] = -1;
+            vertexScores[nextCache[i]] = getVertexScore(-1, remainingTriangles[nextCache[i]]);
+        }
+
+        if (nextCache.size() > SCORING_CACHE_SIZE)
+            nextCache.resize(SCORING_CACHE_SIZE);
+
+        for (size_t i = 0; i < nextCache.size(); ++i)
+        {
+            cachePositions[nextCache[i]] = static_cast<int>(i);
+            vertexScores[nextCache[i]] = getVertexScore(static_cast<int>(i), remainingTriangles[nextCache[i]]);
+        }
+
+        std::swap(cache, nextCache);
+
+        //Only triangles touching the cache change their score
+        bestTriangle = INVALID_INDEX;
+        float bestScore = -1.0f;
+
+        for (const uint32_t vertex : cache)
+        {
+            const auto* triangles = &adjacency[adjacencyOffsets[vertex]];
+
+            for (uint32_t i = 0; i < remainingTriangles[vertex]; ++i)
+            {
+                const uint32_t triangle = triangles[i];
+                const unsigned int* corners = &indices[triangle * 3];
+
+                const float score = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+                triangleScores[triangle] = score;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = triangle;
+                }
+            }
+        }
+    }
+
+    indices = std::move(result);
+}
+
+void elix::MeshOptimizer::optimizeOverdraw(std::vector<unsigned int> &indices, std::span<const common::Vertex> vertices, float threshold)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount < 2)
+        return;
+
+    //Hard cluster boundaries where the FIFO cache starts over, reordering whole clusters leaves the hit rate mostly intact
+    std::vector<size_t> clusterStarts;
+    std::vector<uint32_t> cacheTimestamps(vertices.size(), 0);
+    uint32_t timestamp = CACHE_SIZE + 1;
+
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        uint32_t misses = 0;
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            const unsigned int vertex = indices[triangle * 3 + corner];
+
+            if (timestamp - cacheTimestamps[vertex] > CACHE_SIZE)
+            {
+                cacheTimestamps[vertex] = timestamp++;
+                ++misses;
+            }
+        }
+
+        if (triangle == 0 || misses == 3)
+            clusterStarts.push_back(triangle);
+    }
+
+    if (clusterStarts.size() < 2)
+        return;
+
+    glm::vec3 meshCentroid{0.0f};
+
+    for (const auto index : indices)
+        meshCentroid += vertices[index].position;
+
+    meshCentroid /= static_cast<float>(indices.size());
+
+    struct Cluster
+    {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+
+    std::vector<Cluster> clusters;
+    clusters.reserve(clusterStarts.size());
+
+    for (size_t clusterIndex = 0; clusterIndex < clusterStarts.size(); ++clusterIndex)
+    {
+        const size_t begin = clusterStarts[clusterIndex];
+        const size_t end = clusterIndex + 1 < clusterStarts.size() ? clusterStarts[clusterIndex + 1] : triangleCount;
+
+        glm::vec3 centroid{0.0f};
+        glm::vec3 normal{0.0f};
+        float area = 0.0f;
+
+        for (size_t triangle = begin; triangle < end; ++triangle)
+        {
+            const glm::vec3& a = vertices[indices[triangle * 3]].position;
+            const glm::vec3& b = vertices[indices[triangle * 3 + 1]].position;
+            const glm::vec3& c = vertices[indices[triangle * 3 + 2]].position;
+
+            const glm::vec3 faceNormal = glm::cross(b - a, c - a);
+            const float faceArea = glm::length(faceNormal);
+
+            centroid += (a + b + c) * (faceArea / 3.0f);
+            normal += faceNormal;
+            area += faceArea;
+        }
+
+        if (area > 0.0f)
+            centroid /= area;
+
+        const float normalLength = glm::length(normal);
+
+        //Clusters facing away from the center are the most likely occluders, so they are drawn first
+        const float sortKey = normalLength > 0.0f ? glm::dot(centroid - meshCentroid, normal / normalLength) : 0.0f;
+
+        clusters.push_back({begin, end, sortKey});
+    }
+
+    std::ranges::stable_sort(clusters, std::greater{}, &Cluster::sortKey);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    for (const auto& cluster : clusters)
+        result.insert(result.end(), indices.begin() + static_cast<std::ptrdiff_t>(cluster.begin * 3), indices.begin() + static_cast<std::ptrdiff_t>(cluster.end * 3));
+
+    if (computeACMR(result, vertices.size()) <= computeACMR(indices, vertices.size()) * threshold)
+        indices = std::move(result);
+}
+
+void elix::MeshOptimizer::optimizeVertexFetch(std::vector<common::Vertex> &vertices, std::vector<unsigned int> &indices)
+{
+    std::vector<unsigned int> remap(vertices.size(), INVALID_INDEX);
+    std::vector<common::Vertex> orderedVertices;
+    orderedVertices.reserve(vertices.size());
+
+    for (auto& index : indices)
+    {
+        if (remap[index] == INVALID_INDEX)
+        {
+            remap[index] = static_cast<unsigned int>(orderedVertices.size());
+            orderedVertices.push_back(vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    //Vertices no triangle uses are dropped on the way
+    vertices = std::move(orderedVertices);
+}
+
+float elix::MeshOptimizer::computeACMR(std::span<const unsigned int> indices, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0)
+        return 0.0f;
+
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+    size_t misses = 0;
+
+    for (const auto index : indices)
+        if (timestamp - cacheTimestamps[index] > cacheSize)
+        {
+            cacheTimestamps[index] = timestamp++;
+            ++misses;
+        }
+
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
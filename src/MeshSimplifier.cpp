@@ -0,0 +1,487 @@
+#include "MeshSimplifier.hpp"
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    //Border planes are weighted heavily, moving the outline of an open mesh is far more visible than moving its interior
+    constexpr double BORDER_WEIGHT = 10.0;
+    //Collapses rotating a remaining triangle by more than ~75 degrees are rejected
+    constexpr double FLIP_THRESHOLD = 0.25;
+
+    enum class PositionKind : uint8_t
+    {
+        Manifold,
+        Border,
+        Locked
+    };
+
+    //Sum of squared distances to a set of planes, p^T A p + 2 b^T p + c, with A symmetric
+    struct Quadric
+    {
+        double a00{0.0}, a11{0.0}, a22{0.0}, a01{0.0}, a02{0.0}, a12{0.0};
+        double b0{0.0}, b1{0.0}, b2{0.0};
+        double c{0.0};
+        double weight{0.0};
+
+        void addPlane(const glm::dvec3& normal, double distance, double planeWeight)
+        {
+            a00 += planeWeight * normal.x * normal.x;
+            a11 += planeWeight * normal.y * normal.y;
+            a22 += planeWeight * normal.z * normal.z;
+            a01 += planeWeight * normal.x * normal.y;
+            a02 += planeWeight * normal.x * normal.z;
+            a12 += planeWeight * normal.y * normal.z;
+            b0 += planeWeight * normal.x * distance;
+            b1 += planeWeight * normal.y * distance;
+            b2 += planeWeight * normal.z * distance;
+            c += planeWeight * distance * distance;
+            weight += planeWeight;
+        }
+
+        void add(const Quadric& other)
+        {
+            a00 += other.a00; a11 += other.a11; a22 += other.a22;
+            a01 += other.a01; a02 += other.a02; a12 += other.a12;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        [[nodiscard]] double evaluate(const glm::dvec3& point) const
+        {
+            const double x = a00 * point.x + a01 * point.y + a02 * point.z;
+            const double y = a01 * point.x + a11 * point.y + a12 * point.z;
+            const double z = a02 * point.x + a12 * point.y + a22 * point.z;
+
+            return point.x * x + point.y * y + point.z * z + 2.0 * (b0 * point.x + b1 * point.y + b2 * point.z) + c;
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+
+    uint64_t getEdgeKey(uint32_t first, uint32_t second)
+    {
+        return first < second ? (static_cast<uint64_t>(first) << 32) | second : (static_cast<uint64_t>(second) << 32) | first;
+    }
+
+    //Positions shared by several vertices (seams) get one id, the topology is analysed on those ids
+    std::vector<uint32_t> buildPositionIds(std::span<const common::Vertex> vertices, std::vector<glm::dvec3>& positions)
+    {
+        std::unordered_map<std::string_view, uint32_t> uniquePositions;
+        uniquePositions.reserve(vertices.size());
+
+        std::vector<uint32_t> positionIds(vertices.size());
+
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); ++vertexIndex)
+        {
+            const std::string_view key(reinterpret_cast<const char*>(&vertices[vertexIndex].position), sizeof(glm::vec3));
+            const auto [it, inserted] = uniquePositions.try_emplace(key, static_cast<uint32_t>(positions.size()));
+
+            if (inserted)
+                positions.emplace_back(vertices[vertexIndex].position);
+
+            positionIds[vertexIndex] = it->second;
+        }
+
+        return positionIds;
+    }
+
+    std::vector<Quadric> buildQuadrics(std::span<const unsigned int> indices, const std::vector<uint32_t>& positionIds, const std::vector<glm::dvec3>& positions)
+    {
+        std::vector<Quadric> quadrics(positions.size());
+        std::unordered_map<uint64_t, uint32_t> edgeCounts;
+
+        for (size_t triangle = 0; triangle < indices.size() / 3; ++triangle)
+        {
+            const uint32_t ids[3] = {positionIds[indices[triangle * 3]], positionIds[indices[triangle * 3 + 1]], positionIds[indices[triangle * 3 + 2]]};
+
+            const glm::dvec3 cross = glm::cross(positions[ids[1]] - positions[ids[0]], positions[ids[2]] - positions[ids[0]]);
+            const double length = glm::length(cross);
+
+            if (length <= 0.0)
+                continue;
+
+            const glm::dvec3 normal = cross / length;
+            const double distance = -glm::dot(normal, positions[ids[0]]);
+
+            for (const uint32_t id : ids)
+                quadrics[id].addPlane(normal, distance, length * 0.5);
+
+            for (int corner = 0; corner < 3; ++corner)
+                ++edgeCounts[getEdgeKey(ids[corner], ids[(corner + 1) % 3])];
+        }
+
+        //Planes through every border edge, perpendicular to its triangle
+        for (size_t triangle = 0; triangle < indices.size() / 3; ++triangle)
+        {
+            const uint32_t ids[3] = {positionIds[indices[triangle * 3]], positionIds[indices[triangle * 3 + 1]], positionIds[indices[triangle * 3 + 2]]};
+
+            const glm::dvec3 cross = glm::cross(positions[ids[1]] - positions[ids[0]], positions[ids[2]] - positions[ids[0]]);
+
+            if (glm::length(cross) <= 0.0)
+                continue;
+
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t first = ids[corner];
+                const uint32_t second = ids[(corner + 1) % 3];
+
+                if (edgeCounts[getEdgeKey(first, second)] != 1)
+                    continue;
+
+                const glm::dvec3 edge = positions[second] - positions[first];
+                const glm::dvec3 borderCross = glm::cross(edge, glm::normalize(cross));
+                const double borderLength = glm::length(borderCross);
+
+                if (borderLength <= 0.0)
+                    continue;
+
+                const glm::dvec3 normal = borderCross / borderLength;
+                const double distance = -glm::dot(normal, positions[first]);
+                const double weight = glm::dot(edge, edge) * BORDER_WEIGHT;
+
+                quadrics[first].addPlane(normal, distance, weight);
+                quadrics[second].addPlane(normal, distance, weight);
+            }
+        }
+
+        return quadrics;
+    }
+
+    double getCollapseCost(const std::vector<Quadric>& quadrics, const std::vector<glm::dvec3>& positions, uint32_t from, uint32_t to)
+    {
+        const double weight = quadrics[from].weight + quadrics[to].weight;
+
+        if (weight <= 0.0)
+            return 0.0;
+
+        return std::max(0.0, (quadrics[from].evaluate(positions[to]) + quadrics[to].evaluate(positions[to])) / weight);
+    }
+} //namespace
+
+std::vector<unsigned int> elix::MeshSimplifier::simplify(std::span<const unsigned int> indices, std::span<const common::Vertex> vertices,
+                                                         size_t targetIndexCount, float targetError, float* resultError)
+{
+    std::vector<unsigned int> result(indices.begin(), indices.end());
+
+    if (resultError)
+        *resultError = 0.0f;
+
+    if (result.size() <= targetIndexCount || vertices.empty())
+        return result;
+
+    std::vector<glm::dvec3> positions;
+    const std::vector<uint32_t> positionIds = buildPositionIds(vertices, positions);
+    std::vector<Quadric> quadrics = buildQuadrics(indices, positionIds, positions);
+
+    const size_t positionCount = positions.size();
+    const size_t targetTriangles = targetIndexCount / 3;
+    const double maxCost = static_cast<double>(targetError) * static_cast<double>(targetError);
+
+    std::vector<uint32_t> collapseTargets(vertices.size());
+    std::vector<uint32_t> triangleOffsets(positionCount + 1);
+    std::vector<uint32_t> positionTriangles;
+    std::vector<PositionKind> kinds(positionCount);
+    std::vector<bool> isTouched(positionCount);
+    std::unordered_map<uint64_t, uint32_t> edgeCounts;
+    std::vector<Collapse> collapses;
+
+    std::vector<std::pair<uint32_t, uint32_t>> wedgeMapping;
+    std::vector<uint32_t> fromNeighbours;
+    std::vector<uint32_t> toNeighbours;
+
+    double largestCost = 0.0;
+
+    while (result.size() / 3 > targetTriangles)
+    {
+        const size_t triangleCount = result.size() / 3;
+        auto positionOf = [&](size_t corner) { return positionIds[result[corner]]; };
+
+        //Triangles around every position
+        std::ranges::fill(triangleOffsets, 0);
+
+        for (size_t corner = 0; corner < result.size(); ++corner)
+            ++triangleOffsets[positionOf(corner) + 1];
+
+        for (size_t position = 0; position < positionCount; ++position)
+            triangleOffsets[position + 1] += triangleOffsets[position];
+
+        positionTriangles.resize(result.size());
+        std::vector<uint32_t> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+
+        for (size_t corner = 0; corner < result.size(); ++corner)
+            positionTriangles[fill[positionOf(corner)]++] = static_cast<uint32_t>(corner / 3);
+
+        edgeCounts.clear();
+
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+            for (size_t corner = 0; corner < 3; ++corner)
+                ++edgeCounts[getEdgeKey(positionOf(triangle * 3 + corner), positionOf(triangle * 3 + (corner + 1) % 3))];
+
+        std::ranges::fill(kinds, PositionKind::Manifold);
+
+        for (const auto& [key, count] : edgeCounts)
+        {
+            const auto first = static_cast<uint32_t>(key >> 32);
+            const auto second = static_cast<uint32_t>(key & 0xFFFFFFFF);
+
+            for (const uint32_t position : {first, second})
+                if (count > 2)
+                    kinds[position] = PositionKind::Locked;
+                else if (count == 1 && kinds[position] != PositionKind::Locked)
+                    kinds[position] = PositionKind::Border;
+        }
+
+        auto canCollapse = [&](uint32_t from, uint32_t to, uint32_t edgeCount)
+        {
+            if (kinds[from] == PositionKind::Locked)
+                return false;
+
+            //Borders only slide along themselves
+            if (kinds[from] == PositionKind::Border)
+                return edgeCount == 1 && kinds[to] != PositionKind::Manifold;
+
+            return true;
+        };
+
+        collapses.clear();
+
+        for (const auto& [key, count] : edgeCounts)
+        {
+            const auto first = static_cast<uint32_t>(key >> 32);
+            const auto second = static_cast<uint32_t>(key & 0xFFFFFFFF);
+
+            const bool canCollapseFirst = canCollapse(first, second, count);
+            const bool canCollapseSecond = canCollapse(second, first, count);
+
+            if (!canCollapseFirst && !canCollapseSecond)
+                continue;
+
+            const double firstCost = canCollapseFirst ? getCollapseCost(quadrics, positions, first, second) : std::numeric_limits<double>::max();
+            const double secondCost = canCollapseSecond ? getCollapseCost(quadrics, positions, second, first) : std::numeric_limits<double>::max();
+
+            if (firstCost <= secondCost)
+                collapses.push_back({first, second, firstCost});
+            else
+                collapses.push_back({second, first, secondCost});
+        }
+
+        std::ranges::sort(collapses, {}, &Collapse::cost);
+
+        for (size_t vertex = 0; vertex < collapseTargets.size(); ++vertex)
+            collapseTargets[vertex] = static_cast<uint32_t>(vertex);
+
+        std::fill(isTouched.begin(), isTouched.end(), false);
+
+        const size_t trianglesToRemove = triangleCount - targetTriangles;
+        size_t removedTriangles = 0;
+        size_t collapseCount = 0;
+
+        for (const auto& collapse : collapses)
+        {
+            if (removedTriangles >= trianglesToRemove || collapse.cost > maxCost)
+                break;
+
+            if (isTouched[collapse.from] || isTouched[collapse.to])
+                continue;
+
+            const auto fromTriangles = std::span(positionTriangles).subspan(triangleOffsets[collapse.from], triangleOffsets[collapse.from + 1] - triangleOffsets[collapse.from]);
+
+            //Every vertex at the collapsed position needs exactly one vertex at the target it shares an edge with, that is
+            //where its triangles go. Vertices whose triangles do not touch the target have nowhere to go
+            wedgeMapping.clear();
+            fromNeighbours.clear();
+            bool isValid = true;
+
+            for (const uint32_t triangle : fromTriangles)
+            {
+                uint32_t fromVertex = UINT32_MAX;
+                uint32_t toVertex = UINT32_MAX;
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex = result[triangle * 3 + corner];
+
+                    if (positionIds[vertex] == collapse.from)
+                        fromVertex = vertex;
+                    else if (positionIds[vertex] == collapse.to)
+                        toVertex = vertex;
+                    else
+                        fromNeighbours.push_back(positionIds[vertex]);
+                }
+
+                auto mapping = std::ranges::find(wedgeMapping, fromVertex, &std::pair<uint32_t, uint32_t>::first);
+
+                if (mapping == wedgeMapping.end())
+                    wedgeMapping.emplace_back(fromVertex, toVertex);
+                else if (mapping->second == UINT32_MAX)
+                    mapping->second = toVertex;
+                else if (toVertex != UINT32_MAX && mapping->second != toVertex)
+                    isValid = false;
+            }
+
+            for (const auto& [fromVertex, toVertex] : wedgeMapping)
+                if (toVertex == UINT32_MAX)
+                    isValid = false;
+
+            if (!isValid)
+                continue;
+
+            //Link condition, the two positions may only share the neighbours of the collapsed edge itself or the
+            //collapse pinches the surface
+            toNeighbours.clear();
+
+            for (uint32_t offset = triangleOffsets[collapse.to]; offset < triangleOffsets[collapse.to + 1]; ++offset)
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t position = positionOf(positionTriangles[offset] * 3 + corner);
+
+                    if (position != collapse.to && position != collapse.from)
+                        toNeighbours.push_back(position);
+                }
+
+            std::ranges::sort(fromNeighbours);
+            fromNeighbours.erase(std::ranges::unique(fromNeighbours).begin(), fromNeighbours.end());
+            std::ranges::sort(toNeighbours);
+            toNeighbours.erase(std::ranges::unique(toNeighbours).begin(), toNeighbours.end());
+
+            size_t sharedNeighbours = 0;
+
+            for (const uint32_t position : fromNeighbours)
+                if (std::ranges::binary_search(toNeighbours, position))
+                    ++sharedNeighbours;
+
+            if (sharedNeighbours != edgeCounts[getEdgeKey(collapse.from, collapse.to)])
+                continue;
+
+            //Remaining triangles must not flip or fold over
+            for (const uint32_t triangle : fromTriangles)
+            {
+                glm::dvec3 before[3];
+                glm::dvec3 after[3];
+                bool hasTarget = false;
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t position = positionOf(triangle * 3 + corner);
+
+                    hasTarget |= position == collapse.to;
+                    before[corner] = positions[position];
+                    after[corner] = position == collapse.from ? positions[collapse.to] : positions[position];
+                }
+
+                if (hasTarget)
+                    continue;
+
+                const glm::dvec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                const glm::dvec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+                if (glm::dot(normalBefore, normalAfter) <= FLIP_THRESHOLD * glm::length(normalBefore) * glm::length(normalAfter))
+                {
+                    isValid = false;
+                    break;
+                }
+            }
+
+            if (!isValid)
+                continue;
+
+            for (const auto& [fromVertex, toVertex] : wedgeMapping)
+                collapseTargets[fromVertex] = toVertex;
+
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+
+            //Everything around the collapsed position changed, it waits for the next pass
+            isTouched[collapse.from] = true;
+            isTouched[collapse.to] = true;
+
+            for (const uint32_t position : fromNeighbours)
+                isTouched[position] = true;
+
+            largestCost = std::max(largestCost, collapse.cost);
+            removedTriangles += edgeCounts[getEdgeKey(collapse.from, collapse.to)];
+            ++collapseCount;
+        }
+
+        if (collapseCount == 0)
+            break;
+
+        size_t writeIndex = 0;
+
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const uint32_t a = collapseTargets[result[triangle * 3]];
+            const uint32_t b = collapseTargets[result[triangle * 3 + 1]];
+            const uint32_t c = collapseTargets[result[triangle * 3 + 2]];
+
+            if (positionIds[a] == positionIds[b] || positionIds[b] == positionIds[c] || positionIds[a] == positionIds[c])
+                continue;
+
+            result[writeIndex++] = a;
+            result[writeIndex++] = b;
+            result[writeIndex++] = c;
+        }
+
+        result.resize(writeIndex);
+    }
+
+    if (resultError)
+        *resultError = static_cast<float>(std::sqrt(largestCost));
+
+    return result;
+}
+
+void elix::MeshSimplifier::generateLods(common::MeshData &mesh)
+{
+    mesh.lods.clear();
+
+    if (mesh.vertices.empty() || mesh.indices.empty())
+        return;
+
+    common::BoundingBox bounds{mesh.vertices.front().position, mesh.vertices.front().position};
+
+    for (const auto& vertex : mesh.vertices)
+    {
+        bounds.min = glm::min(bounds.min, vertex.position);
+        bounds.max = glm::max(bounds.max, vertex.position);
+    }
+
+    const float maxError = bounds.getRadius() * MAX_RELATIVE_ERROR;
+
+    size_t targetIndexCount = mesh.indices.size();
+    size_t previousIndexCount = mesh.indices.size();
+    float previousError = 0.0f;
+
+    for (size_t level = 0; level < MAX_LODS; ++level)
+    {
+        targetIndexCount = static_cast<size_t>(static_cast<float>(targetIndexCount / 3) * LOD_REDUCTION) * 3;
+
+        //Every level starts from the source mesh so the quadrics measure the distance to the real surface
+        float error = 0.0f;
+        auto indices = simplify(mesh.indices, mesh.vertices, targetIndexCount, maxError, &error);
+
+        //Not worth a level of its own, the error bound or the topology stopped the simplifier
+        if (indices.empty() || static_cast<float>(indices.size()) > static_cast<float>(previousIndexCount) * 0.9f)
+            break;
+
+        MeshOptimizer::optimizeVertexCache(indices, mesh.vertices.size());
+
+        previousIndexCount = indices.size();
+        previousError = std::max(previousError, error);
+
+        mesh.lods.push_back({std::move(indices), previousError});
+    }
+}
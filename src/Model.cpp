@@ -1,8 +1,22 @@
 #include "Model.hpp"
 #include "ShaderManager.hpp"
 
+#include <algorithm>
+
 elix::Model::Model(const std::string &name, const std::vector<elix::Mesh> &meshes, std::unique_ptr<Skeleton> skeleton): m_name(name), m_meshes(meshes)
 {
+    bool isFirstVertex = true;
+
+    for (const auto& mesh : m_meshes)
+        for (size_t vertexIndex = 0; vertexIndex < mesh.getVertexCount(); ++vertexIndex)
+        {
+            const glm::vec3 position = VertexFormat::getPosition(mesh.getVertexData(), mesh.getVertexLayout(), vertexIndex);
+
+            m_boundingBox.min = isFirstVertex ? position : glm::min(m_boundingBox.min, position);
+            m_boundingBox.max = isFirstVertex ? position : glm::max(m_boundingBox.max, position);
+            isFirstVertex = false;
+        }
+
     if (skeleton)
     {
         m_skeleton = std::move(skeleton);
@@ -10,10 +24,22 @@ elix::Model::Model(const std::string &name, const std::vector<elix::Mesh> &meshe
     }
 }
 
-void elix::Model::draw() const
+elix::Model::~Model()
+{
+    for (auto& mesh : m_meshes)
+        mesh.release();
+}
+
+void elix::Model::draw(size_t lod) const
 {
     for (auto& mesh : m_meshes)
-        mesh.draw();
+        mesh.draw(lod);
+}
+
+void elix::Model::bake()
+{
+    for (auto& mesh : m_meshes)
+        mesh.bake();
 }
 
 void elix::Model::addAnimation(common::Animation *animation)
@@ -45,7 +71,7 @@ Skeleton * elix::Model::getSkeleton() const
     return m_skeleton.get();
 }
 
-void elix::Model::drawWithMaterials(std::unordered_map<int, Material *> &materials) const
+void elix::Model::drawWithMaterials(std::unordered_map<int, Material *> &materials, size_t lod) const
 {
     const auto shader = ShaderManager::instance().getShader( hasSkeleton() ? ShaderManager::ShaderType::SKELETON : ShaderManager::ShaderType::STATIC);
 
@@ -63,10 +89,30 @@ void elix::Model::drawWithMaterials(std::unordered_map<int, Material *> &materia
 
         material->bind(*shader);
 
-        mesh.draw();
+        mesh.draw(lod);
     }
 }
 
+size_t elix::Model::getLodCount() const
+{
+    size_t lodCount = 1;
+
+    for (const auto& mesh : m_meshes)
+        lodCount = std::max(lodCount, mesh.getLodCount());
+
+    return lodCount;
+}
+
+float elix::Model::getLodError(size_t lod) const
+{
+    float error = 0.0f;
+
+    for (const auto& mesh : m_meshes)
+        error = std::max(error, mesh.getLod(lod).error);
+
+    return error;
+}
+
 std::string elix::Model::getName() const
 {
     return m_name;
@@ -82,7 +128,17 @@ elix::Mesh * elix::Model::getMesh(const int meshIndex)
     return &m_meshes[meshIndex];
 }
 
+const std::vector<elix::Mesh>& elix::Model::getMeshes() const
+{
+    return m_meshes;
+}
+
 bool elix::Model::hasSkeleton() const
 {
     return m_skeleton != nullptr;
 }
+
+const common::BoundingBox& elix::Model::getBoundingBox() const
+{
+    return m_boundingBox;
+}
@@ -0,0 +1,363 @@
+#include "ModelCooker.hpp"
+
+#include "AssetsLoader.hpp"
+#include "Logger.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "Skeleton.hpp"
+#include "VertexFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace
+{
+    class BlobWriter
+    {
+    public:
+        template<typename T>
+        uint64_t append(const T* data, size_t count)
+        {
+            const uint64_t offset = m_bytes.size();
+            const size_t size = sizeof(T) * count;
+
+            m_bytes.resize(offset + size);
+
+            if (size > 0)
+                std::memcpy(m_bytes.data() + offset, data, size);
+
+            return offset;
+        }
+
+        void align(size_t alignment)
+        {
+            m_bytes.resize((m_bytes.size() + alignment - 1) / alignment * alignment, 0);
+        }
+
+        template<typename T>
+        T* at(uint64_t offset)
+        {
+            return reinterpret_cast<T*>(m_bytes.data() + offset);
+        }
+
+        [[nodiscard]] uint64_t size() const { return m_bytes.size(); }
+        [[nodiscard]] const std::vector<char>& bytes() const { return m_bytes; }
+    private:
+        std::vector<char> m_bytes;
+    };
+
+    //offset + count * elementSize <= size, without overflowing on values read from a file
+    bool isInRange(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size)
+    {
+        return offset <= size && (elementSize == 0 || count <= (size - offset) / elementSize);
+    }
+
+    //Records are read in place, their table also has to be aligned for them
+    template<typename T>
+    bool isTableInRange(uint64_t offset, uint64_t count, uint64_t size)
+    {
+        return offset % alignof(T) == 0 && isInRange(offset, count, sizeof(T), size);
+    }
+
+    size_t getVertexStride(const elix::cooked::MeshRecord& mesh)
+    {
+        return elix::VertexFormat::getStride(mesh.flags & elix::cooked::MESH_FLAG_HAS_BONES ? elix::VertexLayout::Skinned : elix::VertexLayout::Static);
+    }
+
+    size_t getIndexSize(const elix::cooked::MeshRecord& mesh)
+    {
+        return elix::VertexFormat::getIndexSize(mesh.flags & elix::cooked::MESH_FLAG_16BIT_INDICES ? elix::IndexType::UInt16 : elix::IndexType::UInt32);
+    }
+
+    //Stable order of the bone ids with every parent ahead of its children, and the inverse mapping. False if the
+    //hierarchy has a cycle or a parent id outside the skeleton
+    bool getParentsFirstOrder(Skeleton& skeleton, std::vector<int>& order, std::vector<int>& orderIndices)
+    {
+        const int boneCount = static_cast<int>(skeleton.getBonesCount());
+        std::vector<int> depths(boneCount, 0);
+
+        for (int boneIndex = 0; boneIndex < boneCount; ++boneIndex)
+        {
+            for (int parent = skeleton.getBone(boneIndex)->parentId; parent >= 0; parent = skeleton.getBone(parent)->parentId)
+                if (parent >= boneCount || ++depths[boneIndex] >= boneCount)
+                    return false;
+        }
+
+        order.resize(boneCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::stable_sort(order, [&depths](int a, int b) {return depths[a] < depths[b];});
+
+        orderIndices.resize(boneCount);
+
+        for (int index = 0; index < boneCount; ++index)
+            orderIndices[order[index]] = index;
+
+        return true;
+    }
+
+    class StringTable
+    {
+    public:
+        std::pair<uint32_t, uint32_t> add(const std::string& string)
+        {
+            const auto offset = static_cast<uint32_t>(m_data.size());
+            m_data += string;
+            return {offset, static_cast<uint32_t>(string.size())};
+        }
+
+        [[nodiscard]] const std::string& data() const { return m_data; }
+    private:
+        std::string m_data;
+    };
+} //namespace
+
+bool elix::ModelCooker::cook(const std::string &sourcePath, const std::string &outputPath)
+{
+    std::vector<common::MeshData> meshes;
+    Skeleton skeleton;
+
+    if (!elix::AssetsLoader::importModel(sourcePath, meshes, skeleton))
+    {
+        ELIX_LOG_ERROR("Failed to import model for cooking ", sourcePath);
+        return false;
+    }
+
+    const auto statistics = MeshOptimizer::optimize(meshes);
+
+    ELIX_LOG_INFO("Optimized meshes: vertices ", statistics.vertexCountBefore, " -> ", statistics.vertexCountAfter,
+        ", ACMR ", statistics.acmrBefore, " -> ", statistics.acmrAfter);
+
+    for (auto& mesh : meshes)
+        MeshSimplifier::generateLods(mesh);
+
+    const std::string modelName = std::filesystem::path(sourcePath).filename().string();
+
+    return write(modelName, meshes, skeleton.getBonesCount() > 0 ? &skeleton : nullptr, outputPath);
+}
+
+bool elix::ModelCooker::write(const std::string& modelName, const std::vector<common::MeshData> &meshes, Skeleton *skeleton, const std::string &outputPath)
+{
+    static_assert(std::is_trivially_copyable_v<elix::SkinnedVertex>, "Cooked vertices are used in place and must stay trivially copyable");
+
+    if (skeleton && skeleton->getBonesCount() > VertexFormat::MAX_SKINNED_BONES)
+    {
+        ELIX_LOG_ERROR("Model ", modelName, " has ", skeleton->getBonesCount(), " bones, packed vertices address only ", VertexFormat::MAX_SKINNED_BONES);
+        return false;
+    }
+
+    //Bones are written parents first, parse relies on it. Vertices refer to bones by id and follow the new order
+    std::vector<int> boneOrder;
+    std::vector<int> writtenBoneIndices;
+
+    if (skeleton && !getParentsFirstOrder(*skeleton, boneOrder, writtenBoneIndices))
+    {
+        ELIX_LOG_ERROR("Model ", modelName, " has a cyclic bone hierarchy");
+        return false;
+    }
+
+    BlobWriter blob;
+    StringTable strings;
+
+    cooked::ModelHeader header;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.boneCount = skeleton ? static_cast<uint32_t>(skeleton->getBonesCount()) : 0;
+    std::tie(header.nameOffset, header.nameLength) = strings.add(modelName);
+
+    if (skeleton)
+        std::memcpy(header.globalInverseTransform, &skeleton->globalInverseTransform, sizeof(glm::mat4));
+
+    blob.append(&header, 1);
+    blob.align(cooked::SECTION_ALIGNMENT);
+
+    std::vector<cooked::MeshRecord> meshRecords(meshes.size());
+    const uint64_t meshTableOffset = blob.append(meshRecords.data(), meshRecords.size());
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+    {
+        const auto& mesh = meshes[meshIndex];
+        auto& record = meshRecords[meshIndex];
+
+        const VertexLayout vertexLayout = VertexFormat::selectLayout(mesh.vertices);
+
+        if (vertexLayout == VertexLayout::Skinned && !VertexFormat::areBonesPackable(mesh.vertices))
+        {
+            ELIX_LOG_ERROR("Model ", modelName, " has vertices weighted to bones past ", VertexFormat::MAX_SKINNED_BONES - 1);
+            return false;
+        }
+        const IndexType indexType = VertexFormat::selectIndexType(mesh.vertices.size());
+
+        //LOD index buffers follow the full detail one
+        std::vector<unsigned int> allIndices = mesh.indices;
+        std::vector<cooked::LodRecord> lodRecords{{0, static_cast<uint32_t>(mesh.indices.size()), 0.0f}};
+
+        for (const auto& lod : mesh.lods)
+        {
+            lodRecords.push_back({static_cast<uint32_t>(allIndices.size()), static_cast<uint32_t>(lod.indices.size()), lod.error});
+            allIndices.insert(allIndices.end(), lod.indices.begin(), lod.indices.end());
+        }
+
+        std::vector<common::Vertex> remappedVertices;
+
+        if (vertexLayout == VertexLayout::Skinned && skeleton)
+        {
+            remappedVertices = mesh.vertices;
+
+            for (auto& vertex : remappedVertices)
+                for (int i = 0; i < 4; ++i)
+                    if (vertex.boneID[i] >= 0 && vertex.boneID[i] < static_cast<int>(writtenBoneIndices.size()))
+                        vertex.boneID[i] = writtenBoneIndices[vertex.boneID[i]];
+        }
+
+        const auto vertices = VertexFormat::packVertices(remappedVertices.empty() ? std::span<const common::Vertex>(mesh.vertices) : remappedVertices, vertexLayout);
+        const auto indices = VertexFormat::packIndices(allIndices, indexType);
+
+        blob.align(cooked::SECTION_ALIGNMENT);
+        record.vertexOffset = blob.append(vertices.data(), vertices.size());
+        record.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+
+        blob.align(cooked::SECTION_ALIGNMENT);
+        record.indexOffset = blob.append(indices.data(), indices.size());
+        record.indexCount = static_cast<uint32_t>(allIndices.size());
+
+        blob.align(cooked::SECTION_ALIGNMENT);
+        record.lodTableOffset = blob.append(lodRecords.data(), lodRecords.size());
+        record.lodCount = static_cast<uint32_t>(lodRecords.size());
+
+        std::tie(record.materialSlotOffset, record.materialSlotLength) = strings.add(mesh.materialSlot);
+
+        if (vertexLayout == VertexLayout::Skinned)
+            record.flags |= cooked::MESH_FLAG_HAS_BONES;
+
+        if (indexType == IndexType::UInt16)
+            record.flags |= cooked::MESH_FLAG_16BIT_INDICES;
+    }
+
+    std::memcpy(blob.at<cooked::MeshRecord>(meshTableOffset), meshRecords.data(), sizeof(cooked::MeshRecord) * meshRecords.size());
+
+    blob.align(cooked::SECTION_ALIGNMENT);
+    const uint64_t boneTableOffset = blob.size();
+
+    for (uint32_t boneIndex = 0; boneIndex < header.boneCount; ++boneIndex)
+    {
+        const auto* bone = skeleton->getBone(boneOrder[boneIndex]);
+
+        cooked::BoneRecord record;
+        std::tie(record.nameOffset, record.nameLength) = strings.add(bone->name);
+        record.parentId = bone->parentId >= 0 ? writtenBoneIndices[bone->parentId] : -1;
+        std::memcpy(record.offsetMatrix, &bone->offsetMatrix, sizeof(glm::mat4));
+        std::memcpy(record.localBindTransform, &bone->localBindTransform, sizeof(glm::mat4));
+        std::memcpy(record.globalBindTransform, &bone->globalBindTransform, sizeof(glm::mat4));
+
+        blob.append(&record, 1);
+    }
+
+    blob.align(cooked::SECTION_ALIGNMENT);
+    const uint64_t stringTableOffset = blob.append(strings.data().data(), strings.data().size());
+
+    auto* finalHeader = blob.at<cooked::ModelHeader>(0);
+    finalHeader->meshTableOffset = meshTableOffset;
+    finalHeader->boneTableOffset = boneTableOffset;
+    finalHeader->stringTableOffset = stringTableOffset;
+    finalHeader->stringTableSize = strings.data().size();
+    finalHeader->fileSize = blob.size();
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        ELIX_LOG_ERROR("Failed to open cooked model for writing ", outputPath);
+        return false;
+    }
+
+    file.write(blob.bytes().data(), static_cast<std::streamsize>(blob.size()));
+
+    ELIX_LOG_INFO("Cooked model ", modelName, " into ", outputPath, " (", blob.size(), " bytes)");
+
+    return file.good();
+}
+
+bool elix::ModelCooker::parse(std::span<const std::byte> bytes, ModelView &view)
+{
+    if (bytes.size() < sizeof(cooked::ModelHeader))
+        return false;
+
+    const auto header = reinterpret_cast<const cooked::ModelHeader*>(bytes.data());
+
+    if (header->magic != cooked::MODEL_MAGIC || header->version != cooked::MODEL_VERSION || header->fileSize != bytes.size())
+        return false;
+
+    if (!isTableInRange<cooked::MeshRecord>(header->meshTableOffset, header->meshCount, bytes.size()) ||
+        !isTableInRange<cooked::BoneRecord>(header->boneTableOffset, header->boneCount, bytes.size()) ||
+        !isInRange(header->stringTableOffset, header->stringTableSize, 1, bytes.size()))
+        return false;
+
+    const std::string_view strings(reinterpret_cast<const char*>(bytes.data() + header->stringTableOffset), header->stringTableSize);
+
+    auto isStringInRange = [&strings](uint32_t offset, uint32_t length) { return isInRange(offset, length, 1, strings.size()); };
+
+    if (!isStringInRange(header->nameOffset, header->nameLength))
+        return false;
+
+    const std::span meshes(reinterpret_cast<const cooked::MeshRecord*>(bytes.data() + header->meshTableOffset), header->meshCount);
+    const std::span bones(reinterpret_cast<const cooked::BoneRecord*>(bytes.data() + header->boneTableOffset), header->boneCount);
+
+    for (const auto& mesh : meshes)
+    {
+        if (!isInRange(mesh.vertexOffset, mesh.vertexCount, getVertexStride(mesh), bytes.size()) ||
+            !isInRange(mesh.indexOffset, mesh.indexCount, getIndexSize(mesh), bytes.size()) ||
+            !isTableInRange<cooked::LodRecord>(mesh.lodTableOffset, mesh.lodCount, bytes.size()) ||
+            !isStringInRange(mesh.materialSlotOffset, mesh.materialSlotLength))
+            return false;
+
+        const std::span lods(reinterpret_cast<const cooked::LodRecord*>(bytes.data() + mesh.lodTableOffset), mesh.lodCount);
+
+        for (const auto& lod : lods)
+            if (!isInRange(lod.indexOffset, lod.indexCount, 1, mesh.indexCount))
+                return false;
+
+        //Everything downstream indexes the vertices with these unchecked
+        const auto indices = bytes.subspan(mesh.indexOffset, mesh.indexCount * getIndexSize(mesh));
+        const IndexType indexType = mesh.flags & cooked::MESH_FLAG_16BIT_INDICES ? IndexType::UInt16 : IndexType::UInt32;
+
+        for (size_t index = 0; index < mesh.indexCount; ++index)
+            if (VertexFormat::getIndex(indices, indexType, index) >= mesh.vertexCount)
+                return false;
+    }
+
+    //Parents come first, which also rules out cycles in the hierarchy
+    for (uint32_t boneIndex = 0; boneIndex < bones.size(); ++boneIndex)
+        if (!isStringInRange(bones[boneIndex].nameOffset, bones[boneIndex].nameLength) || bones[boneIndex].parentId < -1 ||
+            bones[boneIndex].parentId >= static_cast<int64_t>(boneIndex))
+            return false;
+
+    view.header = header;
+    view.meshes = meshes;
+    view.bones = bones;
+    view.strings = strings;
+    view.bytes = bytes;
+
+    return true;
+}
+
+std::span<const std::byte> elix::ModelCooker::ModelView::getVertices(const cooked::MeshRecord &mesh) const
+{
+    return bytes.subspan(mesh.vertexOffset, mesh.vertexCount * getVertexStride(mesh));
+}
+
+std::span<const std::byte> elix::ModelCooker::ModelView::getIndices(const cooked::MeshRecord &mesh) const
+{
+    return bytes.subspan(mesh.indexOffset, mesh.indexCount * getIndexSize(mesh));
+}
+
+std::span<const elix::cooked::LodRecord> elix::ModelCooker::ModelView::getLods(const cooked::MeshRecord &mesh) const
+{
+    return {reinterpret_cast<const cooked::LodRecord*>(bytes.data() + mesh.lodTableOffset), mesh.lodCount};
+}
+
+std::string_view elix::ModelCooker::ModelView::getString(uint32_t offset, uint32_t length) const
+{
+    return strings.substr(offset, length);
+}
@@ -0,0 +1,160 @@
+#include "Registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+elix::ComponentTypeId elix::ComponentTypes::next()
+{
+    static std::atomic<ComponentTypeId> counter{0};
+
+    const ComponentTypeId id = counter++;
+
+    //Signatures and column tables are sized for MAX_COMPONENT_TYPES, an id past it can not be used at all
+    if (id >= MAX_COMPONENT_TYPES)
+        throw std::length_error("ComponentTypes::next(): more than " + std::to_string(MAX_COMPONENT_TYPES) + " component types, raise MAX_COMPONENT_TYPES");
+
+    return id;
+}
+
+elix::Archetype::Archetype()
+{
+    m_columnIndices.fill(-1);
+}
+
+elix::Registry& elix::Registry::instance()
+{
+    //Never destroyed, GameObjects kept alive by other statics may still release their entities on exit
+    static auto* instance = new Registry();
+    return *instance;
+}
+
+elix::Registry::Registry()
+{
+    //Entities without components live in the first archetype
+    m_archetypes.push_back(std::make_unique<Archetype>());
+    m_archetypeIndices[Signature{}] = 0;
+}
+
+elix::Entity elix::Registry::create()
+{
+    uint32_t index;
+
+    if (!m_freeIndices.empty())
+    {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    Record& record = m_records[index];
+    record.archetype = 0;
+    record.row = static_cast<uint32_t>(m_archetypes[0]->m_entities.size());
+    record.isAlive = true;
+
+    const Entity entity{index, record.generation};
+    m_archetypes[0]->m_entities.push_back(entity);
+    ++m_entityCount;
+
+    return entity;
+}
+
+void elix::Registry::destroy(Entity entity)
+{
+    if (!isAlive(entity))
+        return;
+
+    Record& record = m_records[entity.index];
+    Archetype& archetype = *m_archetypes[record.archetype];
+    const uint32_t row = record.row;
+
+    //Marked dead first so components destroyed below can not reach back into a half removed row
+    record.isAlive = false;
+    ++record.generation;
+
+    for (const auto& column : archetype.m_columns)
+        column->swapRemove(row);
+
+    archetype.m_entities[row] = archetype.m_entities.back();
+    archetype.m_entities.pop_back();
+
+    if (row < archetype.m_entities.size())
+        m_records[archetype.m_entities[row].index].row = row;
+
+    m_freeIndices.push_back(entity.index);
+    --m_entityCount;
+}
+
+bool elix::Registry::isAlive(Entity entity) const
+{
+    return entity.index < m_records.size() && m_records[entity.index].isAlive && m_records[entity.index].generation == entity.generation;
+}
+
+uint32_t elix::Registry::findArchetype(const Signature &signature, uint32_t source, ComponentTypeId changedType, ColumnFactory createColumn)
+{
+    if (const auto it = m_archetypeIndices.find(signature); it != m_archetypeIndices.end())
+        return it->second;
+
+    const Archetype& from = *m_archetypes[source];
+    auto archetype = std::make_unique<Archetype>();
+    archetype->m_signature = signature;
+
+    for (ComponentTypeId type = 0; type < MAX_COMPONENT_TYPES; ++type)
+    {
+        if (!signature.test(type))
+            continue;
+
+        archetype->m_columnIndices[type] = static_cast<int8_t>(archetype->m_columns.size());
+        archetype->m_types.push_back(type);
+        archetype->m_columns.push_back(type == changedType ? createColumn() : from.m_columns[from.m_columnIndices[type]]->createEmpty());
+    }
+
+    const auto index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(archetype));
+    m_archetypeIndices[signature] = index;
+
+    return index;
+}
+
+void elix::Registry::move(Entity entity, uint32_t target)
+{
+    Record& record = m_records[entity.index];
+    Archetype& from = *m_archetypes[record.archetype];
+    Archetype& to = *m_archetypes[target];
+    const uint32_t row = record.row;
+
+    for (size_t column = 0; column < from.m_columns.size(); ++column)
+    {
+        const ComponentTypeId type = from.m_types[column];
+
+        if (to.has(type))
+            to.m_columns[to.m_columnIndices[type]]->moveFrom(*from.m_columns[column], row);
+
+        //Moved out components are empty husks now, dropped ones are destroyed here
+        from.m_columns[column]->swapRemove(row);
+    }
+
+    from.m_entities[row] = from.m_entities.back();
+    from.m_entities.pop_back();
+
+    if (row < from.m_entities.size())
+        m_records[from.m_entities[row].index].row = row;
+
+    record.archetype = target;
+    record.row = static_cast<uint32_t>(to.m_entities.size());
+    to.m_entities.push_back(entity);
+}
+
+size_t elix::Registry::getEntityCount() const
+{
+    return m_entityCount;
+}
+
+size_t elix::Registry::getArchetypeCount() const
+{
+    return m_archetypes.size();
+}
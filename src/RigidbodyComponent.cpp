@@ -1,6 +1,14 @@
 #include "RigidbodyComponent.hpp"
 #include "GameObject.hpp"
 #include <iostream>
+#include <mutex>
+
+namespace
+{
+    //Thread safe scripts move their owners in parallel. PhysX takes no locks of its own, so writes to the scene from
+    //those jobs are serialized here
+    std::mutex g_poseMutex;
+} //namespace
 
 RigidbodyComponent::RigidbodyComponent(const std::shared_ptr<GameObject> &object)
 {
@@ -10,6 +18,9 @@ RigidbodyComponent::RigidbodyComponent(const std::shared_ptr<GameObject> &object
         std::cerr << "RigidbodyComponent::RigidbodyComponent(): Failed to create physics body actor" << std::endl;
 
     object->setPositionChangedCallback(std::bind(&RigidbodyComponent::onOwnerPositionChanged, this, std::placeholders::_1));
+
+    //Pose sync back from PhysX, the simulation itself keeps its own step
+    setTickBudget({15.0f, 0.5f});
 }
 
 void RigidbodyComponent::update(float deltaTime)
@@ -45,5 +56,6 @@ void RigidbodyComponent::onOwnerPositionChanged(const glm::vec3& position)
     if (!m_rigidActor)
         return;
 
+    std::lock_guard<std::mutex> lock(g_poseMutex);
     m_rigidActor->setGlobalPose({position.x, position.y, position.z});
 }
@@ -1,13 +1,78 @@
 #include "Scene.hpp"
 
-Scene::Scene() = default;
+#include "AnimationSystem.hpp"
+#include "SkinnedRenderer.hpp"
+#include "SkinningCache.hpp"
+#include "TransformSystem.hpp"
+#include "VertexAnimationRenderer.hpp"
 
-Scene::~Scene() = default;
+namespace
+{
+    template<typename Key>
+    uint32_t addToBucket(std::unordered_map<Key, std::vector<elix::Entity>>& index, const Key& key, elix::Entity entity)
+    {
+        auto& bucket = index[key];
+        bucket.push_back(entity);
 
-void Scene::update(float deltaTime)
+        return static_cast<uint32_t>(bucket.size() - 1);
+    }
+
+    //Swap and pop, the entity moved into the hole gets its position in records updated
+    template<typename Key, typename Record>
+    void removeFromBucket(std::unordered_map<Key, std::vector<elix::Entity>>& index, const Key& key, uint32_t position,
+                          std::vector<Record>& records, uint32_t Record::* field)
+    {
+        const auto it = index.find(key);
+
+        if (it == index.end())
+            return;
+
+        auto& bucket = it->second;
+        const elix::Entity moved = bucket.back();
+
+        bucket[position] = moved;
+        records[moved.index].*field = position;
+        bucket.pop_back();
+
+        if (bucket.empty())
+            index.erase(it);
+    }
+} //namespace
+
+Scene::Scene()
+{
+    namespace Resource = elix::Resource;
+
+    //Engine systems, after the component jobs of their phase
+    m_scheduler.addSystem("AnimationSystem", elix::UpdatePhase::Animation, {Resource::SCENE, Resource::ANIMATION},
+                          [this](float) { elix::AnimationSystem::update(m_objects); });
+
+    //Setters only flagged their nodes, world matrices are brought up to date once before anything reads them. The
+    //changed callbacks used to run from the setters on the app's thread and are free to touch anything, so the system
+    //stays on the calling thread. Large levels are still split over the pool inside update
+    m_scheduler.addSystem("TransformSystem", elix::UpdatePhase::Transform,
+                          {Resource::TRANSFORMS, Resource::TRANSFORMS | Resource::LIGHTS | Resource::OPENGL},
+                          [](float) { elix::TransformSystem::update(); });
+
+    const elix::Access renderPreparation{Resource::SCENE | Resource::ANIMATION | Resource::TRANSFORMS, Resource::RENDERING | Resource::OPENGL};
+
+    m_scheduler.addSystem("SkinningCache", elix::UpdatePhase::Late, renderPreparation, [this](float) { elix::SkinningCache::update(m_objects); });
+    m_scheduler.addSystem("SkinnedRenderer", elix::UpdatePhase::Late, renderPreparation, [this](float) { elix::SkinnedRenderer::update(m_objects); });
+    m_scheduler.addSystem("VertexAnimationRenderer", elix::UpdatePhase::Late, renderPreparation,
+                          [this](float) { elix::VertexAnimationRenderer::update(m_objects); });
+}
+
+Scene::~Scene()
 {
     for (const auto& object : m_objects)
-        object->update(deltaTime);
+        object->m_scene = nullptr;
+}
+
+void Scene::update(float deltaTime)
+{
+    m_scheduler.run(m_objects, deltaTime);
+
+    destroyDeletedObjects();
 }
 
 void Scene::setSkybox(const std::shared_ptr<elix::Skybox> &skybox)
@@ -22,7 +87,19 @@ std::shared_ptr<elix::Skybox> Scene::getSkybox() const
 
 void Scene::addGameObject(const std::shared_ptr<GameObject>& gameObject)
 {
+    if (!gameObject || gameObject->m_scene)
+        return;
+
+    const elix::Entity entity = gameObject->getEntity();
+
+    if (m_records.size() <= entity.index)
+        m_records.resize(entity.index + 1);
+
+    m_records[entity.index] = {static_cast<uint32_t>(m_objects.size())};
     m_objects.push_back(gameObject);
+
+    gameObject->m_scene = this;
+    addToIndices(*gameObject);
 }
 
 void Scene::addDrawable(const std::shared_ptr<Drawable> &drawable)
@@ -32,33 +109,152 @@ void Scene::addDrawable(const std::shared_ptr<Drawable> &drawable)
 
 void Scene::setGameObjects(const std::vector<std::shared_ptr<GameObject>> &gameObjects)
 {
-    m_objects = gameObjects;
+    for (const auto& object : m_objects)
+        object->m_scene = nullptr;
+
+    m_objects.clear();
+    m_records.clear();
+    m_deletedEntities.clear();
+    m_objectsByName.clear();
+    m_objectsByTag.clear();
+    m_objectsByLayer.clear();
+
+    m_objects.reserve(gameObjects.size());
+
+    for (const auto& object : gameObjects)
+        addGameObject(object);
 }
 
 bool Scene::deleteGameObject(GameObject *gameObject)
 {
-    if (!gameObject)
+    if (!gameObject || gameObject->m_scene != this)
         return false;
 
-    const auto it = std::find_if(m_objects.begin(), m_objects.end(), [&gameObject](const std::shared_ptr<GameObject>& gO)
-    {
-        return gO->getName() == gameObject->getName();
-    });
+    return deleteGameObject(gameObject->getEntity());
+}
 
-    if (it == m_objects.end())
+bool Scene::deleteGameObject(elix::Entity entity)
+{
+    if (!getGameObject(entity) || m_records[entity.index].isDeleted)
         return false;
 
-    it->get()->destroy();
-    m_objects.erase(it);
-    
+    m_records[entity.index].isDeleted = true;
+    m_deletedEntities.push_back(entity);
+
     return true;
 }
 
+void Scene::destroyDeletedObjects()
+{
+    //Destroying an object can delete others, they go in the same flush
+    while (!m_deletedEntities.empty())
+    {
+        const std::vector<elix::Entity> entities = std::move(m_deletedEntities);
+        m_deletedEntities.clear();
+
+        for (const auto& entity : entities)
+            removeGameObject(entity);
+    }
+}
+
+GameObject * Scene::getGameObject(elix::Entity entity) const
+{
+    if (entity.index >= m_records.size() || m_records[entity.index].dense == INVALID_POSITION)
+        return nullptr;
+
+    GameObject* object = m_objects[m_records[entity.index].dense].get();
+
+    return object->getEntity() == entity ? object : nullptr;
+}
+
+GameObject * Scene::findGameObject(const std::string &name) const
+{
+    const auto entities = getEntitiesByName(name);
+
+    return entities.empty() ? nullptr : getGameObject(entities.front());
+}
+
+std::span<const elix::Entity> Scene::getEntitiesByName(const std::string &name) const
+{
+    const auto it = m_objectsByName.find(name);
+
+    return it != m_objectsByName.end() ? std::span<const elix::Entity>(it->second) : std::span<const elix::Entity>{};
+}
+
+std::span<const elix::Entity> Scene::getEntitiesByTag(const std::string &tag) const
+{
+    const auto it = m_objectsByTag.find(tag);
+
+    return it != m_objectsByTag.end() ? std::span<const elix::Entity>(it->second) : std::span<const elix::Entity>{};
+}
+
+std::vector<elix::Entity> Scene::getEntitiesInLayer(common::LayerMask layerMask) const
+{
+    std::vector<elix::Entity> entities;
+
+    //One bucket per distinct mask, there are only a handful
+    for (const auto& [mask, bucket] : m_objectsByLayer)
+        if (mask & layerMask)
+            entities.insert(entities.end(), bucket.begin(), bucket.end());
+
+    return entities;
+}
+
+void Scene::addToIndices(const GameObject &gameObject)
+{
+    const elix::Entity entity = gameObject.getEntity();
+    Record& record = m_records[entity.index];
+
+    record.namePosition = addToBucket(m_objectsByName, gameObject.getName(), entity);
+    record.tagPosition = addToBucket(m_objectsByTag, gameObject.getTag(), entity);
+    record.layerPosition = addToBucket(m_objectsByLayer, static_cast<uint32_t>(gameObject.getLayerMask()), entity);
+}
+
+void Scene::removeFromIndices(const GameObject &gameObject)
+{
+    const Record& record = m_records[gameObject.getEntity().index];
+
+    removeFromBucket(m_objectsByName, gameObject.getName(), record.namePosition, m_records, &Record::namePosition);
+    removeFromBucket(m_objectsByTag, gameObject.getTag(), record.tagPosition, m_records, &Record::tagPosition);
+    removeFromBucket(m_objectsByLayer, static_cast<uint32_t>(gameObject.getLayerMask()), record.layerPosition, m_records, &Record::layerPosition);
+}
+
+void Scene::removeGameObject(elix::Entity entity)
+{
+    GameObject* object = getGameObject(entity);
+
+    if (!object)
+        return;
+
+    const uint32_t dense = m_records[entity.index].dense;
+
+    object->destroy();
+    removeFromIndices(*object);
+    object->m_scene = nullptr;
+
+    //Keeps the object alive until its slot is refilled, it may be the last reference
+    const std::shared_ptr<GameObject> removed = std::move(m_objects[dense]);
+
+    if (dense + 1 != m_objects.size())
+    {
+        m_objects[dense] = std::move(m_objects.back());
+        m_records[m_objects[dense]->getEntity().index].dense = dense;
+    }
+
+    m_objects.pop_back();
+    m_records[entity.index] = {};
+}
+
 const std::vector<std::shared_ptr<GameObject>>& Scene::getGameObjects()
 {
     return m_objects;
 }
 
+elix::Scheduler & Scene::getScheduler()
+{
+    return m_scheduler;
+}
+
 const std::vector<std::shared_ptr<Drawable>>& Scene::getDrawables()
 {
     return m_drawables;
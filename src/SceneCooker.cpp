@@ -0,0 +1,479 @@
+#include "SceneCooker.hpp"
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "MappedFile.hpp"
+#include "ModelCooker.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <json/json.hpp>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    class BlobWriter
+    {
+    public:
+        template<typename T>
+        uint64_t append(const T* data, size_t count)
+        {
+            const uint64_t offset = m_bytes.size();
+            const size_t size = sizeof(T) * count;
+
+            m_bytes.resize(offset + size);
+
+            if (size > 0)
+                std::memcpy(m_bytes.data() + offset, data, size);
+
+            return offset;
+        }
+
+        void align(size_t alignment)
+        {
+            m_bytes.resize((m_bytes.size() + alignment - 1) / alignment * alignment, 0);
+        }
+
+        template<typename T>
+        T* at(uint64_t offset)
+        {
+            return reinterpret_cast<T*>(m_bytes.data() + offset);
+        }
+
+        [[nodiscard]] uint64_t size() const { return m_bytes.size(); }
+        [[nodiscard]] const std::vector<char>& bytes() const { return m_bytes; }
+    private:
+        std::vector<char> m_bytes;
+    };
+
+    class StringTable
+    {
+    public:
+        std::pair<uint32_t, uint32_t> add(const std::string& string)
+        {
+            const auto offset = static_cast<uint32_t>(m_data.size());
+            m_data += string;
+            return {offset, static_cast<uint32_t>(string.size())};
+        }
+
+        [[nodiscard]] const std::string& data() const { return m_data; }
+    private:
+        std::string m_data;
+    };
+
+    //Hands out one record per distinct asset
+    class AssetTable
+    {
+    public:
+        explicit AssetTable(StringTable& strings) : m_strings(strings) {}
+
+        uint32_t add(elix::cooked::AssetType type, const std::string& name)
+        {
+            const auto [it, isInserted] = m_indices.try_emplace({type, name}, static_cast<uint32_t>(m_records.size()));
+
+            if (isInserted)
+            {
+                auto& record = m_records.emplace_back();
+                record.type = type;
+                std::tie(record.nameOffset, record.nameLength) = m_strings.add(name);
+            }
+
+            return it->second;
+        }
+
+        [[nodiscard]] const std::vector<elix::cooked::AssetRecord>& records() const { return m_records; }
+    private:
+        StringTable& m_strings;
+        std::map<std::pair<uint32_t, std::string>, uint32_t> m_indices;
+        std::vector<elix::cooked::AssetRecord> m_records;
+    };
+
+    void readVector(const nlohmann::json& json, const char* key, float* values)
+    {
+        if (!json.contains(key))
+            return;
+
+        const auto& array = json[key];
+
+        for (size_t index = 0; index < 3 && index < array.size(); ++index)
+            values[index] = array[index].get<float>();
+    }
+
+    nlohmann::json writeVector(const float* values)
+    {
+        return {values[0], values[1], values[2]};
+    }
+
+    //offset + count * elementSize <= size, without overflowing on values read from a file
+    bool isInRange(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size)
+    {
+        return offset <= size && (elementSize == 0 || count <= (size - offset) / elementSize);
+    }
+
+    template<typename T>
+    bool getTable(std::span<const std::byte> bytes, uint64_t offset, uint32_t count, std::span<const T>& table)
+    {
+        if (offset % alignof(T) != 0 || !isInRange(offset, count, sizeof(T), bytes.size()))
+            return false;
+
+        table = {reinterpret_cast<const T*>(bytes.data() + offset), count};
+        return true;
+    }
+
+    template<typename T>
+    uint64_t appendTable(BlobWriter& blob, const std::vector<T>& records)
+    {
+        blob.align(elix::cooked::SECTION_ALIGNMENT);
+        return blob.append(records.data(), records.size());
+    }
+} //namespace
+
+bool elix::SceneCooker::cook(const std::string &jsonPath, const std::string &outputPath)
+{
+    std::ifstream input(jsonPath);
+
+    if (!input.is_open())
+    {
+        ELIX_LOG_ERROR("Failed to open scene for cooking ", jsonPath);
+        return false;
+    }
+
+    StringTable strings;
+    AssetTable assets(strings);
+
+    cooked::SceneHeader header;
+    std::vector<cooked::ObjectRecord> objects;
+    std::vector<cooked::MaterialRecord> materials;
+    std::vector<cooked::LightRecord> lights;
+    std::vector<cooked::ScriptRecord> scripts;
+
+    try
+    {
+        nlohmann::json json;
+        input >> json;
+
+        std::tie(header.nameOffset, header.nameLength) = strings.add(json.value("name", std::filesystem::path(jsonPath).filename().string()));
+
+        if (json.contains("skybox"))
+            header.skyboxAsset = assets.add(cooked::ASSET_SKYBOX, json["skybox"].get<std::string>());
+
+        const auto objectsJson = json.value("game_objects", nlohmann::json::array());
+
+        //Same rule as the JSON loader, a parent name resolves to the first object carrying it
+        std::unordered_map<std::string, uint32_t> objectsByName;
+
+        for (size_t index = 0; index < objectsJson.size(); ++index)
+            objectsByName.emplace(objectsJson[index].value("name", "undefined"), static_cast<uint32_t>(index));
+
+        objects.reserve(objectsJson.size());
+
+        for (const auto& objectJson : objectsJson)
+        {
+            auto& record = objects.emplace_back();
+
+            std::tie(record.nameOffset, record.nameLength) = strings.add(objectJson.value("name", "undefined"));
+            std::tie(record.tagOffset, record.tagLength) = strings.add(objectJson.value("tag", ""));
+            record.layerMask = objectJson.value("layer", record.layerMask);
+
+            readVector(objectJson, "position", record.position);
+            readVector(objectJson, "rotation", record.rotation);
+            readVector(objectJson, "scale", record.scale);
+
+            if (objectJson.contains("parent"))
+            {
+                const std::string parentName = objectJson["parent"];
+
+                if (const auto it = objectsByName.find(parentName); it != objectsByName.end())
+                    record.parent = it->second;
+                else
+                    ELIX_LOG_WARN("Could not find parent ", parentName, " while cooking ", jsonPath);
+            }
+
+            if (objectJson.contains("model"))
+            {
+                record.modelAsset = assets.add(cooked::ASSET_MODEL, objectJson["model"].get<std::string>());
+                record.firstMaterial = static_cast<uint32_t>(materials.size());
+
+                const auto materialsJson = objectJson.value("materials", nlohmann::json::object());
+
+                for (const auto& [meshKey, materialName] : materialsJson.items())
+                {
+                    uint32_t meshIndex = 0;
+
+                    if (std::from_chars(meshKey.data(), meshKey.data() + meshKey.size(), meshIndex).ec != std::errc{})
+                    {
+                        ELIX_LOG_WARN("Skipping material of mesh ", meshKey, " while cooking ", jsonPath);
+                        continue;
+                    }
+
+                    materials.push_back({meshIndex, assets.add(cooked::ASSET_MATERIAL, materialName.get<std::string>())});
+                }
+
+                record.materialCount = static_cast<uint32_t>(materials.size()) - record.firstMaterial;
+            }
+
+            for (const auto& componentJson : objectJson.value("components", nlohmann::json::array()))
+            {
+                const std::string type = componentJson.value("type", "");
+
+                if (type == "LightComponent")
+                {
+                    auto& light = lights.emplace_back();
+                    light.lightType = componentJson.value("lightType", 0u);
+                    readVector(componentJson, "direction", light.direction);
+                    readVector(componentJson, "color", light.color);
+                    readVector(componentJson, "position", light.position);
+                    light.strength = componentJson.value("strength", 0.0f);
+                    light.radius = componentJson.value("radius", 0.0f);
+
+                    record.light = static_cast<uint32_t>(lights.size() - 1);
+                }
+                else if (type == "AnimatorComponent")
+                    record.flags |= cooked::OBJECT_FLAG_HAS_ANIMATOR;
+                //Scenes saved before the component type was fixed still say ScriptsComponent
+                else if (type == "ScriptComponent" || type == "ScriptsComponent")
+                {
+                    record.flags |= cooked::OBJECT_FLAG_HAS_SCRIPTS;
+                    record.firstScript = static_cast<uint32_t>(scripts.size());
+
+                    for (const auto& scriptName : componentJson.value("scripts", nlohmann::json::array()))
+                    {
+                        auto& script = scripts.emplace_back();
+                        std::tie(script.nameOffset, script.nameLength) = strings.add(scriptName.get<std::string>());
+                    }
+
+                    record.scriptCount = static_cast<uint32_t>(scripts.size()) - record.firstScript;
+                }
+            }
+        }
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        ELIX_LOG_ERROR("Failed to cook scene ", jsonPath, ": ", e.what());
+        return false;
+    }
+
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.assetCount = static_cast<uint32_t>(assets.records().size());
+    header.materialCount = static_cast<uint32_t>(materials.size());
+    header.lightCount = static_cast<uint32_t>(lights.size());
+    header.scriptCount = static_cast<uint32_t>(scripts.size());
+
+    BlobWriter blob;
+    blob.append(&header, 1);
+
+    const uint64_t objectTableOffset = appendTable(blob, objects);
+    const uint64_t assetTableOffset = appendTable(blob, assets.records());
+    const uint64_t materialTableOffset = appendTable(blob, materials);
+    const uint64_t lightTableOffset = appendTable(blob, lights);
+    const uint64_t scriptTableOffset = appendTable(blob, scripts);
+
+    blob.align(cooked::SECTION_ALIGNMENT);
+    const uint64_t stringTableOffset = blob.append(strings.data().data(), strings.data().size());
+
+    auto* finalHeader = blob.at<cooked::SceneHeader>(0);
+    finalHeader->objectTableOffset = objectTableOffset;
+    finalHeader->assetTableOffset = assetTableOffset;
+    finalHeader->materialTableOffset = materialTableOffset;
+    finalHeader->lightTableOffset = lightTableOffset;
+    finalHeader->scriptTableOffset = scriptTableOffset;
+    finalHeader->stringTableOffset = stringTableOffset;
+    finalHeader->stringTableSize = strings.data().size();
+    finalHeader->fileSize = blob.size();
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+    {
+        ELIX_LOG_ERROR("Failed to open cooked scene for writing ", outputPath);
+        return false;
+    }
+
+    file.write(blob.bytes().data(), static_cast<std::streamsize>(blob.size()));
+
+    ELIX_LOG_INFO("Cooked scene ", jsonPath, " into ", outputPath, " (", objects.size(), " objects, ", blob.size(), " bytes)");
+
+    return file.good();
+}
+
+bool elix::SceneCooker::uncook(const std::string &cookedPath, const std::string &jsonPath)
+{
+    SceneView view;
+    const auto file = open(cookedPath, view);
+
+    if (!file)
+        return false;
+
+    const auto* header = view.header;
+    const auto& objects = view.objects;
+
+    auto getString = [&view](uint32_t offset, uint32_t length) { return std::string(view.getString(offset, length)); };
+    auto getAssetName = [&view](uint32_t asset) { return std::string(view.getAssetName(asset)); };
+
+    nlohmann::json json;
+
+    json["name"] = getString(header->nameOffset, header->nameLength);
+
+    if (header->skyboxAsset != cooked::NO_INDEX)
+        json["skybox"] = getAssetName(header->skyboxAsset);
+
+    for (uint32_t objectIndex = 0; objectIndex < header->objectCount; ++objectIndex)
+    {
+        const auto& record = objects[objectIndex];
+
+        nlohmann::json objectJson;
+
+        objectJson["name"] = getString(record.nameOffset, record.nameLength);
+        objectJson["position"] = writeVector(record.position);
+        objectJson["scale"] = writeVector(record.scale);
+        objectJson["rotation"] = writeVector(record.rotation);
+
+        if (record.tagLength > 0)
+            objectJson["tag"] = getString(record.tagOffset, record.tagLength);
+
+        if (record.layerMask != common::LayerMask::DEFAULT)
+            objectJson["layer"] = record.layerMask;
+
+        if (record.parent != cooked::NO_INDEX)
+            objectJson["parent"] = getString(objects[record.parent].nameOffset, objects[record.parent].nameLength);
+
+        if (record.modelAsset != cooked::NO_INDEX)
+        {
+            objectJson["model"] = getAssetName(record.modelAsset);
+
+            nlohmann::json materialJson = nlohmann::json::object();
+
+            for (const auto& material : view.getMaterials(record))
+                materialJson[std::to_string(material.meshIndex)] = getAssetName(material.asset);
+
+            objectJson["materials"] = materialJson;
+        }
+
+        if (record.light != cooked::NO_INDEX)
+        {
+            const auto& light = view.lights[record.light];
+
+            nlohmann::json lightJson;
+
+            lightJson["type"] = "LightComponent";
+            lightJson["lightType"] = light.lightType;
+            lightJson["direction"] = writeVector(light.direction);
+            lightJson["color"] = writeVector(light.color);
+            lightJson["strength"] = light.strength;
+            lightJson["position"] = writeVector(light.position);
+            lightJson["radius"] = light.radius;
+
+            objectJson["components"].push_back(lightJson);
+        }
+
+        if (record.flags & cooked::OBJECT_FLAG_HAS_ANIMATOR)
+            objectJson["components"].push_back({{"type", "AnimatorComponent"}});
+
+        if (record.flags & cooked::OBJECT_FLAG_HAS_SCRIPTS)
+        {
+            nlohmann::json scriptArray = nlohmann::json::array();
+
+            for (const auto& script : view.getScripts(record))
+                scriptArray.push_back(getString(script.nameOffset, script.nameLength));
+
+            objectJson["components"].push_back({{"type", "ScriptComponent"}, {"scripts", scriptArray}});
+        }
+
+        json["game_objects"].push_back(objectJson);
+    }
+
+    std::ofstream output(jsonPath);
+
+    if (!output.is_open())
+    {
+        ELIX_LOG_ERROR("Failed to open scene for writing ", jsonPath);
+        return false;
+    }
+
+    output << std::setw(4) << json << std::endl;
+
+    return output.good();
+}
+
+bool elix::SceneCooker::parse(std::span<const std::byte> bytes, SceneView &view)
+{
+    if (bytes.size() < sizeof(cooked::SceneHeader))
+        return false;
+
+    const auto header = reinterpret_cast<const cooked::SceneHeader*>(bytes.data());
+
+    if (header->magic != cooked::SCENE_MAGIC || header->version != cooked::SCENE_VERSION || header->fileSize != bytes.size())
+        return false;
+
+    SceneView result;
+    result.header = header;
+
+    if (!getTable(bytes, header->objectTableOffset, header->objectCount, result.objects) ||
+        !getTable(bytes, header->assetTableOffset, header->assetCount, result.assets) ||
+        !getTable(bytes, header->materialTableOffset, header->materialCount, result.materials) ||
+        !getTable(bytes, header->lightTableOffset, header->lightCount, result.lights) ||
+        !getTable(bytes, header->scriptTableOffset, header->scriptCount, result.scripts) ||
+        !isInRange(header->stringTableOffset, header->stringTableSize, 1, bytes.size()))
+        return false;
+
+    result.strings = {reinterpret_cast<const char*>(bytes.data() + header->stringTableOffset), header->stringTableSize};
+
+    auto isStringInRange = [&result](uint32_t offset, uint32_t length) { return isInRange(offset, length, 1, result.strings.size()); };
+    //NO_INDEX where the index is optional
+    auto isAsset = [&result](uint32_t asset, cooked::AssetType type, bool isOptional)
+    {
+        return (isOptional && asset == cooked::NO_INDEX) || (asset < result.assets.size() && result.assets[asset].type == type);
+    };
+
+    if (!isStringInRange(header->nameOffset, header->nameLength) || !isAsset(header->skyboxAsset, cooked::ASSET_SKYBOX, true))
+        return false;
+
+    for (const auto& asset : result.assets)
+        if (asset.type > cooked::ASSET_SKYBOX || !isStringInRange(asset.nameOffset, asset.nameLength))
+            return false;
+
+    for (const auto& material : result.materials)
+        if (!isAsset(material.asset, cooked::ASSET_MATERIAL, false))
+            return false;
+
+    for (const auto& script : result.scripts)
+        if (!isStringInRange(script.nameOffset, script.nameLength))
+            return false;
+
+    for (const auto& object : result.objects)
+    {
+        if (!isStringInRange(object.nameOffset, object.nameLength) || !isStringInRange(object.tagOffset, object.tagLength) ||
+            !isAsset(object.modelAsset, cooked::ASSET_MODEL, true) ||
+            !isInRange(object.firstMaterial, object.materialCount, 1, result.materials.size()) ||
+            !isInRange(object.firstScript, object.scriptCount, 1, result.scripts.size()))
+            return false;
+
+        if ((object.parent != cooked::NO_INDEX && object.parent >= result.objects.size()) ||
+            (object.light != cooked::NO_INDEX && object.light >= result.lights.size()))
+            return false;
+    }
+
+    view = result;
+
+    return true;
+}
+
+std::shared_ptr<elix::MappedFile> elix::SceneCooker::open(const std::string &filePath, SceneView &view)
+{
+    auto file = elix::MappedFile::open(filePath);
+
+    if (!file)
+        return nullptr;
+
+    if (!parse({file->data(), file->size()}, view))
+    {
+        ELIX_LOG_ERROR("Cooked scene is corrupt or of another version ", filePath, ", expected version ", cooked::SCENE_VERSION);
+        return nullptr;
+    }
+
+    return file;
+}
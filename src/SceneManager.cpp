@@ -8,7 +8,9 @@
 #include "LightManager.hpp"
 #include "Logger.hpp"
 #include "MeshComponent.hpp"
+#include "MappedFile.hpp"
 #include "RigidbodyComponent.hpp"
+#include "SceneCooker.hpp"
 #include "ScriptsRegister.hpp"
 
 class LightComponent;
@@ -61,6 +63,15 @@ void SceneManager::saveSceneToFile(Scene* scene, const std::string &filePath)
         objectJson["scale"] = {object->getScale().x, object->getScale().y, object->getScale().z};
         objectJson["rotation"] = {object->getRotation().x, object->getRotation().y, object->getRotation().z};
 
+        if (!object->getTag().empty())
+            objectJson["tag"] = object->getTag();
+
+        if (object->getLayerMask() != common::LayerMask::DEFAULT)
+            objectJson["layer"] = static_cast<uint32_t>(object->getLayerMask());
+
+        if (const GameObject* parent = object->getParent())
+            objectJson["parent"] = parent->getName();
+
         if (object->hasComponent<MeshComponent>())
         {
             if (auto model = object->getComponent<MeshComponent>()->getModel())
@@ -123,7 +134,7 @@ void SceneManager::saveSceneToFile(Scene* scene, const std::string &filePath)
             }
 
             nlohmann::json scriptJson;
-            scriptJson["type"] = "ScriptsComponent";
+            scriptJson["type"] = "ScriptComponent";
             scriptJson["scripts"] = scriptArray;
 
             objectJson["components"].push_back(scriptJson);
@@ -145,6 +156,9 @@ void SceneManager::saveSceneToFile(Scene* scene, const std::string &filePath)
 
 std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePath, elix::AssetsCache& cache)
 {
+    if (std::filesystem::path(filePath).extension() == elix::SceneCooker::EXTENSION)
+        return loadCookedScene(filePath, cache);
+
     std::ifstream file(filePath);
 
     if (!file.is_open())
@@ -182,6 +196,7 @@ std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePa
         return scene;
 
     std::vector<std::shared_ptr<GameObject>> objects;
+    std::unordered_map<std::string, GameObject*> objectsByName;
 
     for (const auto& objectJson : json["game_objects"])
     {
@@ -189,15 +204,21 @@ std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePa
 
         auto gameObject = std::make_shared<GameObject>(name);
 
+        if (objectJson.contains("tag"))
+            gameObject->setTag(objectJson["tag"]);
+
+        if (objectJson.contains("layer"))
+            gameObject->setLayerMask(static_cast<common::LayerMask>(objectJson["layer"].get<uint32_t>()));
+
         if (objectJson.contains("model"))
         {
             const std::string modelName = objectJson["model"];
 
-            if (auto modelAsset = cache.getAsset<elix::AssetModel>(modelName))
+            if (const elix::AssetReference modelReference(&cache, cache.getHandle<elix::AssetModel>(modelName)); modelReference)
             {
-                auto model = modelAsset->getModel();
+                auto model = modelReference->getModel();
 
-                gameObject->addComponent<MeshComponent>(model);
+                gameObject->addComponent<MeshComponent>(modelReference);
 
                 auto& overrideMaterials = gameObject->overrideMaterials;
 
@@ -284,7 +305,8 @@ std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePa
                 {
                     gameObject->addComponent<AnimatorComponent>();
                 }
-                else if (componentJson["type"] == "ScriptComponent")
+                //Older saves wrote ScriptsComponent
+                else if (componentJson["type"] == "ScriptComponent" || componentJson["type"] == "ScriptsComponent")
                 {
                     auto* scriptComponent = gameObject->addComponent<ScriptComponent>();
 
@@ -298,6 +320,23 @@ std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePa
         }
 
         objects.push_back(gameObject);
+        objectsByName.emplace(name, gameObject.get());
+    }
+
+    //Parents may come after their children in the file
+    for (size_t index = 0; index < objects.size(); ++index)
+    {
+        const auto& objectJson = json["game_objects"][index];
+
+        if (!objectJson.contains("parent"))
+            continue;
+
+        const std::string parentName = objectJson["parent"];
+
+        if (const auto it = objectsByName.find(parentName); it != objectsByName.end())
+            objects[index]->setParent(it->second);
+        else
+            ELIX_LOG_WARN("Could not find parent %s", parentName.c_str());
     }
 
     file.close();
@@ -306,3 +345,136 @@ std::shared_ptr<Scene> SceneManager::loadSceneFromFile(const std::string &filePa
 
     return scene;
 }
+
+std::shared_ptr<Scene> SceneManager::loadCookedScene(const std::string &filePath, elix::AssetsCache &cache)
+{
+    namespace cooked = elix::cooked;
+
+    elix::SceneCooker::SceneView view;
+    const auto file = elix::SceneCooker::open(filePath, view);
+
+    if (!file)
+        return nullptr;
+
+    //Every index and range below was checked by SceneCooker::parse
+    const auto* header = view.header;
+
+    auto getString = [&view](uint32_t offset, uint32_t length) { return std::string(view.getString(offset, length)); };
+
+    //Every asset is looked up once, the objects share what was resolved
+    std::vector<elix::AssetHandle<elix::AssetModel>> models(header->assetCount);
+    std::vector<Material*> materials(header->assetCount, nullptr);
+
+    for (uint32_t assetIndex = 0; assetIndex < header->assetCount; ++assetIndex)
+    {
+        const auto& record = view.assets[assetIndex];
+        const std::string name(view.getAssetName(assetIndex));
+
+        if (record.type == cooked::ASSET_MODEL)
+        {
+            models[assetIndex] = cache.getHandle<elix::AssetModel>(name);
+
+            if (!models[assetIndex].isValid())
+                ELIX_LOG_ERROR("Could not attach mesh component because missing the model ", name);
+        }
+        else if (record.type == cooked::ASSET_MATERIAL)
+        {
+            if (auto material = cache.getAsset<elix::AssetMaterial>(name))
+                materials[assetIndex] = material->getMaterial();
+            else
+                ELIX_LOG_WARN("Could not find material ", name);
+        }
+    }
+
+    auto scene = std::make_shared<Scene>();
+
+    if (header->skyboxAsset != cooked::NO_INDEX)
+    {
+        auto skybox = std::make_shared<elix::Skybox>();
+
+        skybox->init({});
+
+        skybox->loadFromHDR(std::string(view.getAssetName(header->skyboxAsset)));
+
+        scene->setSkybox(skybox);
+    }
+
+    std::vector<std::shared_ptr<GameObject>> objects;
+    objects.reserve(header->objectCount);
+
+    for (uint32_t objectIndex = 0; objectIndex < header->objectCount; ++objectIndex)
+    {
+        const auto& record = view.objects[objectIndex];
+
+        auto gameObject = std::make_shared<GameObject>(getString(record.nameOffset, record.nameLength));
+
+        if (record.tagLength > 0)
+            gameObject->setTag(getString(record.tagOffset, record.tagLength));
+
+        gameObject->setLayerMask(static_cast<common::LayerMask>(record.layerMask));
+
+        if (record.modelAsset != cooked::NO_INDEX)
+        {
+            if (const elix::AssetReference modelReference(&cache, models[record.modelAsset]); modelReference)
+            {
+                const auto meshCount = static_cast<uint32_t>(modelReference->getModel()->getNumMeshes());
+
+                gameObject->addComponent<MeshComponent>(modelReference);
+
+                for (const auto& materialRecord : view.getMaterials(record))
+                {
+                    if (materialRecord.meshIndex < meshCount && materials[materialRecord.asset])
+                        gameObject->overrideMaterials[static_cast<int>(materialRecord.meshIndex)] = materials[materialRecord.asset];
+                }
+            }
+        }
+
+        gameObject->setPosition({record.position[0], record.position[1], record.position[2]});
+        gameObject->setScale({record.scale[0], record.scale[1], record.scale[2]});
+        gameObject->setRotation({record.rotation[0], record.rotation[1], record.rotation[2]});
+
+        gameObject->addComponent<RigidbodyComponent>(gameObject);
+
+        if (record.light != cooked::NO_INDEX)
+        {
+            const auto& lightRecord = view.lights[record.light];
+
+            lighting::Light light;
+            light.type = static_cast<lighting::LightType>(lightRecord.lightType);
+            light.direction = glm::vec3(lightRecord.direction[0], lightRecord.direction[1], lightRecord.direction[2]);
+            light.position = glm::vec3(lightRecord.position[0], lightRecord.position[1], lightRecord.position[2]);
+            light.color = glm::vec3(lightRecord.color[0], lightRecord.color[1], lightRecord.color[2]);
+            light.strength = lightRecord.strength;
+            light.radius = lightRecord.radius;
+            gameObject->addComponent<LightComponent>(light);
+
+            LightManager::instance().addLight(gameObject->getComponent<LightComponent>()->getLight());
+        }
+
+        if (record.flags & cooked::OBJECT_FLAG_HAS_ANIMATOR)
+            gameObject->addComponent<AnimatorComponent>();
+
+        if (record.flags & cooked::OBJECT_FLAG_HAS_SCRIPTS)
+        {
+            auto* scriptComponent = gameObject->addComponent<ScriptComponent>();
+
+            for (const auto& scriptRecord : view.getScripts(record))
+                scriptComponent->addScript(getString(scriptRecord.nameOffset, scriptRecord.nameLength));
+        }
+
+        objects.push_back(gameObject);
+    }
+
+    //Parents were resolved to object indices by the cooker
+    for (uint32_t objectIndex = 0; objectIndex < header->objectCount; ++objectIndex)
+    {
+        const uint32_t parent = view.objects[objectIndex].parent;
+
+        if (parent < objects.size())
+            objects[objectIndex]->setParent(objects[parent].get());
+    }
+
+    scene->setGameObjects(objects);
+
+    return scene;
+}
@@ -0,0 +1,297 @@
+#include "Scheduler.hpp"
+
+#include "GameObject.hpp"
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <typeinfo>
+
+namespace
+{
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void tick(Component& component, float deltaTime)
+    {
+        const GameObject* owner = component.getOwner();
+        component.tick(deltaTime, owner ? owner->getSignificance().score : 1.0f);
+    }
+} //namespace
+
+void elix::Scheduler::addSystem(const std::string &name, UpdatePhase phase, const Access &access, const SystemFunction &function)
+{
+    removeSystem(name);
+    m_systems.push_back({name, phase, access, function});
+}
+
+bool elix::Scheduler::removeSystem(const std::string &name)
+{
+    return std::erase_if(m_systems, [&name](const System& system) { return system.name == name; }) > 0;
+}
+
+void elix::Scheduler::run(const std::vector<std::shared_ptr<GameObject>> &objects, float deltaTime)
+{
+    m_jobTimings.clear();
+
+    for (size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        gather(objects, static_cast<UpdatePhase>(phase));
+        runJobs(deltaTime);
+
+        m_phaseMilliseconds[phase] = millisecondsSince(startTime);
+    }
+
+    m_jobs.clear();
+}
+
+void elix::Scheduler::gather(const std::vector<std::shared_ptr<GameObject>> &objects, UpdatePhase phase)
+{
+    m_jobs.clear();
+    m_firstTiming = m_jobTimings.size();
+
+    //Ordered by type id, the declaration order of component jobs
+    std::map<ComponentTypeId, Job> componentJobs;
+    auto& registry = Registry::instance();
+
+    for (const auto& object : objects)
+    {
+        registry.forEachComponent(object->getEntity(), [phase, &componentJobs](ComponentTypeId type, Component& component)
+        {
+            if (component.getUpdatePhase() != phase)
+                return;
+
+            Job& job = componentJobs[type];
+
+            if (job.parallelComponents.empty() && job.serialComponents.empty())
+                job.access = component.getAccess();
+            else
+                job.access |= component.getAccess();
+
+            (component.isThreadSafe() ? job.parallelComponents : job.serialComponents).push_back(&component);
+        });
+    }
+
+    for (auto& [type, job] : componentJobs)
+    {
+        Component* first = !job.serialComponents.empty() ? job.serialComponents.front() : job.parallelComponents.front();
+        m_jobTimings.push_back({typeid(*first).name(), phase, job.parallelComponents.size() + job.serialComponents.size(), 0.0});
+        m_jobs.push_back(std::move(job));
+    }
+
+    for (const auto& system : m_systems)
+    {
+        if (system.phase != phase)
+            continue;
+
+        Job job;
+        job.access = system.access;
+        job.system = &system;
+
+        m_jobTimings.push_back({system.name, phase, 0, 0.0});
+        m_jobs.push_back(std::move(job));
+    }
+
+    for (size_t index = 0; index < m_jobs.size(); ++index)
+    {
+        m_jobs[index].isOnCallingThread = m_jobs[index].access.touches(Resource::OPENGL);
+
+        for (size_t later = index + 1; later < m_jobs.size(); ++later)
+            if (m_jobs[index].access.conflictsWith(m_jobs[later].access))
+                m_jobs[index].dependents.push_back(later);
+    }
+}
+
+void elix::Scheduler::runJobs(float deltaTime)
+{
+    if (m_jobs.empty())
+        return;
+
+    if (!m_isParallelEnabled)
+    {
+        for (size_t index = 0; index < m_jobs.size(); ++index)
+            execute(index, deltaTime);
+
+        return;
+    }
+
+    auto& pool = ThreadPool::instance();
+
+    std::vector<std::atomic<size_t>> pendingDependencies(m_jobs.size());
+
+    for (const auto& job : m_jobs)
+        for (const size_t dependent : job.dependents)
+            pendingDependencies[dependent].fetch_add(1, std::memory_order_relaxed);
+
+    std::atomic<size_t> remaining{m_jobs.size()};
+    std::mutex readyMutex;
+    //Jobs that have to run on the calling thread and may start, lowest index first
+    std::vector<size_t> readyOnCallingThread;
+
+    //The first exception a job threw, rethrown once every job has finished. A job must always finish, the ones still
+    //queued reference this frame
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    const auto run = [this, deltaTime, &exception, &exceptionMutex](size_t index)
+    {
+        try
+        {
+            execute(index, deltaTime);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+    std::function<void(size_t)> schedule;
+
+    const auto finish = [this, &pendingDependencies, &remaining, &schedule](size_t index)
+    {
+        for (const size_t dependent : m_jobs[index].dependents)
+            if (pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                schedule(dependent);
+
+        remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    schedule = [this, &pool, &readyMutex, &readyOnCallingThread, &run, &finish](size_t index)
+    {
+        if (m_jobs[index].isOnCallingThread)
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            readyOnCallingThread.insert(std::ranges::upper_bound(readyOnCallingThread, index), index);
+            return;
+        }
+
+        pool.submit([index, &run, &finish]
+        {
+            run(index);
+            finish(index);
+        });
+    };
+
+    //Collected before any of them starts, a finishing job would otherwise release a later one a second time
+    std::vector<size_t> roots;
+
+    for (size_t index = 0; index < m_jobs.size(); ++index)
+        if (pendingDependencies[index].load(std::memory_order_relaxed) == 0)
+            roots.push_back(index);
+
+    for (const size_t index : roots)
+        schedule(index);
+
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        size_t index = m_jobs.size();
+
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+
+            if (!readyOnCallingThread.empty())
+            {
+                index = readyOnCallingThread.front();
+                readyOnCallingThread.erase(readyOnCallingThread.begin());
+            }
+        }
+
+        if (index < m_jobs.size())
+        {
+            run(index);
+            finish(index);
+        }
+        else if (!pool.runPendingTask())
+            std::this_thread::yield();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void elix::Scheduler::execute(size_t jobIndex, float deltaTime)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    Job& job = m_jobs[jobIndex];
+
+    if (job.system)
+        job.system->function(deltaTime);
+    else
+    {
+        if (m_isParallelEnabled)
+        {
+            ThreadPool::instance().parallelFor(job.parallelComponents.size(), [&job, deltaTime](size_t begin, size_t end)
+            {
+                for (size_t index = begin; index < end; ++index)
+                    ::tick(*job.parallelComponents[index], deltaTime);
+            });
+        }
+        else
+        {
+            for (auto* component : job.parallelComponents)
+                ::tick(*component, deltaTime);
+        }
+
+        for (auto* component : job.serialComponents)
+            ::tick(*component, deltaTime);
+    }
+
+    m_jobTimings[m_firstTiming + jobIndex].milliseconds = millisecondsSince(startTime);
+}
+
+void elix::Scheduler::setParallelEnabled(bool isEnabled)
+{
+    m_isParallelEnabled = isEnabled;
+}
+
+bool elix::Scheduler::isParallelEnabled() const
+{
+    return m_isParallelEnabled;
+}
+
+const std::array<double, elix::UPDATE_PHASE_COUNT>& elix::Scheduler::getPhaseMilliseconds() const
+{
+    return m_phaseMilliseconds;
+}
+
+const std::vector<elix::Scheduler::JobTiming>& elix::Scheduler::getJobTimings() const
+{
+    return m_jobTimings;
+}
+
+void elix::Scheduler::logTimings() const
+{
+    for (size_t phase = 0; phase < UPDATE_PHASE_COUNT; ++phase)
+    {
+        ELIX_LOG_INFO(getPhaseName(static_cast<UpdatePhase>(phase)), ": ", m_phaseMilliseconds[phase], " ms");
+
+        for (const auto& timing : m_jobTimings)
+            if (static_cast<size_t>(timing.phase) == phase)
+                ELIX_LOG_INFO("    ", timing.name, " (", timing.componentCount, "): ", timing.milliseconds, " ms");
+    }
+}
+
+const char * elix::Scheduler::getPhaseName(UpdatePhase phase)
+{
+    switch (phase)
+    {
+        case UpdatePhase::Gameplay: return "Gameplay";
+        case UpdatePhase::Animation: return "Animation";
+        case UpdatePhase::Physics: return "Physics";
+        case UpdatePhase::Transform: return "Transform";
+        case UpdatePhase::Late: return "Late";
+    }
+
+    return "Unknown";
+}
@@ -1,10 +1,17 @@
 #include "ScriptComponent.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 #include "LibrariesLoader.hpp"
 #include "ScriptsRegister.hpp"
 
+ScriptComponent::ScriptComponent()
+{
+    //Only scripts of far away objects slow down, raise the owner's priority for anything that has to react every frame
+    setTickBudget({10.0f, 0.25f});
+}
+
 void ScriptComponent::addScript(const std::string &name)
 {
     // using GetScriptsRegisterFunc = ScriptsRegister* (*)();
@@ -42,6 +49,20 @@ void ScriptComponent::update(float deltaTime)
         if (script) script->onUpdate(deltaTime);
 }
 
+elix::Access ScriptComponent::getAccess() const
+{
+    if (!isThreadSafe())
+        return {};
+
+    //Moving the owner feeds its rigidbody's actor through the position callback
+    return {elix::Resource::TRANSFORMS, elix::Resource::SCRIPTS | elix::Resource::TRANSFORMS | elix::Resource::PHYSICS};
+}
+
+bool ScriptComponent::isThreadSafe() const
+{
+    return std::ranges::all_of(m_scripts, [](const auto& entry) { return !entry.second || entry.second->isThreadSafe(); });
+}
+
 void ScriptComponent::setUpdateScripts(bool flag)
 {
     m_updateScripts = flag;
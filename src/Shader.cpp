@@ -178,6 +178,39 @@ void elix::Shader::loadBinaries(const char *vertexSource, const char *fragmentSo
         glDeleteShader(geometry);
 }
 
+void elix::Shader::loadTransformFeedback(const char *vertexSource, const std::vector<const char*> &varyings)
+{
+    if (m_id)
+    {
+        glDeleteProgram(m_id);
+        m_uniformCache.clear();
+    }
+
+    const GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexSource, nullptr);
+    glCompileShader(vertex);
+    ::checkCompileErrors(vertex, "VERTEX");
+
+    const int tempID = glCreateProgram();
+    glAttachShader(tempID, vertex);
+
+    //Has to be known before linking
+    glTransformFeedbackVaryings(tempID, static_cast<GLsizei>(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+
+    glLinkProgram(tempID);
+
+    if (::checkCompileErrors(tempID, "PROGRAM"))
+        m_id = tempID;
+    else
+    {
+        m_id = 0;
+        glDeleteProgram(tempID);
+        ELIX_LOG_ERROR("Transform feedback shader failed to compile embedded sources");
+    }
+
+    glDeleteShader(vertex);
+}
+
 void elix::Shader::bind() const
 {
     glUseProgram(m_id);
@@ -198,10 +231,10 @@ bool elix::Shader::isValid() const
     return m_id != 0;
 }
 
-void elix::Shader::setMat4Array(const std::string &name, const std::vector<glm::mat4> &value) const
+void elix::Shader::setMat4Array(const std::string &name, std::span<const glm::mat4> value) const
 {
     GLint location = getUniformLocation(name);
-    glUniformMatrix4fv(location, value.size(), GL_FALSE, glm::value_ptr(value[0]));
+    glUniformMatrix4fv(location, static_cast<GLsizei>(value.size()), GL_FALSE, glm::value_ptr(value[0]));
 }
 
 void elix::Shader::setMat4(const std::string& name, const glm::mat4& value) const
@@ -2,6 +2,8 @@
 #include "Filesystem.hpp"
 #include "Skeleton.hpp"
 #include "EmbeddedShaders.hpp"
+
+#include <glad/glad.h>
 #include <iostream>
 
 
@@ -36,4 +38,15 @@ void ShaderManager::preLoadShaders()
     m_shaders[SKELETON_STENCIL] = createShader(shader_skeleton_vert, shader_stencil_frag);
     m_shaders[SKYBOX] = createShader(shader_skybox_vert, shader_skybox_frag);
     m_shaders[EQUIRECTANGULAR_TO_CUBEMAP] = createShader(shader_equirectangular_to_cubemap_vert, shader_equirectangular_to_cubemap_frag);
+    if (GLAD_GL_VERSION_4_3)
+    {
+        m_shaders[SKELETON_INSTANCED] = createShader(shader_skeleton_instanced_vert, shader_skeleton_frag);
+        m_shaders[SKELETON_SHADOW_INSTANCED] = createShader(shader_shadow_instanced_vert, shader_shadow_frag);
+        m_shaders[SKELETON_STENCIL_INSTANCED] = createShader(shader_skeleton_instanced_vert, shader_stencil_frag);
+        m_shaders[VERTEX_ANIMATION] = createShader(shader_vertex_animation_vert, shader_skeleton_frag);
+        m_shaders[VERTEX_ANIMATION_SHADOW] = createShader(shader_vertex_animation_shadow_vert, shader_shadow_frag);
+        m_shaders[VERTEX_ANIMATION_STENCIL] = createShader(shader_vertex_animation_vert, shader_stencil_frag);
+    }
+
+    m_shaders[SKINNING].loadTransformFeedback(shader_skinning_vert, {"skinnedPosition", "skinnedNormal", "skinnedTangent", "skinnedTextureCoordinates"});
 }
@@ -2,6 +2,7 @@
 #include <glad/glad.h>
 
 #include "FrameBuffer.hpp"
+#include "Mesh.hpp"
 #include "Texture.hpp"
 #include "WindowsManager.hpp"
 
@@ -91,6 +92,7 @@ void ShadowHandler::beginDirectionalShadowPass() const
     window::MainWindow::setViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
     window::MainWindow::clear(window::ClearFlag::DEPTH_BUFFER_BIT);
     window::MainWindow::setCullMode(window::CullMode::FRONT);
+    elix::Mesh::setDepthOnlyPass(true);
 }
 
 void ShadowHandler::beginPointShadowPass(int index) const
@@ -102,6 +104,7 @@ void ShadowHandler::beginPointShadowPass(int index) const
     window::MainWindow::setViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
     window::MainWindow::clear(window::ClearFlag::DEPTH_BUFFER_BIT);
     window::MainWindow::setCullMode(window::CullMode::FRONT);
+    elix::Mesh::setDepthOnlyPass(true);
 }
 
 void ShadowHandler::beginSpotShadowPass(int index) const
@@ -112,11 +115,13 @@ void ShadowHandler::beginSpotShadowPass(int index) const
     window::MainWindow::setViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
     window::MainWindow::clear(window::ClearFlag::DEPTH_BUFFER_BIT);
     window::MainWindow::setCullMode(window::CullMode::FRONT);
+    elix::Mesh::setDepthOnlyPass(true);
 }
 
 void ShadowHandler::endShadowPass() const
 {
     window::MainWindow::setCullMode(window::CullMode::BACK);
+    elix::Mesh::setDepthOnlyPass(false);
 
     elix::FrameBuffer::unbind();
 
@@ -0,0 +1,80 @@
+#include "SignificanceManager.hpp"
+
+#include "CameraComponent.hpp"
+#include "GameObject.hpp"
+#include "MeshComponent.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    elix::SignificanceManager::Settings g_settings;
+
+    //Inward facing planes of the view frustum, xyz normal and w distance
+    std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection)
+    {
+        const glm::mat4 m = glm::transpose(viewProjection);
+
+        std::array<glm::vec4, 6> planes{m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]};
+
+        for (auto& plane : planes)
+            plane /= glm::length(glm::vec3(plane));
+
+        return planes;
+    }
+
+    bool isSphereVisible(const std::array<glm::vec4, 6>& planes, const glm::vec3& center, float radius)
+    {
+        return std::ranges::all_of(planes, [&](const glm::vec4& plane) {return glm::dot(glm::vec3(plane), center) + plane.w >= -radius;});
+    }
+} //namespace
+
+void elix::SignificanceManager::update(const std::vector<std::shared_ptr<GameObject>> &objects, const CameraComponent &camera)
+{
+    const auto planes = extractFrustumPlanes(camera.getProjectionMatrix() * camera.getViewMatrix());
+    const glm::vec3 cameraPosition = camera.getPosition();
+
+    for (const auto& object : objects)
+    {
+        //World space, getPosition and getScale are relative to the parent
+        const glm::mat4 worldMatrix = object->getTransformMatrix();
+        glm::vec3 center = glm::vec3(worldMatrix[3]);
+        float radius = 0.0f;
+
+        if (const auto meshComponent = object->getComponent<MeshComponent>(); meshComponent && meshComponent->getModel())
+        {
+            const auto& bounds = meshComponent->getModel()->getBoundingBox();
+            const float scale = std::max({glm::length(glm::vec3(worldMatrix[0])), glm::length(glm::vec3(worldMatrix[1])), glm::length(glm::vec3(worldMatrix[2]))});
+
+            center = glm::vec3(worldMatrix * glm::vec4(bounds.getCenter(), 1.0f));
+            radius = bounds.getRadius() * scale;
+        }
+
+        common::Significance significance;
+        significance.distance = std::max(glm::length(center - cameraPosition) - radius, 0.0f);
+        significance.isVisible = isSphereVisible(planes, center, radius);
+        significance.score = computeScore(significance.distance, significance.isVisible, object->getSignificancePriority());
+
+        object->setSignificance(significance);
+    }
+}
+
+float elix::SignificanceManager::computeScore(float distance, bool isVisible, float priority)
+{
+    const float range = g_settings.zeroDistance - g_settings.fullDistance;
+    const float distanceScore = range > 0.0f ? std::clamp((g_settings.zeroDistance - distance) / range, 0.0f, 1.0f) : (distance <= g_settings.fullDistance ? 1.0f : 0.0f);
+
+    return std::max(distanceScore * (isVisible ? 1.0f : g_settings.offscreenScale) * priority, 0.0f);
+}
+
+void elix::SignificanceManager::setSettings(const Settings &settings)
+{
+    g_settings = settings;
+}
+
+const elix::SignificanceManager::Settings & elix::SignificanceManager::getSettings()
+{
+    return g_settings;
+}
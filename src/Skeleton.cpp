@@ -1,14 +1,11 @@
 #include "Skeleton.hpp"
+#include "Simd.hpp"
 #include "Utilities.hpp"
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
-Skeleton::Skeleton()
-{
-    m_finalBoneMatrices.reserve(100);
-
-    for (int i = 0; i < 100; i++)
-        m_finalBoneMatrices.emplace_back(1.0f);
-}
+Skeleton::Skeleton() = default;
 
 void Skeleton::addBone(aiBone *bone)
 {
@@ -21,7 +18,6 @@ void Skeleton::addBone(aiBone *bone)
         boneInfo.name = boneName;
         boneInfo.offsetMatrix = utilities::convertMatrixToGLMFormat(bone->mOffsetMatrix);
         boneInfo.id = m_bonesInfo.size();
-        boneInfo.finalTransformation = glm::mat4(1.0f);
         boneInfo.parentId = -1;
         m_boneMap[boneInfo.name] = boneInfo.id;
 
@@ -101,26 +97,83 @@ common::BoneInfo* Skeleton::getParent()
 
 void Skeleton::calculateBindPoseTransforms()
 {
-    m_bindPoseTransform.resize(m_bonesInfo.size(), glm::mat4(1.0f));
+    const size_t boneCount = m_bonesInfo.size();
 
-    glm::mat4 identity(1.0f);
+    //Depth first so a stable sort on it puts every parent ahead of its children
+    std::vector<int> depths(boneCount, -1);
 
-    auto processBone = [this](int boneID, const glm::mat4 &parentTransform, auto&& self)->void
+    for (size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex)
     {
-        common::BoneInfo& bone = m_bonesInfo[boneID];
-        glm::mat4 globalTransform = parentTransform * bone.localBindTransform;
+        int depth = 0;
 
-        m_bindPoseTransform[boneID] = globalTransform * bone.offsetMatrix;
+        for (int parent = m_bonesInfo[boneIndex].parentId; parent >= 0 && depth <= static_cast<int>(boneCount); parent = m_bonesInfo[parent].parentId)
+            ++depth;
 
-        bone.finalTransformation = globalTransform * bone.offsetMatrix;
+        depths[boneIndex] = depth;
+    }
 
-        for (int childID : bone.children)
-            self(childID, globalTransform, self);
-    };
+    m_boneIds.resize(boneCount);
+    std::iota(m_boneIds.begin(), m_boneIds.end(), 0);
+    std::ranges::stable_sort(m_boneIds, [&depths](int a, int b) {return depths[a] < depths[b];});
 
-    for (const auto& bone : m_bonesInfo)
-        if (bone.parentId == -1)
-            processBone(bone.id, identity, processBone);
+    std::vector<int> evaluationIndices(boneCount);
+
+    for (size_t index = 0; index < boneCount; ++index)
+        evaluationIndices[m_boneIds[index]] = static_cast<int>(index);
+
+    m_parentIndices.resize(boneCount);
+    m_offsetMatrices.resize(boneCount);
+    m_localBindTransforms.resize(boneCount);
+
+    for (size_t index = 0; index < boneCount; ++index)
+    {
+        const auto& bone = m_bonesInfo[m_boneIds[index]];
+
+        m_parentIndices[index] = bone.parentId >= 0 ? evaluationIndices[bone.parentId] : -1;
+        m_offsetMatrices[index] = bone.offsetMatrix;
+        m_localBindTransforms[index] = bone.localBindTransform;
+    }
+
+    std::vector<glm::mat4> modelTransforms(boneCount);
+    m_bindPoseTransform.assign(boneCount, glm::mat4(1.0f));
+    evaluatePose(m_localBindTransforms, modelTransforms, m_bindPoseTransform);
+}
+
+std::vector<int> Skeleton::bindTracks(const elix::AnimationClip &clip) const
+{
+    std::vector<int> tracks(m_boneIds.size(), -1);
+
+    for (size_t index = 0; index < m_boneIds.size(); ++index)
+        tracks[index] = clip.findTrack(m_bonesInfo[m_boneIds[index]].name);
+
+    return tracks;
+}
+
+void Skeleton::evaluatePose(std::span<const glm::mat4> localTransforms, std::span<glm::mat4> modelTransforms, std::span<glm::mat4> palette) const
+{
+    const size_t boneCount = m_parentIndices.size();
+
+    for (size_t index = 0; index < boneCount; ++index)
+    {
+        const int parent = m_parentIndices[index];
+
+        if (parent < 0)
+            modelTransforms[index] = localTransforms[index];
+        else
+            elix::simd::multiply(modelTransforms[parent], localTransforms[index], modelTransforms[index]);
+
+        elix::simd::multiply(modelTransforms[index], m_offsetMatrices[index], palette[m_boneIds[index]]);
+    }
+}
+
+const std::vector<int>& Skeleton::getParentIndices() const
+{
+    return m_parentIndices;
+}
+
+const std::vector<glm::mat4>& Skeleton::getLocalBindTransforms() const
+{
+    return m_localBindTransforms;
 }
 
 const std::vector<glm::mat4>& Skeleton::getBindPoses() const
@@ -128,10 +181,14 @@ const std::vector<glm::mat4>& Skeleton::getBindPoses() const
     return m_bindPoseTransform;
 }
 
-const std::vector<glm::mat4>& Skeleton::getFinalMatrices()
+size_t Skeleton::getMemorySize() const
 {
+    size_t size = sizeof(Skeleton) + m_bonesInfo.capacity() * sizeof(common::BoneInfo) +
+                  (m_parentIndices.capacity() + m_boneIds.capacity()) * sizeof(int) +
+                  (m_offsetMatrices.capacity() + m_localBindTransforms.capacity() + m_bindPoseTransform.capacity()) * sizeof(glm::mat4);
+
     for (const auto& bone : m_bonesInfo)
-        m_finalBoneMatrices[bone.id] = bone.finalTransformation;
+        size += bone.name.capacity() + bone.children.capacity() * sizeof(int);
 
-    return m_finalBoneMatrices;
+    return size;
 }
@@ -0,0 +1,192 @@
+#include "SkinnedRenderer.hpp"
+
+#include "AnimatorComponent.hpp"
+#include "Buffer.hpp"
+#include "GameObject.hpp"
+#include "MeshComponent.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+namespace
+{
+    //std430 layout of Instance in the instanced shaders
+    struct Instance
+    {
+        glm::mat4 model;
+        uint32_t paletteOffset;
+        uint32_t padding[3];
+    };
+
+    static_assert(sizeof(Instance) == 80, "Instances are uploaded as is");
+
+    //Binding points of the instanced shaders
+    constexpr unsigned int PALETTE_BINDING = 0;
+    constexpr unsigned int INSTANCE_BINDING = 1;
+
+    bool g_isEnabled{false};
+
+    std::vector<glm::mat4> g_palettes;
+    std::vector<Instance> g_instances;
+    std::vector<elix::SkinnedRenderer::Batch> g_batches;
+
+    std::unique_ptr<elix::Buffer> g_paletteBuffer{nullptr};
+    std::unique_ptr<elix::Buffer> g_instanceBuffer{nullptr};
+
+    void upload(std::unique_ptr<elix::Buffer>& buffer, const void* data, size_t size)
+    {
+        if (!buffer)
+        {
+            buffer = std::make_unique<elix::Buffer>(elix::Buffer::BufferType::ShaderStorage, elix::Buffer::BufferUsage::StreamDraw);
+            buffer->create();
+        }
+
+        buffer->uploadRaw(data, size);
+        buffer->unbind();
+    }
+} //namespace
+
+void elix::SkinnedRenderer::update(const std::vector<std::shared_ptr<GameObject>> &objects)
+{
+    g_palettes.clear();
+    g_instances.clear();
+    g_batches.clear();
+
+    const bool isActive = g_isEnabled && isSupported();
+
+    struct Entry
+    {
+        elix::Model* model;
+        size_t lod;
+        Instance instance;
+    };
+
+    std::vector<Entry> entries;
+
+    for (const auto& object : objects)
+    {
+        const auto meshComponent = object->getComponent<MeshComponent>();
+
+        if (!meshComponent)
+            continue;
+
+        meshComponent->setInstanced(false);
+
+        const auto animator = object->getComponent<AnimatorComponent>();
+        auto* model = meshComponent->getModel();
+
+        if (!isActive || !animator || !model || !model->hasSkeleton() || meshComponent->isCulled() || meshComponent->isPreSkinned())
+            continue;
+
+        //Batches bind the meshes' own materials, per object overrides stay on the MeshComponent path
+        if (!object->overrideMaterials.empty())
+            continue;
+
+        const auto& palette = animator->getFinalMatrices();
+
+        if (palette.empty())
+            continue;
+
+        Entry entry{model, meshComponent->getLod(), {object->getTransformMatrix(), static_cast<uint32_t>(g_palettes.size()), {}}};
+        g_palettes.insert(g_palettes.end(), palette.begin(), palette.end());
+        entries.push_back(entry);
+
+        meshComponent->setInstanced(true);
+    }
+
+    if (entries.empty())
+        return;
+
+    //Instances of the same model and level end up next to each other, each run is one batch
+    std::ranges::stable_sort(entries, [](const Entry& a, const Entry& b)
+    {
+        return a.model != b.model ? a.model < b.model : a.lod < b.lod;
+    });
+
+    g_instances.reserve(entries.size());
+
+    for (const auto& entry : entries)
+    {
+        if (g_batches.empty() || g_batches.back().model != entry.model || g_batches.back().lod != entry.lod)
+            g_batches.push_back({entry.model, entry.lod, static_cast<uint32_t>(g_instances.size()), 0});
+
+        g_instances.push_back(entry.instance);
+        ++g_batches.back().instanceCount;
+    }
+
+    ::upload(g_paletteBuffer, g_palettes.data(), g_palettes.size() * sizeof(glm::mat4));
+    ::upload(g_instanceBuffer, g_instances.data(), g_instances.size() * sizeof(Instance));
+}
+
+void elix::SkinnedRenderer::draw(elix::Shader &shader)
+{
+    if (g_batches.empty())
+        return;
+
+    g_paletteBuffer->bindBase(PALETTE_BINDING);
+    g_instanceBuffer->bindBase(INSTANCE_BINDING);
+
+    const bool isDepthOnly = Mesh::isDepthOnlyPass();
+    //Same bias MeshComponent::render applies
+    const size_t lodBias = isDepthOnly ? MeshComponent::getLodSettings().shadowLodBias : 0;
+
+    for (const auto& batch : g_batches)
+    {
+        shader.setInt("instanceOffset", static_cast<int>(batch.firstInstance));
+
+        for (const auto& mesh : batch.model->getMeshes())
+        {
+            if (!isDepthOnly)
+            {
+                Material* material = mesh.getMaterial();
+
+                if (!material)
+                    continue;
+
+                material->bind(shader);
+            }
+
+            mesh.drawInstanced(batch.lod + lodBias, batch.instanceCount);
+        }
+    }
+}
+
+const std::vector<elix::SkinnedRenderer::Batch>& elix::SkinnedRenderer::getBatches()
+{
+    return g_batches;
+}
+
+size_t elix::SkinnedRenderer::getInstanceCount()
+{
+    return g_instances.size();
+}
+
+size_t elix::SkinnedRenderer::getPaletteMatrixCount()
+{
+    return g_palettes.size();
+}
+
+bool elix::SkinnedRenderer::isSupported()
+{
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void elix::SkinnedRenderer::setEnabled(bool isEnabled)
+{
+    g_isEnabled = isEnabled;
+}
+
+bool elix::SkinnedRenderer::isEnabled()
+{
+    return g_isEnabled;
+}
+
+void elix::SkinnedRenderer::release()
+{
+    g_paletteBuffer.reset();
+    g_instanceBuffer.reset();
+    g_palettes.clear();
+    g_instances.clear();
+    g_batches.clear();
+}
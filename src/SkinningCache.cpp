@@ -0,0 +1,534 @@
+#include "SkinningCache.hpp"
+
+#include "AnimatorComponent.hpp"
+#include "GameObject.hpp"
+#include "Logger.hpp"
+#include "MeshComponent.hpp"
+#include "ShaderManager.hpp"
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+#include <glad/glad.h>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    elix::SkinningCache::Mode g_mode{elix::SkinningCache::Mode::Shader};
+
+    //Size of finalBonesMatrices in skinning.vert, bigger palettes are skinned on the CPU
+    constexpr size_t MAX_SHADER_BONES = 100;
+
+    //Vertices one task skins at least, below that the hand off costs more than the work
+    constexpr size_t MIN_VERTICES_PER_TASK = 1024;
+
+    //Blended bone matrix of one vertex as four columns. Affine, so the w of the first three columns is zero
+    struct Blend
+    {
+#if defined(ELIX_SIMD_SSE)
+        __m128 columns[4];
+#else
+        glm::vec4 columns[4];
+#endif
+    };
+
+#if defined(ELIX_SIMD_SSE)
+    inline __m128 cross(__m128 a, __m128 b)
+    {
+        const __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 result = _mm_sub_ps(_mm_mul_ps(a, bYzx), _mm_mul_ps(aYzx, b));
+        return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    inline __m128 combine(const __m128* columns, float x, float y, float z)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(x)), _mm_mul_ps(columns[1], _mm_set1_ps(y))), _mm_mul_ps(columns[2], _mm_set1_ps(z)));
+    }
+
+    inline glm::vec3 toVec3(__m128 value)
+    {
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, value);
+        return {lanes[0], lanes[1], lanes[2]};
+    }
+#endif
+
+    Blend blend(const elix::SkinnedVertex& vertex, const glm::mat4* palette, size_t paletteSize)
+    {
+        Blend result;
+        bool hasInfluence = false;
+
+#if defined(ELIX_SIMD_SSE)
+        for (auto& column : result.columns)
+            column = _mm_setzero_ps();
+
+        for (int influence = 0; influence < 4; ++influence)
+        {
+            if (vertex.weights[influence] == 0 || vertex.boneIds[influence] >= paletteSize)
+                continue;
+
+            const glm::mat4& bone = palette[vertex.boneIds[influence]];
+            const __m128 weight = _mm_set1_ps(glm::unpackUnorm1x16(vertex.weights[influence]));
+
+            for (int column = 0; column < 4; ++column)
+                result.columns[column] = _mm_add_ps(result.columns[column], _mm_mul_ps(_mm_loadu_ps(&bone[column][0]), weight));
+
+            hasInfluence = true;
+        }
+
+        if (!hasInfluence)
+        {
+            static const glm::mat4 identity(1.0f);
+
+            for (int column = 0; column < 4; ++column)
+                result.columns[column] = _mm_loadu_ps(&identity[column][0]);
+        }
+#else
+        glm::mat4 transform(0.0f);
+
+        for (int influence = 0; influence < 4; ++influence)
+        {
+            if (vertex.weights[influence] == 0 || vertex.boneIds[influence] >= paletteSize)
+                continue;
+
+            transform += palette[vertex.boneIds[influence]] * glm::unpackUnorm1x16(vertex.weights[influence]);
+            hasInfluence = true;
+        }
+
+        if (!hasInfluence)
+            transform = glm::mat4(1.0f);
+
+        for (int column = 0; column < 4; ++column)
+            result.columns[column] = transform[column];
+#endif
+
+        return result;
+    }
+
+    //Position, normal and tangent direction through the blended matrix. Normals use the cofactor matrix, the inverse
+    //transpose up to a scale the octahedral encoding drops anyway
+    void transform(const Blend& blend, const glm::vec3& position, const glm::vec3& normal, const glm::vec3& tangent,
+                   glm::vec3& outPosition, glm::vec3& outNormal, glm::vec3& outTangent)
+    {
+        const auto& columns = blend.columns;
+
+#if defined(ELIX_SIMD_SSE)
+        outPosition = toVec3(_mm_add_ps(combine(columns, position.x, position.y, position.z), columns[3]));
+        outTangent = toVec3(combine(columns, tangent.x, tangent.y, tangent.z));
+
+        const __m128 cofactors[3]{cross(columns[1], columns[2]), cross(columns[2], columns[0]), cross(columns[0], columns[1])};
+        outNormal = toVec3(combine(cofactors, normal.x, normal.y, normal.z));
+
+        //Mirroring bones flip the cofactors
+        if (glm::dot(toVec3(columns[0]), toVec3(cofactors[0])) < 0.0f)
+            outNormal = -outNormal;
+#else
+        const glm::vec3 column0(columns[0]), column1(columns[1]), column2(columns[2]);
+
+        outPosition = column0 * position.x + column1 * position.y + column2 * position.z + glm::vec3(columns[3]);
+        outTangent = column0 * tangent.x + column1 * tangent.y + column2 * tangent.z;
+
+        const glm::vec3 cofactor0 = glm::cross(column1, column2);
+        outNormal = cofactor0 * normal.x + glm::cross(column2, column0) * normal.y + glm::cross(column0, column1) * normal.z;
+
+        if (glm::dot(column0, cofactor0) < 0.0f)
+            outNormal = -outNormal;
+#endif
+    }
+
+    void skinRange(const elix::SkinnedVertex* vertices, std::span<const glm::mat4> palette, elix::StaticVertex* output, size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+        {
+            const auto& vertex = vertices[index];
+            auto& skinned = output[index];
+
+            const glm::vec3 normal = elix::VertexFormat::decodeOctahedral({glm::unpackSnorm1x16(static_cast<uint16_t>(vertex.normal[0])),
+                                                                           glm::unpackSnorm1x16(static_cast<uint16_t>(vertex.normal[1]))});
+
+            //A zero sign marks a mesh without tangents, nothing to transform then
+            const bool hasTangent = vertex.tangent[2] != 0;
+            const glm::vec3 tangent = hasTangent ? elix::VertexFormat::decodeOctahedral({glm::unpackSnorm1x8(static_cast<uint8_t>(vertex.tangent[0])),
+                                                                                          glm::unpackSnorm1x8(static_cast<uint8_t>(vertex.tangent[1]))}) : glm::vec3(0.0f);
+
+            glm::vec3 skinnedNormal, skinnedTangent;
+            transform(blend(vertex, palette.data(), palette.size()), vertex.position, normal, tangent, skinned.position, skinnedNormal, skinnedTangent);
+
+            const glm::vec2 encodedNormal = elix::VertexFormat::encodeOctahedral(skinnedNormal);
+            skinned.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(encodedNormal.x));
+            skinned.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(encodedNormal.y));
+
+            if (hasTangent)
+            {
+                const glm::vec2 encodedTangent = elix::VertexFormat::encodeOctahedral(skinnedTangent);
+                skinned.tangent[0] = static_cast<int8_t>(glm::packSnorm1x8(encodedTangent.x));
+                skinned.tangent[1] = static_cast<int8_t>(glm::packSnorm1x8(encodedTangent.y));
+            }
+            else
+            {
+                skinned.tangent[0] = vertex.tangent[0];
+                skinned.tangent[1] = vertex.tangent[1];
+            }
+
+            skinned.tangent[2] = vertex.tangent[2];
+            skinned.tangent[3] = 0;
+
+            skinned.textureCoordinates[0] = vertex.textureCoordinates[0];
+            skinned.textureCoordinates[1] = vertex.textureCoordinates[1];
+        }
+    }
+
+    const elix::SkinnedVertex* asSkinned(std::span<const std::byte> vertices)
+    {
+        return reinterpret_cast<const elix::SkinnedVertex*>(vertices.data());
+    }
+} //namespace
+
+elix::SkinningCache::~SkinningCache()
+{
+    release();
+}
+
+void elix::SkinningCache::skinVertices(std::span<const std::byte> vertices, std::span<const glm::mat4> palette, std::span<StaticVertex> output)
+{
+    const size_t count = std::min(vertices.size() / sizeof(SkinnedVertex), output.size());
+    const size_t tasks = std::max<size_t>(count / MIN_VERTICES_PER_TASK, 1);
+
+    ThreadPool::instance().parallelFor(tasks, [&](size_t beginTask, size_t endTask)
+    {
+        ::skinRange(::asSkinned(vertices), palette, output.data(), count * beginTask / tasks, count * endTask / tasks);
+    });
+}
+
+void elix::SkinningCache::update(const std::vector<std::shared_ptr<GameObject>> &objects)
+{
+    if (g_mode == Mode::Shader)
+        return;
+
+    struct Job
+    {
+        SkinningCache* cache;
+        elix::Model* model;
+        const AnimatorComponent* animator;
+    };
+
+    std::vector<Job> jobs;
+
+    for (const auto& object : objects)
+    {
+        const auto animator = object->getComponent<AnimatorComponent>();
+        const auto meshComponent = object->getComponent<MeshComponent>();
+
+        if (!animator || !meshComponent || !meshComponent->getModel() || !meshComponent->getModel()->hasSkeleton() || animator->getFinalMatrices().empty())
+            continue;
+
+        auto& cache = meshComponent->getSkinningCache();
+
+        if (cache.isValid() && cache.m_model == meshComponent->getModel() && cache.getPoseVersion() == animator->getPoseVersion())
+            continue;
+
+        jobs.push_back({&cache, meshComponent->getModel(), animator});
+    }
+
+    //GPU instances go one by one. CPU ones are cut into vertex ranges and skinned together before anything is uploaded
+    struct Range
+    {
+        const SkinnedVertex* vertices;
+        std::span<const glm::mat4> palette;
+        StaticVertex* output;
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<Range> ranges;
+    std::vector<SkinningCache*> cpuCaches;
+
+    for (const auto& job : jobs)
+    {
+        const auto& palette = job.animator->getFinalMatrices();
+        job.cache->setPoseVersion(job.animator->getPoseVersion());
+
+        job.cache->prepare(*job.model);
+
+        if (g_mode == Mode::Gpu && palette.size() <= MAX_SHADER_BONES)
+        {
+            job.cache->skinOnGpu(*job.model, palette);
+            continue;
+        }
+
+        const auto& meshes = job.model->getMeshes();
+
+        for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+        {
+            auto& output = job.cache->m_outputs[meshIndex];
+
+            if (output.vertexCount == 0)
+                continue;
+
+            output.vertices.resize(output.vertexCount);
+
+            for (size_t begin = 0; begin < output.vertexCount; begin += MIN_VERTICES_PER_TASK)
+                ranges.push_back({::asSkinned(meshes[meshIndex].getVertexData()), palette, output.vertices.data(), begin, std::min(begin + MIN_VERTICES_PER_TASK, output.vertexCount)});
+        }
+
+        cpuCaches.push_back(job.cache);
+    }
+
+    ThreadPool::instance().parallelFor(ranges.size(), [&ranges](size_t begin, size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+            ::skinRange(ranges[index].vertices, ranges[index].palette, ranges[index].output, ranges[index].begin, ranges[index].end);
+    });
+
+    for (auto* cache : cpuCaches)
+        cache->upload();
+}
+
+void elix::SkinningCache::skin(elix::Model &model, std::span<const glm::mat4> palette)
+{
+    prepare(model);
+
+    if (g_mode == Mode::Gpu && palette.size() <= MAX_SHADER_BONES)
+    {
+        skinOnGpu(model, palette);
+        return;
+    }
+
+    const auto& meshes = model.getMeshes();
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+    {
+        auto& output = m_outputs[meshIndex];
+
+        if (output.vertexCount == 0)
+            continue;
+
+        output.vertices.resize(output.vertexCount);
+        skinVertices(meshes[meshIndex].getVertexData(), palette, output.vertices);
+    }
+
+    upload();
+}
+
+void elix::SkinningCache::prepare(elix::Model &model)
+{
+    if (m_model == &model && m_outputs.size() == model.getNumMeshes())
+        return;
+
+    release();
+
+    m_model = &model;
+    m_outputs.resize(model.getNumMeshes());
+
+    for (size_t meshIndex = 0; meshIndex < m_outputs.size(); ++meshIndex)
+    {
+        auto* mesh = model.getMesh(static_cast<int>(meshIndex));
+
+        //Meshes without bones of a skinned model are drawn as they are
+        if (!mesh->hasBones())
+            continue;
+
+        mesh->bake();
+
+        auto& output = m_outputs[meshIndex];
+        output.vertexCount = mesh->getVertexCount();
+        output.vertexBuffer = std::make_shared<elix::Buffer>(elix::Buffer::BufferType::Vertex, elix::Buffer::BufferUsage::DynamicDraw);
+
+        output.vertexArray.create();
+        output.vertexBuffer->create();
+
+        output.vertexArray.bind();
+
+        output.vertexBuffer->uploadRaw(nullptr, output.vertexCount * sizeof(StaticVertex));
+
+        constexpr size_t stride = sizeof(StaticVertex);
+
+        output.vertexArray.setAttribute(0, 3, elix::VertexArray::Type::Float, false, stride, (void*)offsetof(StaticVertex, position));
+        output.vertexArray.setAttribute(1, 2, elix::VertexArray::Type::Short, true, stride, (void*)offsetof(StaticVertex, normal));
+        output.vertexArray.setAttribute(2, 2, elix::VertexArray::Type::HalfFloat, false, stride, (void*)offsetof(StaticVertex, textureCoordinates));
+        output.vertexArray.setAttribute(3, 4, elix::VertexArray::Type::Byte, true, stride, (void*)offsetof(StaticVertex, tangent));
+
+        mesh->attachIndexBuffer();
+
+        output.vertexArray.unbind();
+        output.vertexBuffer->unbind();
+    }
+}
+
+void elix::SkinningCache::skinOnGpu(const elix::Model &model, std::span<const glm::mat4> palette)
+{
+    const auto* shader = ShaderManager::instance().getShader(ShaderManager::SKINNING);
+
+    if (!shader->isValid())
+    {
+        ELIX_LOG_ERROR("Skinning shader is not loaded, nothing was skinned");
+        return;
+    }
+
+    shader->bind();
+    shader->setMat4Array("finalBonesMatrices", palette);
+
+    //Only the captured varyings matter
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    const auto& meshes = model.getMeshes();
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+    {
+        const auto& output = m_outputs[meshIndex];
+
+        if (output.vertexCount == 0)
+            continue;
+
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output.vertexBuffer->getId());
+        glBeginTransformFeedback(GL_POINTS);
+        meshes[meshIndex].drawVertices();
+        glEndTransformFeedback();
+    }
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    shader->unbind();
+
+    m_isValid = true;
+}
+
+void elix::SkinningCache::upload()
+{
+    for (auto& output : m_outputs)
+        if (output.vertexCount > 0 && output.vertices.size() == output.vertexCount)
+        {
+            //Orphans the previous pose, a frame still drawing from it keeps its copy
+            output.vertexBuffer->uploadRaw(output.vertices.data(), output.vertexCount * sizeof(StaticVertex));
+            output.vertexBuffer->unbind();
+        }
+
+    m_isValid = true;
+}
+
+void elix::SkinningCache::draw(const elix::Model &model, size_t lod) const
+{
+    const auto& meshes = model.getMeshes();
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+    {
+        if (meshIndex < m_outputs.size() && m_outputs[meshIndex].vertexCount > 0)
+            meshes[meshIndex].draw(m_outputs[meshIndex].vertexArray, lod);
+        else
+            meshes[meshIndex].draw(lod);
+    }
+}
+
+void elix::SkinningCache::drawWithMaterials(const elix::Model &model, std::unordered_map<int, Material *> &materials, size_t lod) const
+{
+    const auto shader = ShaderManager::instance().getShader(ShaderManager::ShaderType::STATIC);
+    const auto& meshes = model.getMeshes();
+
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
+    {
+        const auto& mesh = meshes[meshIndex];
+
+        Material* material = mesh.getMaterial();
+
+        if (const auto it = materials.find(static_cast<int>(meshIndex)); it != materials.end())
+            material = it->second;
+
+        if (!material)
+            continue;
+
+        material->bind(*shader);
+
+        if (meshIndex < m_outputs.size() && m_outputs[meshIndex].vertexCount > 0)
+            mesh.draw(m_outputs[meshIndex].vertexArray, lod);
+        else
+            mesh.draw(lod);
+    }
+}
+
+bool elix::SkinningCache::isValid() const
+{
+    return g_mode != Mode::Shader && m_isValid;
+}
+
+uint32_t elix::SkinningCache::getPoseVersion() const
+{
+    return m_poseVersion;
+}
+
+void elix::SkinningCache::setPoseVersion(uint32_t poseVersion)
+{
+    m_poseVersion = poseVersion;
+}
+
+std::vector<elix::StaticVertex> elix::SkinningCache::readBack(size_t meshIndex) const
+{
+    if (meshIndex >= m_outputs.size() || m_outputs[meshIndex].vertexCount == 0)
+        return {};
+
+    const auto& output = m_outputs[meshIndex];
+    std::vector<StaticVertex> vertices(output.vertexCount);
+
+    output.vertexBuffer->bind();
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(vertices.size() * sizeof(StaticVertex)), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return vertices;
+}
+
+float elix::SkinningCache::validate(elix::Model &model, std::span<const glm::mat4> palette)
+{
+    if (palette.size() > MAX_SHADER_BONES)
+        ELIX_LOG_WARN("Palette has ", palette.size(), " bones, the skinning shader only sees the first ", MAX_SHADER_BONES);
+
+    SkinningCache cache;
+    cache.prepare(model);
+    cache.skinOnGpu(model, palette);
+
+    float maxError = 0.0f;
+    std::vector<StaticVertex> expected;
+
+    for (size_t meshIndex = 0; meshIndex < model.getNumMeshes(); ++meshIndex)
+    {
+        const auto gpuVertices = cache.readBack(meshIndex);
+
+        if (gpuVertices.empty())
+            continue;
+
+        expected.resize(gpuVertices.size());
+        skinVertices(model.getMeshes()[meshIndex].getVertexData(), palette, expected);
+
+        for (size_t index = 0; index < expected.size(); ++index)
+        {
+            const glm::vec3 difference = glm::abs(gpuVertices[index].position - expected[index].position);
+            maxError = std::max({maxError, difference.x, difference.y, difference.z});
+        }
+    }
+
+    ELIX_LOG_INFO("Skinning validation of ", model.getName(), ": largest position difference ", maxError);
+
+    return maxError;
+}
+
+void elix::SkinningCache::release()
+{
+    for (auto& output : m_outputs)
+        output.vertexArray.destroy();
+
+    m_outputs.clear();
+    m_model = nullptr;
+    m_isValid = false;
+}
+
+void elix::SkinningCache::setMode(Mode mode)
+{
+    g_mode = mode;
+}
+
+elix::SkinningCache::Mode elix::SkinningCache::getMode()
+{
+    return g_mode;
+}
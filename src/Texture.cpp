@@ -1,18 +1,25 @@
 #include "Texture.hpp"
+#include "MappedFile.hpp"
+#include "TextureStreamer.hpp"
+#include "Logger.hpp"
 
 #include <glad/glad.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <string>
+#include <unordered_set>
 
 namespace
 {
     elix::Texture::TextureData getTextureDataFromFile(const std::string& filePath, bool flipVertically, bool useFloat = false)
     {
-        stbi_set_flip_vertically_on_load(flipVertically);
+        //Textures are decoded on import workers, so the flip flag must not leak between threads
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
 
         elix::Texture::TextureData textureData{};
 
@@ -61,6 +68,68 @@ namespace
         return GL_UNSIGNED_BYTE;
     }
 
+    //S3TC is an extension, the loader only exposes core enums
+    constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+    constexpr GLenum COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+    constexpr GLenum COMPRESSED_SRGB_S3TC_DXT1 = 0x8C4C;
+    constexpr GLenum COMPRESSED_SRGB_ALPHA_S3TC_DXT5 = 0x8C4F;
+
+    GLenum toGLInternalFormat(elix::cooked::TextureEncoding encoding, bool sRGB)
+    {
+        switch (encoding)
+        {
+            case elix::cooked::TextureEncoding::RGBA8: return sRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+            case elix::cooked::TextureEncoding::BC1: return sRGB ? COMPRESSED_SRGB_S3TC_DXT1 : COMPRESSED_RGB_S3TC_DXT1;
+            case elix::cooked::TextureEncoding::BC3: return sRGB ? COMPRESSED_SRGB_ALPHA_S3TC_DXT5 : COMPRESSED_RGBA_S3TC_DXT5;
+            case elix::cooked::TextureEncoding::BC5: return GL_COMPRESSED_RG_RGTC2;
+            case elix::cooked::TextureEncoding::BC7: return sRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+
+        return GL_RGBA8;
+    }
+
+    //Asked once, the context does not change while the engine runs. OpenGL thread only
+    bool hasExtension(const std::string& name)
+    {
+        static const std::unordered_set<std::string> extensions = []
+        {
+            std::unordered_set<std::string> result;
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+            for (GLint index = 0; index < count; ++index)
+                if (const auto* extension = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(index)))
+                    result.emplace(reinterpret_cast<const char*>(extension));
+
+            return result;
+        }();
+
+        return extensions.contains(name);
+    }
+
+    //RGBA8 and RGTC are core since 3.0. BPTC is core in 4.2, which macOS does not reach, and S3TC is never core
+    bool isEncodingSupported(elix::cooked::TextureEncoding encoding)
+    {
+        switch (encoding)
+        {
+            case elix::cooked::TextureEncoding::RGBA8:
+            case elix::cooked::TextureEncoding::BC5:
+                return true;
+            case elix::cooked::TextureEncoding::BC1:
+            case elix::cooked::TextureEncoding::BC3:
+                return hasExtension("GL_EXT_texture_compression_s3tc");
+            case elix::cooked::TextureEncoding::BC7:
+                return GLAD_GL_VERSION_4_2 || hasExtension("GL_ARB_texture_compression_bptc");
+        }
+
+        return false;
+    }
+
+    bool isS3TCsRGBSupported()
+    {
+        return hasExtension("GL_EXT_texture_sRGB") || hasExtension("GL_EXT_texture_compression_s3tc_srgb");
+    }
+
     GLenum toGL(elix::Texture::TextureFormat format)
     {
         switch (format) {
@@ -107,6 +176,39 @@ void elix::Texture::load(const std::string &filePath, TextureParams* params)
     m_name = file.filename().string();
 }
 
+bool elix::Texture::loadCooked(const std::string &filePath, TextureParams *params)
+{
+    if (params)
+        m_parameters = *params;
+
+    auto source = elix::MappedFile::open(filePath);
+
+    if (!source || !TextureCooker::parse({source->data(), source->size()}, m_cookedView))
+    {
+        ELIX_LOG_ERROR("Failed to load cooked texture ", filePath);
+        return false;
+    }
+
+    m_cookedSource = std::move(source);
+
+    m_parameters.width = static_cast<int>(m_cookedView.header->width);
+    m_parameters.height = static_cast<int>(m_cookedView.header->height);
+    m_parameters.generateMipmaps = false;
+
+    //The stored mips are only sampled with a mipmapped filter
+    if (m_cookedView.levels.size() > 1 && m_parameters.minFilter == TextureFilter::Linear)
+        m_parameters.minFilter = TextureFilter::LinearMipmapLinear;
+
+    m_name = std::filesystem::path(filePath).filename().string();
+
+    return true;
+}
+
+bool elix::Texture::isCooked() const
+{
+    return m_cookedSource != nullptr || m_cookedGpuMemorySize > 0;
+}
+
 const std::string& elix::Texture::getName() const
 {
     return m_name;
@@ -117,8 +219,19 @@ unsigned int elix::Texture::getId() const
     return m_id;
 }
 
+const elix::Texture::TextureData& elix::Texture::getTextureData() const
+{
+    return m_textureData;
+}
+
 void elix::Texture::bake()
 {
+    if (m_cookedSource)
+    {
+        bakeCooked();
+        return;
+    }
+
     glGenTextures(1, &m_id);
     glBindTexture(GL_TEXTURE_2D, m_id);
 
@@ -153,9 +266,160 @@ void elix::Texture::bake()
     glBindTexture(GL_TEXTURE_2D, 0);
 
     m_textureData.data = nullptr;
+    m_textureData.dataFloat = nullptr;
+    m_isBaked = true;
+}
+
+void elix::Texture::bakeCooked()
+{
+    uint32_t firstMip = 0;
+
+    //Streamed textures start with their small tail only, TextureStreamer brings the rest in once something asks for it
+    if (m_parameters.streamMips)
+    {
+        firstMip = getMipCount() - 1;
+
+        while (firstMip > 0 && std::max(m_cookedView.levels[firstMip - 1].width, m_cookedView.levels[firstMip - 1].height) <= STREAMING_INITIAL_SIZE)
+            --firstMip;
+    }
+
+    if (!uploadCookedLevels(firstMip))
+    {
+        m_cookedView = {};
+        m_cookedSource.reset();
+        m_isBaked = true;
+        return;
+    }
+
+    if (m_parameters.streamMips)
+        elix::TextureStreamer::instance().registerTexture(this);
+    else
+    {
+        //Same as the stb path, nothing is kept on the CPU once the driver has the pixels
+        m_cookedView = {};
+        m_cookedSource.reset();
+    }
+
     m_isBaked = true;
 }
 
+bool elix::Texture::uploadCookedLevels(uint32_t firstMip)
+{
+    const auto& header = *m_cookedView.header;
+    const auto levelCount = static_cast<uint32_t>(m_cookedView.levels.size()) - firstMip;
+
+    //There is no CPU decoder for the block formats, a texture cooked for a format the context lacks cannot be shown
+    if (!isEncodingSupported(header.encoding))
+    {
+        ELIX_LOG_ERROR("Cooked texture ", m_name, " uses a block format this OpenGL context does not support, cook it with --encoding rgba8");
+        return false;
+    }
+
+    //The sRGB flag only says how the mips were filtered. Shading does not linearize textures, so sRGB sampling stays opt in
+    bool sRGB = (header.flags & cooked::TEXTURE_FLAG_SRGB) && (m_parameters.format == TextureFormat::SRGB || m_parameters.format == TextureFormat::SRGBA);
+
+    if ((header.encoding == cooked::TextureEncoding::BC1 || header.encoding == cooked::TextureEncoding::BC3) && !isS3TCsRGBSupported())
+        sRGB = false;
+
+    const GLenum internalFormat = toGLInternalFormat(header.encoding, sRGB);
+    //glTexStorage2D is 4.2, older contexts allocate level by level
+    const bool hasStorage = GLAD_GL_VERSION_4_2;
+
+    //Immutable storage cannot shrink or grow, so a different mip range gets a new texture object
+    if (m_id != 0)
+        glDeleteTextures(1, &m_id);
+
+    glGenTextures(1, &m_id);
+    glBindTexture(GL_TEXTURE_2D, m_id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, toGL(m_parameters.minFilter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, toGL(m_parameters.magFilter));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, toGL(m_parameters.wrapS));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, toGL(m_parameters.wrapT));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelCount) - 1);
+
+    const auto& topLevel = m_cookedView.levels[firstMip];
+
+    if (hasStorage)
+        glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levelCount), internalFormat, static_cast<GLsizei>(topLevel.width), static_cast<GLsizei>(topLevel.height));
+
+    m_cookedGpuMemorySize = 0;
+
+    for (uint32_t level = firstMip; level < m_cookedView.levels.size(); ++level)
+    {
+        const auto& record = m_cookedView.levels[level];
+        const auto data = m_cookedView.getLevel(level);
+        const auto storageLevel = static_cast<GLint>(level - firstMip);
+
+        const auto width = static_cast<GLsizei>(record.width);
+        const auto height = static_cast<GLsizei>(record.height);
+
+        if (header.encoding == cooked::TextureEncoding::RGBA8)
+        {
+            if (hasStorage)
+                glTexSubImage2D(GL_TEXTURE_2D, storageLevel, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+            else
+                glTexImage2D(GL_TEXTURE_2D, storageLevel, static_cast<GLint>(internalFormat), width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        }
+        else
+        {
+            if (hasStorage)
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, storageLevel, 0, 0, width, height, internalFormat, static_cast<GLsizei>(data.size()), data.data());
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, storageLevel, internalFormat, width, height, 0, static_cast<GLsizei>(data.size()), data.data());
+        }
+
+        m_cookedGpuMemorySize += data.size();
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_residentMip = firstMip;
+
+    return true;
+}
+
+bool elix::Texture::isStreaming() const
+{
+    return m_isBaked && m_cookedSource != nullptr;
+}
+
+uint32_t elix::Texture::getMipCount() const
+{
+    return static_cast<uint32_t>(m_cookedView.levels.size());
+}
+
+uint32_t elix::Texture::getResidentMip() const
+{
+    return m_residentMip;
+}
+
+size_t elix::Texture::getMipChainMemorySize(uint32_t firstMip) const
+{
+    size_t size = 0;
+
+    for (uint32_t level = firstMip; level < m_cookedView.levels.size(); ++level)
+        size += m_cookedView.levels[level].size;
+
+    return size;
+}
+
+uint32_t elix::Texture::getMipWidth(uint32_t mip) const
+{
+    return mip < m_cookedView.levels.size() ? m_cookedView.levels[mip].width : 0;
+}
+
+void elix::Texture::setResidentMip(uint32_t firstMip)
+{
+    if (!isStreaming())
+        return;
+
+    firstMip = std::min(firstMip, getMipCount() - 1);
+
+    if (firstMip != m_residentMip)
+        uploadCookedLevels(firstMip);
+}
+
 void elix::Texture::bakeCubemap(int width, int height)
 {
     glGenTextures(1, &m_id);
@@ -178,6 +442,44 @@ bool elix::Texture::isBaked() const
     return m_isBaked;
 }
 
+size_t elix::Texture::getCpuMemorySize() const
+{
+    if (m_cookedSource)
+        return m_cookedSource->size();
+
+    const size_t pixels = static_cast<size_t>(m_textureData.width) * m_textureData.height * m_textureData.numberOfChannels;
+
+    if (m_textureData.dataFloat)
+        return pixels * sizeof(float);
+
+    return m_textureData.data ? pixels : 0;
+}
+
+size_t elix::Texture::getGpuMemorySize() const
+{
+    if (!m_isBaked)
+        return 0;
+
+    if (m_cookedGpuMemorySize > 0)
+        return m_cookedGpuMemorySize;
+
+    size_t channels = 4;
+
+    switch (m_parameters.format)
+    {
+        case TextureFormat::RED: channels = 1; break;
+        case TextureFormat::RGB:
+        case TextureFormat::SRGB: channels = 3; break;
+        default: break;
+    }
+
+    const size_t bytesPerChannel = m_parameters.bakingType == BakingType::Float ? sizeof(float) : 1;
+    const size_t baseLevel = static_cast<size_t>(m_parameters.width) * m_parameters.height * channels * bytesPerChannel;
+
+    //Full mip chain adds a third of the base level
+    return m_parameters.generateMipmaps ? baseLevel + baseLevel / 3 : baseLevel;
+}
+
 void elix::Texture::unbind(unsigned int slot) const
 {
     glActiveTexture(GL_TEXTURE0 + slot);
@@ -192,6 +494,9 @@ void elix::Texture::bind(unsigned int slot) const
 
 elix::Texture::~Texture()
 {
+    if (isStreaming())
+        elix::TextureStreamer::instance().unregisterTexture(this);
+
     if (m_id != 0)
         glDeleteTextures(1, &m_id);
 }
\ No newline at end of file
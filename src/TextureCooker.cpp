@@ -0,0 +1,748 @@
+#include "TextureCooker.hpp"
+
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ELIX_TEXTURE_COOKER_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t BLOCK_DIMENSION = 4;
+    constexpr size_t LEVEL_ALIGNMENT = 16;
+    constexpr size_t LINEAR_TABLE_SIZE = 4096;
+    constexpr int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    using Encoding = elix::cooked::TextureEncoding;
+
+    size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    //offset + count * elementSize <= size, without overflowing on values read from a file
+    bool isInRange(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size)
+    {
+        return offset <= size && (elementSize == 0 || count <= (size - offset) / elementSize);
+    }
+
+    const std::array<float, 256>& getSrgbToLinearTable()
+    {
+        static const auto table = []
+        {
+            std::array<float, 256> values{};
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                const float color = static_cast<float>(i) / 255.0f;
+                values[i] = color <= 0.04045f ? color / 12.92f : std::pow((color + 0.055f) / 1.055f, 2.4f);
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+    //12 bits of linear precision are plenty for an 8 bit sRGB result
+    const std::array<uint8_t, LINEAR_TABLE_SIZE>& getLinearToSrgbTable()
+    {
+        static const auto table = []
+        {
+            std::array<uint8_t, LINEAR_TABLE_SIZE> values{};
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                const float linear = static_cast<float>(i) / static_cast<float>(LINEAR_TABLE_SIZE - 1);
+                const float color = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+                values[i] = static_cast<uint8_t>(std::clamp(color * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+    uint8_t toUnorm8(float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    uint8_t linearToSrgb(float value)
+    {
+        return getLinearToSrgbTable()[static_cast<size_t>(std::clamp(value, 0.0f, 1.0f) * static_cast<float>(LINEAR_TABLE_SIZE - 1) + 0.5f)];
+    }
+
+    //RGBA float per texel
+    std::vector<float> toLinear(const elix::TextureCooker::Image& image, bool sRGB)
+    {
+        std::vector<float> linear(static_cast<size_t>(image.width) * image.height * 4);
+
+        const auto& srgbToLinear = getSrgbToLinearTable();
+
+        elix::ThreadPool::instance().parallelFor(image.height, [&](size_t rowBegin, size_t rowEnd)
+        {
+            for (size_t i = rowBegin * image.width * 4; i < rowEnd * image.width * 4; i += 4)
+            {
+                for (size_t channel = 0; channel < 3; ++channel)
+                    linear[i + channel] = sRGB ? srgbToLinear[image.pixels[i + channel]] : image.pixels[i + channel] / 255.0f;
+
+                linear[i + 3] = image.pixels[i + 3] / 255.0f;
+            }
+        });
+
+        return linear;
+    }
+
+    elix::TextureCooker::Image fromLinear(const std::vector<float>& linear, uint32_t width, uint32_t height, bool sRGB)
+    {
+        elix::TextureCooker::Image image{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 4)};
+
+        elix::ThreadPool::instance().parallelFor(height, [&](size_t rowBegin, size_t rowEnd)
+        {
+            for (size_t i = rowBegin * width * 4; i < rowEnd * width * 4; i += 4)
+            {
+                for (size_t channel = 0; channel < 3; ++channel)
+                    image.pixels[i + channel] = sRGB ? linearToSrgb(linear[i + channel]) : toUnorm8(linear[i + channel]);
+
+                image.pixels[i + 3] = toUnorm8(linear[i + 3]);
+            }
+        });
+
+        return image;
+    }
+
+    //2x2 box filter. Odd sizes clamp at the last row and column
+    void downsampleRows(const float* source, uint32_t sourceWidth, uint32_t sourceHeight, float* destination, uint32_t destinationWidth, size_t rowBegin, size_t rowEnd)
+    {
+        for (size_t y = rowBegin; y < rowEnd; ++y)
+        {
+            const float* row0 = source + std::min<size_t>(y * 2, sourceHeight - 1) * sourceWidth * 4;
+            const float* row1 = source + std::min<size_t>(y * 2 + 1, sourceHeight - 1) * sourceWidth * 4;
+
+            float* output = destination + y * destinationWidth * 4;
+
+            for (size_t x = 0; x < destinationWidth; ++x)
+            {
+                const size_t x0 = std::min<size_t>(x * 2, sourceWidth - 1) * 4;
+                const size_t x1 = std::min<size_t>(x * 2 + 1, sourceWidth - 1) * 4;
+
+#ifdef ELIX_TEXTURE_COOKER_SSE2
+                const __m128 top = _mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1));
+                const __m128 bottom = _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1));
+                _mm_storeu_ps(output + x * 4, _mm_mul_ps(_mm_add_ps(top, bottom), _mm_set1_ps(0.25f)));
+#else
+                for (size_t channel = 0; channel < 4; ++channel)
+                    output[x * 4 + channel] = (row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]) * 0.25f;
+#endif
+            }
+        }
+    }
+
+    struct Block
+    {
+        uint8_t texels[16][4];
+    };
+
+    Block fetchBlock(const elix::TextureCooker::Image& image, uint32_t blockX, uint32_t blockY)
+    {
+        Block block{};
+
+        for (uint32_t y = 0; y < BLOCK_DIMENSION; ++y)
+            for (uint32_t x = 0; x < BLOCK_DIMENSION; ++x)
+            {
+                const uint32_t sourceX = std::min(blockX * BLOCK_DIMENSION + x, image.width - 1);
+                const uint32_t sourceY = std::min(blockY * BLOCK_DIMENSION + y, image.height - 1);
+
+                std::memcpy(block.texels[y * BLOCK_DIMENSION + x], &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4], 4);
+            }
+
+        return block;
+    }
+
+    //Bounding box endpoints with the diagonal flipped per channel by its covariance with green, then inset by 1/16 of the
+    //range so the interpolated colors land inside the block instead of on its extremes
+    void findEndpoints(const Block& block, size_t channels, int minimum[4], int maximum[4])
+    {
+        float mean[4]{};
+
+        for (size_t channel = 0; channel < channels; ++channel)
+        {
+            minimum[channel] = 255;
+            maximum[channel] = 0;
+        }
+
+        for (const auto& texel : block.texels)
+            for (size_t channel = 0; channel < channels; ++channel)
+            {
+                minimum[channel] = std::min<int>(minimum[channel], texel[channel]);
+                maximum[channel] = std::max<int>(maximum[channel], texel[channel]);
+                mean[channel] += texel[channel] / 16.0f;
+            }
+
+        for (size_t channel = 0; channel < channels; ++channel)
+        {
+            const int inset = (maximum[channel] - minimum[channel]) / 16;
+            minimum[channel] += inset;
+            maximum[channel] -= inset;
+        }
+
+        for (size_t channel = 0; channel < channels; ++channel)
+        {
+            if (channel == 1)
+                continue;
+
+            float covariance = 0.0f;
+
+            for (const auto& texel : block.texels)
+                covariance += (texel[channel] - mean[channel]) * (texel[1] - mean[1]);
+
+            if (covariance < 0.0f)
+                std::swap(minimum[channel], maximum[channel]);
+        }
+    }
+
+    uint16_t packRgb565(const int color[3])
+    {
+        return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | (color[2] * 31 + 127) / 255);
+    }
+
+    void unpackRgb565(uint16_t packed, int color[3])
+    {
+        const int red = packed >> 11 & 31;
+        const int green = packed >> 5 & 63;
+        const int blue = packed & 31;
+
+        color[0] = red << 3 | red >> 2;
+        color[1] = green << 2 | green >> 4;
+        color[2] = blue << 3 | blue >> 2;
+    }
+
+    //Always the four color mode, BC3 reads the color block that way regardless of the endpoint order
+    void encodeBC1(const Block& block, uint8_t* output)
+    {
+        int minimum[4];
+        int maximum[4];
+        findEndpoints(block, 3, minimum, maximum);
+
+        uint16_t color0 = packRgb565(maximum);
+        uint16_t color1 = packRgb565(minimum);
+
+        if (color0 < color1)
+            std::swap(color0, color1);
+
+        uint32_t indices = 0;
+
+        if (color0 != color1)
+        {
+            int palette[4][3];
+            unpackRgb565(color0, palette[0]);
+            unpackRgb565(color1, palette[1]);
+
+            for (size_t channel = 0; channel < 3; ++channel)
+            {
+                palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+                palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+            }
+
+            for (size_t texel = 0; texel < 16; ++texel)
+            {
+                uint32_t bestIndex = 0;
+                int bestError = INT32_MAX;
+
+                for (uint32_t index = 0; index < 4; ++index)
+                {
+                    int error = 0;
+
+                    for (size_t channel = 0; channel < 3; ++channel)
+                    {
+                        const int difference = block.texels[texel][channel] - palette[index][channel];
+                        error += difference * difference;
+                    }
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = index;
+                    }
+                }
+
+                indices |= bestIndex << (texel * 2);
+            }
+        }
+
+        std::memcpy(output, &color0, sizeof(color0));
+        std::memcpy(output + 2, &color1, sizeof(color1));
+        std::memcpy(output + 4, &indices, sizeof(indices));
+    }
+
+    //Single channel block, eight value mode
+    void encodeBC4(const uint8_t values[16], uint8_t* output)
+    {
+        const uint8_t maximum = *std::max_element(values, values + 16);
+        const uint8_t minimum = *std::min_element(values, values + 16);
+
+        output[0] = maximum;
+        output[1] = minimum;
+
+        uint64_t indices = 0;
+
+        if (maximum != minimum)
+        {
+            int palette[8];
+            palette[0] = maximum;
+            palette[1] = minimum;
+
+            for (int index = 2; index < 8; ++index)
+                palette[index] = ((8 - index) * maximum + (index - 1) * minimum + 3) / 7;
+
+            for (size_t texel = 0; texel < 16; ++texel)
+            {
+                uint64_t bestIndex = 0;
+                int bestError = INT32_MAX;
+
+                for (uint64_t index = 0; index < 8; ++index)
+                {
+                    const int error = std::abs(values[texel] - palette[index]);
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = index;
+                    }
+                }
+
+                indices |= bestIndex << (texel * 3);
+            }
+        }
+
+        for (size_t byte = 0; byte < 6; ++byte)
+            output[2 + byte] = static_cast<uint8_t>(indices >> (byte * 8));
+    }
+
+    void encodeBC4Channel(const Block& block, size_t channel, uint8_t* output)
+    {
+        uint8_t values[16];
+
+        for (size_t texel = 0; texel < 16; ++texel)
+            values[texel] = block.texels[texel][channel];
+
+        encodeBC4(values, output);
+    }
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(uint8_t* output) : m_output(output) {}
+
+        void write(uint32_t value, uint32_t bits)
+        {
+            for (uint32_t bit = 0; bit < bits; ++bit, ++m_position)
+                if (value >> bit & 1)
+                    m_output[m_position >> 3] |= static_cast<uint8_t>(1 << (m_position & 7));
+        }
+    private:
+        uint8_t* m_output{nullptr};
+        uint32_t m_position{0};
+    };
+
+    //Least squares endpoints for fixed indices, weights are in [0, weightScale]
+    bool refineEndpoints(const Block& block, const uint32_t indices[16], const int* weights, int weightScale, int endpoints[2][4])
+    {
+        float alpha2 = 0.0f;
+        float beta2 = 0.0f;
+        float alphaBeta = 0.0f;
+        float alphaX[4]{};
+        float betaX[4]{};
+
+        for (size_t texel = 0; texel < 16; ++texel)
+        {
+            const float beta = static_cast<float>(weights[indices[texel]]) / static_cast<float>(weightScale);
+            const float alpha = 1.0f - beta;
+
+            alpha2 += alpha * alpha;
+            beta2 += beta * beta;
+            alphaBeta += alpha * beta;
+
+            for (size_t channel = 0; channel < 4; ++channel)
+            {
+                alphaX[channel] += alpha * block.texels[texel][channel];
+                betaX[channel] += beta * block.texels[texel][channel];
+            }
+        }
+
+        const float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+
+        if (std::abs(determinant) < 1e-6f)
+            return false;
+
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            endpoints[0][channel] = std::clamp(static_cast<int>(std::lround((alphaX[channel] * beta2 - betaX[channel] * alphaBeta) / determinant)), 0, 255);
+            endpoints[1][channel] = std::clamp(static_cast<int>(std::lround((betaX[channel] * alpha2 - alphaX[channel] * alphaBeta) / determinant)), 0, 255);
+        }
+
+        return true;
+    }
+
+    //Quantizes both endpoints to 7 bits plus the better p-bit and picks the closest of the 16 interpolated colors per texel.
+    //Returns the squared error of the block
+    int fitBC7Mode6(const Block& block, const int endpoints[2][4], int quantized[2][4], int pBits[2], uint32_t indices[16])
+    {
+        int reconstructed[2][4];
+
+        for (size_t endpoint = 0; endpoint < 2; ++endpoint)
+        {
+            int bestError = INT32_MAX;
+
+            for (int pBit = 0; pBit < 2; ++pBit)
+            {
+                int candidate[4];
+                int error = 0;
+
+                for (size_t channel = 0; channel < 4; ++channel)
+                {
+                    candidate[channel] = std::clamp((endpoints[endpoint][channel] - pBit + 1) / 2, 0, 127);
+                    const int difference = (candidate[channel] << 1 | pBit) - endpoints[endpoint][channel];
+                    error += difference * difference;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    pBits[endpoint] = pBit;
+                    std::copy_n(candidate, 4, quantized[endpoint]);
+                }
+            }
+
+            for (size_t channel = 0; channel < 4; ++channel)
+                reconstructed[endpoint][channel] = quantized[endpoint][channel] << 1 | pBits[endpoint];
+        }
+
+        int totalError = 0;
+
+        for (size_t texel = 0; texel < 16; ++texel)
+        {
+            int bestError = INT32_MAX;
+
+            for (uint32_t index = 0; index < 16; ++index)
+            {
+                int error = 0;
+
+                for (size_t channel = 0; channel < 4; ++channel)
+                {
+                    const int value = ((64 - BC7_WEIGHTS[index]) * reconstructed[0][channel] + BC7_WEIGHTS[index] * reconstructed[1][channel] + 32) >> 6;
+                    const int difference = block.texels[texel][channel] - value;
+                    error += difference * difference;
+                }
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    indices[texel] = index;
+                }
+            }
+
+            totalError += bestError;
+        }
+
+        return totalError;
+    }
+
+    //Mode 6: one subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices
+    void encodeBC7(const Block& block, uint8_t* output)
+    {
+        int endpoints[2][4];
+        findEndpoints(block, 4, endpoints[1], endpoints[0]);
+
+        int quantized[2][4];
+        int pBits[2];
+        uint32_t indices[16];
+
+        const int error = fitBC7Mode6(block, endpoints, quantized, pBits, indices);
+
+        //One least squares pass over the chosen indices usually pulls the endpoints closer than the bounding box
+        int refinedEndpoints[2][4];
+
+        if (refineEndpoints(block, indices, BC7_WEIGHTS, 64, refinedEndpoints))
+        {
+            int refinedQuantized[2][4];
+            int refinedPBits[2];
+            uint32_t refinedIndices[16];
+
+            if (fitBC7Mode6(block, refinedEndpoints, refinedQuantized, refinedPBits, refinedIndices) < error)
+            {
+                std::memcpy(quantized, refinedQuantized, sizeof(quantized));
+                std::memcpy(pBits, refinedPBits, sizeof(pBits));
+                std::memcpy(indices, refinedIndices, sizeof(indices));
+            }
+        }
+
+        //The anchor index is stored without its top bit, so it has to be below 8
+        if (indices[0] & 8)
+        {
+            std::swap(quantized[0], quantized[1]);
+            std::swap(pBits[0], pBits[1]);
+
+            for (auto& index : indices)
+                index = 15 - index;
+        }
+
+        std::memset(output, 0, 16);
+
+        BitWriter writer(output);
+        writer.write(1 << 6, 7);
+
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            writer.write(quantized[0][channel], 7);
+            writer.write(quantized[1][channel], 7);
+        }
+
+        writer.write(pBits[0], 1);
+        writer.write(pBits[1], 1);
+
+        writer.write(indices[0], 3);
+
+        for (size_t texel = 1; texel < 16; ++texel)
+            writer.write(indices[texel], 4);
+    }
+
+    size_t getBlockBytes(Encoding encoding)
+    {
+        return encoding == Encoding::BC1 ? 8 : 16;
+    }
+} //namespace
+
+bool elix::TextureCooker::cook(const std::string &sourcePath, const std::string &outputPath)
+{
+    return cook(sourcePath, outputPath, Options{});
+}
+
+bool elix::TextureCooker::cook(const std::string &sourcePath, const std::string &outputPath, const Options& options)
+{
+    stbi_set_flip_vertically_on_load_thread(options.flipVertically);
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    unsigned char* pixels = stbi_load(sourcePath.c_str(), &width, &height, &channels, 4);
+
+    if (!pixels)
+    {
+        ELIX_LOG_ERROR("Failed to load texture for cooking ", sourcePath);
+        return false;
+    }
+
+    Image base{static_cast<uint32_t>(width), static_cast<uint32_t>(height), std::vector<uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * 4)};
+    stbi_image_free(pixels);
+
+    Options cookOptions = options;
+
+    //Two channel data is never color
+    if (cookOptions.encoding == cooked::TextureEncoding::BC5)
+        cookOptions.sRGB = false;
+
+    const auto levels = cookOptions.generateMips ? generateMipChain(base, cookOptions.sRGB) : std::vector<Image>{std::move(base)};
+    const auto bytes = serialize(levels, cookOptions);
+
+    std::ofstream file(outputPath, std::ios::binary);
+
+    if (!file.is_open())
+    {
+        ELIX_LOG_ERROR("Failed to open ", outputPath, " for writing");
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    ELIX_LOG_INFO("Cooked texture ", sourcePath, " -> ", outputPath, " (", width, "x", height, ", ", levels.size(), " levels, ", bytes.size() / 1024, " KB)");
+
+    return file.good();
+}
+
+std::vector<elix::TextureCooker::Image> elix::TextureCooker::generateMipChain(const Image &base, bool sRGB)
+{
+    std::vector<Image> levels;
+
+    if (base.width == 0 || base.height == 0)
+        return levels;
+
+    levels.push_back(base);
+
+    std::vector<float> source = toLinear(base, sRGB);
+    uint32_t width = base.width;
+    uint32_t height = base.height;
+
+    while (width > 1 || height > 1)
+    {
+        const uint32_t levelWidth = std::max(1u, width / 2);
+        const uint32_t levelHeight = std::max(1u, height / 2);
+
+        std::vector<float> destination(static_cast<size_t>(levelWidth) * levelHeight * 4);
+
+        //Every level is filtered from the previous float level, so rounding never accumulates across the chain
+        elix::ThreadPool::instance().parallelFor(levelHeight, [&](size_t rowBegin, size_t rowEnd)
+        {
+            downsampleRows(source.data(), width, height, destination.data(), levelWidth, rowBegin, rowEnd);
+        });
+
+        levels.push_back(fromLinear(destination, levelWidth, levelHeight, sRGB));
+
+        source = std::move(destination);
+        width = levelWidth;
+        height = levelHeight;
+    }
+
+    return levels;
+}
+
+std::vector<uint8_t> elix::TextureCooker::encode(const Image &image, cooked::TextureEncoding encoding)
+{
+    if (encoding == cooked::TextureEncoding::RGBA8)
+        return image.pixels;
+
+    const uint32_t blocksX = (image.width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+    const uint32_t blocksY = (image.height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+    const size_t blockBytes = getBlockBytes(encoding);
+
+    std::vector<uint8_t> output(getEncodedSize(image.width, image.height, encoding));
+
+    elix::ThreadPool::instance().parallelFor(blocksY, [&](size_t rowBegin, size_t rowEnd)
+    {
+        for (size_t blockY = rowBegin; blockY < rowEnd; ++blockY)
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX)
+            {
+                const Block block = fetchBlock(image, blockX, static_cast<uint32_t>(blockY));
+                uint8_t* blockOutput = output.data() + (blockY * blocksX + blockX) * blockBytes;
+
+                switch (encoding)
+                {
+                    case cooked::TextureEncoding::BC1:
+                        encodeBC1(block, blockOutput);
+                        break;
+                    case cooked::TextureEncoding::BC3:
+                        encodeBC4Channel(block, 3, blockOutput);
+                        encodeBC1(block, blockOutput + 8);
+                        break;
+                    case cooked::TextureEncoding::BC5:
+                        encodeBC4Channel(block, 0, blockOutput);
+                        encodeBC4Channel(block, 1, blockOutput + 8);
+                        break;
+                    case cooked::TextureEncoding::BC7:
+                        encodeBC7(block, blockOutput);
+                        break;
+                    default:
+                        break;
+                }
+            }
+    });
+
+    return output;
+}
+
+std::vector<std::byte> elix::TextureCooker::serialize(const std::vector<Image> &levels, const Options &options)
+{
+    cooked::TextureHeader header;
+    header.encoding = options.encoding;
+    header.flags = options.sRGB ? static_cast<uint32_t>(cooked::TEXTURE_FLAG_SRGB) : 0u;
+    header.width = levels.empty() ? 0 : levels.front().width;
+    header.height = levels.empty() ? 0 : levels.front().height;
+    header.levelCount = static_cast<uint32_t>(levels.size());
+    header.levelTableOffset = alignUp(sizeof(cooked::TextureHeader), LEVEL_ALIGNMENT);
+
+    std::vector<cooked::TextureLevelRecord> records(levels.size());
+    std::vector<std::vector<uint8_t>> payloads(levels.size());
+
+    size_t offset = alignUp(header.levelTableOffset + records.size() * sizeof(cooked::TextureLevelRecord), LEVEL_ALIGNMENT);
+
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        payloads[level] = encode(levels[level], options.encoding);
+
+        records[level].offset = offset;
+        records[level].size = payloads[level].size();
+        records[level].width = levels[level].width;
+        records[level].height = levels[level].height;
+
+        offset = alignUp(offset + payloads[level].size(), LEVEL_ALIGNMENT);
+    }
+
+    header.fileSize = offset;
+
+    std::vector<std::byte> bytes(offset);
+
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    if (!records.empty())
+        std::memcpy(bytes.data() + header.levelTableOffset, records.data(), records.size() * sizeof(cooked::TextureLevelRecord));
+
+    for (size_t level = 0; level < levels.size(); ++level)
+        std::memcpy(bytes.data() + records[level].offset, payloads[level].data(), payloads[level].size());
+
+    return bytes;
+}
+
+bool elix::TextureCooker::parse(std::span<const std::byte> bytes, TextureView &view)
+{
+    if (bytes.size() < sizeof(cooked::TextureHeader))
+        return false;
+
+    const auto header = reinterpret_cast<const cooked::TextureHeader*>(bytes.data());
+
+    if (header->magic != cooked::TEXTURE_MAGIC || header->version != cooked::TEXTURE_VERSION || header->fileSize != bytes.size())
+        return false;
+
+    if (header->encoding > cooked::TextureEncoding::BC7 || header->levelCount == 0 || header->width == 0 || header->height == 0)
+        return false;
+
+    //A full chain halves the larger side down to one texel, so it never has more than floor(log2) + 1 levels
+    if (header->levelCount > static_cast<uint32_t>(std::bit_width(std::max(header->width, header->height))))
+        return false;
+
+    if (header->levelTableOffset % alignof(cooked::TextureLevelRecord) != 0 ||
+        !isInRange(header->levelTableOffset, header->levelCount, sizeof(cooked::TextureLevelRecord), bytes.size()))
+        return false;
+
+    const std::span levels(reinterpret_cast<const cooked::TextureLevelRecord*>(bytes.data() + header->levelTableOffset), header->levelCount);
+
+    for (uint32_t index = 0; index < levels.size(); ++index)
+    {
+        const auto& level = levels[index];
+
+        if (level.width != std::max(1u, header->width >> index) || level.height != std::max(1u, header->height >> index))
+            return false;
+
+        if (!isInRange(level.offset, level.size, 1, bytes.size()) || level.size != getEncodedSize(level.width, level.height, header->encoding))
+            return false;
+    }
+
+    view.header = header;
+    view.levels = levels;
+    view.bytes = bytes;
+
+    return true;
+}
+
+size_t elix::TextureCooker::getEncodedSize(uint32_t width, uint32_t height, cooked::TextureEncoding encoding)
+{
+    if (encoding == cooked::TextureEncoding::RGBA8)
+        return static_cast<size_t>(width) * height * 4;
+
+    const size_t blocksX = (width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+    const size_t blocksY = (height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+
+    return blocksX * blocksY * getBlockBytes(encoding);
+}
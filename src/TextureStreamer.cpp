@@ -0,0 +1,186 @@
+#include "TextureStreamer.hpp"
+
+#include "CameraComponent.hpp"
+#include "GameObject.hpp"
+#include "MeshComponent.hpp"
+#include "Texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+elix::TextureStreamer& elix::TextureStreamer::instance()
+{
+    static TextureStreamer streamer;
+    return streamer;
+}
+
+void elix::TextureStreamer::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+size_t elix::TextureStreamer::getMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void elix::TextureStreamer::setMaxUploadsPerUpdate(size_t count)
+{
+    m_maxUploadsPerUpdate = std::max<size_t>(1, count);
+}
+
+void elix::TextureStreamer::update(const std::vector<std::shared_ptr<GameObject>>& objects, const CameraComponent& camera, float viewportHeight)
+{
+    if (m_textures.empty())
+        return;
+
+    for (auto& streamed : m_textures)
+    {
+        streamed.requestedMip = streamed.tailMip;
+        streamed.screenSize = 0.0f;
+    }
+
+    const glm::vec3 cameraPosition = camera.getPosition();
+    //Pixels covered by a unit sized object at unit distance
+    const float projectionScale = camera.getProjectionMatrix()[1][1] * viewportHeight * 0.5f;
+
+    for (const auto& object : objects)
+    {
+        const auto meshComponent = object->getComponent<MeshComponent>();
+
+        if (!meshComponent || !meshComponent->getModel())
+            continue;
+
+        const auto model = meshComponent->getModel();
+        const auto& bounds = model->getBoundingBox();
+
+        const glm::mat4 transform = object->getTransformMatrix();
+        const glm::vec3 scale = object->getScale();
+
+        const glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.getCenter(), 1.0f));
+        const float radius = bounds.getRadius() * std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+        const float distance = std::max(glm::length(center - cameraPosition) - radius, 0.01f);
+
+        //Projected diameter, assuming the UVs stretch the texture once across the mesh
+        const float screenSize = 2.0f * radius / distance * projectionScale;
+
+        for (size_t meshIndex = 0; meshIndex < model->getNumMeshes(); ++meshIndex)
+        {
+            const auto overrideMaterial = object->overrideMaterials.find(static_cast<int>(meshIndex));
+            const auto material = overrideMaterial != object->overrideMaterials.end() ? overrideMaterial->second : model->getMesh(static_cast<int>(meshIndex))->getMaterial();
+
+            if (!material)
+                continue;
+
+            for (const auto& [type, texture] : material->getTextures())
+                if (texture && texture->isStreaming())
+                    requestMip(texture, screenSize);
+        }
+    }
+
+    std::vector<uint32_t> targetMips(m_textures.size());
+    size_t targetMemory = 0;
+
+    for (size_t i = 0; i < m_textures.size(); ++i)
+    {
+        targetMips[i] = m_textures[i].requestedMip;
+        targetMemory += m_textures[i].texture->getMipChainMemorySize(targetMips[i]);
+    }
+
+    std::vector<size_t> order(m_textures.size());
+
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    //Smallest on screen first, those lose their detail first when the budget is tight
+    std::ranges::sort(order, [this](size_t left, size_t right) { return m_textures[left].screenSize < m_textures[right].screenSize; });
+
+    if (m_memoryBudget > 0)
+        for (const size_t index : order)
+        {
+            auto& target = targetMips[index];
+            const auto texture = m_textures[index].texture;
+
+            while (targetMemory > m_memoryBudget && target < m_textures[index].tailMip)
+            {
+                targetMemory -= texture->getMipChainMemorySize(target) - texture->getMipChainMemorySize(target + 1);
+                ++target;
+            }
+
+            if (targetMemory <= m_memoryBudget)
+                break;
+        }
+
+    //Drops free memory and are cheap, they always go through. Uploads are capped and go largest on screen first
+    size_t uploads = 0;
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        const auto texture = m_textures[*it].texture;
+        const uint32_t target = targetMips[*it];
+
+        if (target > texture->getResidentMip())
+            texture->setResidentMip(target);
+        else if (target < texture->getResidentMip() && uploads < m_maxUploadsPerUpdate)
+        {
+            texture->setResidentMip(target);
+            ++uploads;
+        }
+    }
+}
+
+size_t elix::TextureStreamer::getResidentMemorySize() const
+{
+    size_t size = 0;
+
+    for (const auto& streamed : m_textures)
+        size += streamed.texture->getMipChainMemorySize(streamed.texture->getResidentMip());
+
+    return size;
+}
+
+void elix::TextureStreamer::registerTexture(Texture *texture)
+{
+    if (!texture || m_textureIndices.contains(texture))
+        return;
+
+    m_textureIndices[texture] = m_textures.size();
+    m_textures.push_back({texture, texture->getResidentMip(), texture->getResidentMip(), 0.0f});
+}
+
+void elix::TextureStreamer::unregisterTexture(Texture *texture)
+{
+    const auto it = m_textureIndices.find(texture);
+
+    if (it == m_textureIndices.end())
+        return;
+
+    const size_t index = it->second;
+    m_textureIndices.erase(it);
+
+    if (index != m_textures.size() - 1)
+    {
+        m_textures[index] = m_textures.back();
+        m_textureIndices[m_textures[index].texture] = index;
+    }
+
+    m_textures.pop_back();
+}
+
+void elix::TextureStreamer::requestMip(Texture *texture, float screenSize)
+{
+    const auto it = m_textureIndices.find(texture);
+
+    if (it == m_textureIndices.end())
+        return;
+
+    auto& streamed = m_textures[it->second];
+
+    streamed.screenSize = std::max(streamed.screenSize, screenSize);
+
+    //One texel per pixel: every halving of the on screen size drops one mip
+    const float textureSize = static_cast<float>(texture->getMipWidth(0));
+    const float mip = screenSize > 0.0f ? std::floor(std::log2(std::max(textureSize / screenSize, 1.0f))) : static_cast<float>(streamed.tailMip);
+
+    streamed.requestedMip = std::min(streamed.requestedMip, std::min(static_cast<uint32_t>(mip), streamed.tailMip));
+}
@@ -0,0 +1,136 @@
+#include "ThreadPool.hpp"
+
+namespace
+{
+    //Pool and queue of the worker running on this thread, nullptr on any other thread
+    thread_local elix::ThreadPool* t_pool{nullptr};
+    thread_local size_t t_queueIndex{0};
+} //namespace
+
+elix::ThreadPool::ThreadPool(size_t threadsCount)
+{
+    threadsCount = std::max<size_t>(threadsCount, 1);
+
+    m_queues.reserve(threadsCount);
+
+    for (size_t i = 0; i < threadsCount; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_workers.reserve(threadsCount);
+
+    for (size_t i = 0; i < threadsCount; ++i)
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+elix::ThreadPool& elix::ThreadPool::instance()
+{
+    static ThreadPool instance;
+    return instance;
+}
+
+size_t elix::ThreadPool::getThreadsCount() const
+{
+    return m_workers.size();
+}
+
+void elix::ThreadPool::push(std::function<void()> task)
+{
+    const size_t queueIndex = t_pool == this ? t_queueIndex : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        Queue& queue = *m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    m_condition.notify_one();
+}
+
+bool elix::ThreadPool::pop(std::function<void()> &task)
+{
+    const bool isWorker = t_pool == this;
+    const size_t start = isWorker ? t_queueIndex : m_nextQueue.load(std::memory_order_relaxed);
+
+    //Own queue newest first, it is still warm in cache
+    if (isWorker)
+    {
+        Queue& queue = *m_queues[start];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    //Everyone else's oldest first
+    for (size_t offset = isWorker ? 1 : 0; offset < m_queues.size(); ++offset)
+    {
+        Queue& queue = *m_queues[(start + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool elix::ThreadPool::runPendingTask()
+{
+    if (m_pendingCount.load(std::memory_order_relaxed) == 0)
+        return false;
+
+    std::function<void()> task;
+
+    if (!pop(task))
+        return false;
+
+    m_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+    task();
+
+    return true;
+}
+
+void elix::ThreadPool::workerLoop(size_t queueIndex)
+{
+    t_pool = this;
+    t_queueIndex = queueIndex;
+
+    while (true)
+    {
+        if (runPendingTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_isStopping || m_pendingCount.load(std::memory_order_relaxed) > 0; });
+
+        if (m_isStopping && m_pendingCount.load(std::memory_order_relaxed) == 0)
+            return;
+    }
+}
+
+elix::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+        if (worker.joinable())
+            worker.join();
+}
@@ -0,0 +1,365 @@
+#include "TransformSystem.hpp"
+
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr uint8_t DIRTY = 1 << 0;
+    //World matrix was recomputed by the current pass, children have to follow
+    constexpr uint8_t CHANGED = 1 << 1;
+
+    constexpr uint32_t INVALID_NODE = elix::TransformSystem::INVALID_NODE;
+
+    //Per node id, stable
+    std::vector<uint32_t> g_nodeOrders;
+    std::vector<uint32_t> g_nodeParents;
+    std::vector<uint32_t> g_freeNodes;
+    //Destroyed nodes still own a slot of the order arrays until the next re-sort, their ids are reused after it
+    std::vector<uint32_t> g_pendingFreeNodes;
+
+    //Per slot, sorted by depth after every re-sort. Parents are slots, -1 for roots
+    std::vector<uint32_t> g_orderNodes;
+    std::vector<elix::Entity> g_entities;
+    std::vector<int32_t> g_parents;
+    std::vector<uint8_t> g_flags;
+    std::vector<glm::mat4> g_localMatrices;
+    std::vector<glm::mat4> g_worldMatrices;
+    //End slot of every depth
+    std::vector<size_t> g_levelEnds;
+
+    std::unordered_map<uint32_t, std::function<void(const glm::mat4&)>> g_callbacks;
+
+    bool g_isOrderDirty{false};
+    //Set from thread safe component updates running in parallel
+    std::atomic<bool> g_hasDirtyNodes{false};
+    size_t g_parallelThreshold{8192};
+    size_t g_recomputedCount{0};
+
+    glm::mat4 loadLocalMatrix(size_t slot)
+    {
+        return elix::TransformSystem::computeLocalMatrix(*elix::Registry::instance().get<elix::Transform>(g_entities[slot]));
+    }
+
+    bool isStale(uint32_t node)
+    {
+        for (; node != INVALID_NODE; node = g_nodeParents[node])
+            if (g_flags[g_nodeOrders[node]] & DIRTY)
+                return true;
+
+        return false;
+    }
+
+    //Sorts the slots by depth, keeping the previous order inside a depth, and drops the destroyed ones
+    void sortByDepth()
+    {
+        std::vector<uint32_t> depths(g_nodeOrders.size(), INVALID_NODE);
+        std::vector<uint32_t> chain;
+        std::vector<size_t> depthCounts;
+
+        for (const uint32_t node : g_orderNodes)
+        {
+            if (node == INVALID_NODE)
+                continue;
+
+            uint32_t ancestor = node;
+
+            chain.clear();
+
+            for (; ancestor != INVALID_NODE && depths[ancestor] == INVALID_NODE; ancestor = g_nodeParents[ancestor])
+                chain.push_back(ancestor);
+
+            uint32_t depth = ancestor == INVALID_NODE ? 0 : depths[ancestor] + 1;
+
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+                depths[*it] = depth++;
+
+            if (depthCounts.size() <= depths[node])
+                depthCounts.resize(depths[node] + 1, 0);
+
+            ++depthCounts[depths[node]];
+        }
+
+        g_levelEnds.resize(depthCounts.size());
+
+        std::vector<size_t> offsets(depthCounts.size());
+        size_t total = 0;
+
+        for (size_t depth = 0; depth < depthCounts.size(); ++depth)
+        {
+            offsets[depth] = total;
+            total += depthCounts[depth];
+            g_levelEnds[depth] = total;
+        }
+
+        std::vector<uint32_t> orderNodes(total);
+        std::vector<elix::Entity> entities(total);
+        std::vector<int32_t> parents(total);
+        std::vector<uint8_t> flags(total);
+        std::vector<glm::mat4> localMatrices(total);
+        std::vector<glm::mat4> worldMatrices(total);
+
+        for (size_t slot = 0; slot < g_orderNodes.size(); ++slot)
+        {
+            const uint32_t node = g_orderNodes[slot];
+
+            if (node == INVALID_NODE)
+                continue;
+
+            const size_t target = offsets[depths[node]]++;
+
+            orderNodes[target] = node;
+            entities[target] = g_entities[slot];
+            flags[target] = g_flags[slot];
+            localMatrices[target] = g_localMatrices[slot];
+            worldMatrices[target] = g_worldMatrices[slot];
+            g_nodeOrders[node] = static_cast<uint32_t>(target);
+        }
+
+        //Parents are placed before their children, their new slots are known by now
+        for (size_t slot = 0; slot < total; ++slot)
+        {
+            const uint32_t parent = g_nodeParents[orderNodes[slot]];
+            parents[slot] = parent == INVALID_NODE ? -1 : static_cast<int32_t>(g_nodeOrders[parent]);
+        }
+
+        g_orderNodes = std::move(orderNodes);
+        g_entities = std::move(entities);
+        g_parents = std::move(parents);
+        g_flags = std::move(flags);
+        g_localMatrices = std::move(localMatrices);
+        g_worldMatrices = std::move(worldMatrices);
+
+        g_freeNodes.insert(g_freeNodes.end(), g_pendingFreeNodes.begin(), g_pendingFreeNodes.end());
+        g_pendingFreeNodes.clear();
+
+        g_isOrderDirty = false;
+    }
+
+    //Slots of one depth only read slots of lower depths, so any split of a level can run in parallel
+    size_t propagate(size_t begin, size_t end)
+    {
+        size_t recomputed = 0;
+
+        for (size_t slot = begin; slot < end; ++slot)
+        {
+            const int32_t parent = g_parents[slot];
+            const uint8_t flags = g_flags[slot];
+
+            if (flags & DIRTY)
+                g_localMatrices[slot] = loadLocalMatrix(slot);
+            else if (parent < 0 || !(g_flags[parent] & CHANGED))
+            {
+                g_flags[slot] = 0;
+                continue;
+            }
+
+            if (parent < 0)
+                g_worldMatrices[slot] = g_localMatrices[slot];
+            else
+                elix::simd::multiply(g_worldMatrices[parent], g_localMatrices[slot], g_worldMatrices[slot]);
+
+            g_flags[slot] = CHANGED;
+            ++recomputed;
+        }
+
+        return recomputed;
+    }
+} //namespace
+
+uint32_t elix::TransformSystem::createNode(Entity entity)
+{
+    uint32_t node;
+
+    if (!g_freeNodes.empty())
+    {
+        node = g_freeNodes.back();
+        g_freeNodes.pop_back();
+    }
+    else
+    {
+        node = static_cast<uint32_t>(g_nodeOrders.size());
+        g_nodeOrders.push_back(INVALID_NODE);
+        g_nodeParents.push_back(INVALID_NODE);
+    }
+
+    //Appended as a root, the next update moves it into the first level
+    g_nodeOrders[node] = static_cast<uint32_t>(g_orderNodes.size());
+    g_nodeParents[node] = INVALID_NODE;
+
+    g_orderNodes.push_back(node);
+    g_entities.push_back(entity);
+    g_parents.push_back(-1);
+    g_flags.push_back(DIRTY);
+    g_localMatrices.emplace_back(1.0f);
+    g_worldMatrices.emplace_back(1.0f);
+
+    g_isOrderDirty = true;
+    g_hasDirtyNodes.store(true, std::memory_order_relaxed);
+
+    return node;
+}
+
+void elix::TransformSystem::destroyNode(uint32_t node)
+{
+    if (node >= g_nodeOrders.size() || g_nodeOrders[node] == INVALID_NODE)
+        return;
+
+    const uint32_t slot = g_nodeOrders[node];
+
+    g_orderNodes[slot] = INVALID_NODE;
+    g_entities[slot] = {};
+    g_flags[slot] = 0;
+
+    g_nodeOrders[node] = INVALID_NODE;
+    g_nodeParents[node] = INVALID_NODE;
+    g_pendingFreeNodes.push_back(node);
+    g_callbacks.erase(node);
+
+    g_isOrderDirty = true;
+}
+
+bool elix::TransformSystem::setParent(uint32_t node, uint32_t parent)
+{
+    if (node >= g_nodeOrders.size())
+        return false;
+
+    if (g_nodeParents[node] == parent)
+        return true;
+
+    for (uint32_t ancestor = parent; ancestor != INVALID_NODE; ancestor = g_nodeParents[ancestor])
+        if (ancestor == node)
+            return false;
+
+    g_nodeParents[node] = parent;
+    markDirty(node);
+
+    g_isOrderDirty = true;
+
+    return true;
+}
+
+uint32_t elix::TransformSystem::getParent(uint32_t node)
+{
+    return node < g_nodeParents.size() ? g_nodeParents[node] : INVALID_NODE;
+}
+
+void elix::TransformSystem::markDirty(uint32_t node)
+{
+    g_flags[g_nodeOrders[node]] |= DIRTY;
+    g_hasDirtyNodes.store(true, std::memory_order_relaxed);
+}
+
+glm::mat4 elix::TransformSystem::getWorldMatrix(uint32_t node)
+{
+    const uint32_t slot = g_nodeOrders[node];
+
+    if (!isStale(node))
+        return g_worldMatrices[slot];
+
+    const glm::mat4 local = (g_flags[slot] & DIRTY) ? loadLocalMatrix(slot) : g_localMatrices[slot];
+    const uint32_t parent = g_nodeParents[node];
+
+    if (parent == INVALID_NODE)
+        return local;
+
+    glm::mat4 world;
+    simd::multiply(getWorldMatrix(parent), local, world);
+
+    return world;
+}
+
+void elix::TransformSystem::setChangedCallback(uint32_t node, const std::function<void(const glm::mat4 &)> &callback)
+{
+    if (callback)
+        g_callbacks[node] = callback;
+    else
+        g_callbacks.erase(node);
+}
+
+void elix::TransformSystem::update()
+{
+    if (!g_hasDirtyNodes.load(std::memory_order_relaxed) && !g_isOrderDirty)
+    {
+        g_recomputedCount = 0;
+        return;
+    }
+
+    if (g_isOrderDirty)
+        sortByDepth();
+
+    std::atomic<size_t> recomputed{0};
+    size_t begin = 0;
+
+    for (const size_t end : g_levelEnds)
+    {
+        if (end - begin >= g_parallelThreshold)
+        {
+            ThreadPool::instance().parallelFor(end - begin, [begin, &recomputed](size_t chunkBegin, size_t chunkEnd)
+            {
+                recomputed.fetch_add(propagate(begin + chunkBegin, begin + chunkEnd), std::memory_order_relaxed);
+            });
+        }
+        else
+            recomputed.fetch_add(propagate(begin, end), std::memory_order_relaxed);
+
+        begin = end;
+    }
+
+    g_recomputedCount = recomputed.load();
+    g_hasDirtyNodes.store(false, std::memory_order_relaxed);
+
+    for (const auto& [node, callback] : g_callbacks)
+    {
+        const uint32_t slot = g_nodeOrders[node];
+
+        if (g_flags[slot] & CHANGED)
+            callback(g_worldMatrices[slot]);
+    }
+}
+
+glm::mat4 elix::TransformSystem::computeLocalMatrix(const Transform &transform)
+{
+    //translate * rotate * scale without the two matrix products
+    glm::mat4 matrix = glm::mat4_cast(transform.rotation);
+    matrix[0] *= transform.scale.x;
+    matrix[1] *= transform.scale.y;
+    matrix[2] *= transform.scale.z;
+    matrix[3] = glm::vec4(transform.position, 1.0f);
+
+    return matrix;
+}
+
+std::span<const glm::mat4> elix::TransformSystem::getWorldMatrices()
+{
+    return g_worldMatrices;
+}
+
+size_t elix::TransformSystem::getNodeCount()
+{
+    return g_orderNodes.size() - g_pendingFreeNodes.size();
+}
+
+size_t elix::TransformSystem::getDepthCount()
+{
+    return g_levelEnds.size();
+}
+
+size_t elix::TransformSystem::getRecomputedCount()
+{
+    return g_recomputedCount;
+}
+
+void elix::TransformSystem::setParallelThreshold(size_t nodeCount)
+{
+    g_parallelThreshold = std::max<size_t>(nodeCount, 1);
+}
+
+size_t elix::TransformSystem::getParallelThreshold()
+{
+    return g_parallelThreshold;
+}
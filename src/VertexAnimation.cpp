@@ -0,0 +1,164 @@
+#include "VertexAnimation.hpp"
+
+#include "AnimationSystem.hpp"
+#include "Logger.hpp"
+#include "SkinningCache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    //Used by the importers when a file does not say
+    constexpr double DEFAULT_TICKS_PER_SECOND = 25.0;
+} //namespace
+
+std::shared_ptr<elix::VertexAnimation> elix::VertexAnimation::bake(elix::Model &model, std::span<common::Animation* const> animations, float frameRate)
+{
+    const Skeleton* skeleton = model.getSkeleton();
+
+    if (!skeleton || frameRate <= 0.0f)
+    {
+        ELIX_LOG_WARN("Vertex animation bake of ", model.getName(), " needs a skeleton and a positive frame rate");
+        return nullptr;
+    }
+
+    auto result = std::make_shared<VertexAnimation>();
+    result->m_model = &model;
+    result->m_frameRate = frameRate;
+    result->m_frames.resize(model.getNumMeshes());
+
+    const auto& meshes = model.getMeshes();
+
+    AnimationSystem::Pose pose;
+    std::vector<StaticVertex> skinned;
+
+    for (auto* animation : animations)
+    {
+        if (!animation || animation->skeletonForAnimation != skeleton)
+        {
+            ELIX_LOG_WARN("Vertex animation bake of ", model.getName(), " skipped a clip made for another skeleton");
+            continue;
+        }
+
+        AnimationSystem::bind(*animation);
+
+        const double ticksPerSecond = animation->ticksPerSecond > 0.0 ? animation->ticksPerSecond : DEFAULT_TICKS_PER_SECOND;
+        const float duration = static_cast<float>(animation->duration / ticksPerSecond);
+
+        //Frames are spread over the whole loop, the last one blends back into the first
+        Clip clip{animation->name, result->m_frameCount, std::max<uint32_t>(static_cast<uint32_t>(std::lround(duration * frameRate)), 1), duration};
+
+        for (uint32_t frame = 0; frame < clip.frameCount; ++frame)
+        {
+            const double time = animation->duration * frame / clip.frameCount;
+            AnimationSystem::samplePose(*animation, static_cast<float>(time), pose);
+
+            for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+            {
+                const auto& mesh = meshes[meshIndex];
+
+                if (!mesh.hasBones())
+                    continue;
+
+                skinned.resize(mesh.getVertexCount());
+                SkinningCache::skinVertices(mesh.getVertexData(), pose.finalMatrices, skinned);
+
+                auto& frames = result->m_frames[meshIndex];
+
+                for (const auto& vertex : skinned)
+                {
+                    uint32_t normal;
+                    std::memcpy(&normal, vertex.normal, sizeof(normal));
+                    frames.emplace_back(vertex.position, std::bit_cast<float>(normal));
+                }
+            }
+        }
+
+        result->m_frameCount += clip.frameCount;
+        result->m_clips.push_back(std::move(clip));
+    }
+
+    if (result->m_clips.empty())
+    {
+        ELIX_LOG_WARN("Vertex animation bake of ", model.getName(), " found no clip for its skeleton");
+        return nullptr;
+    }
+
+    ELIX_LOG_INFO("Baked ", result->m_clips.size(), " clips of ", model.getName(), " into ", result->m_frameCount, " frames, ", result->getMemorySize(), " bytes");
+
+    return result;
+}
+
+int elix::VertexAnimation::findClip(const std::string &name) const
+{
+    for (size_t index = 0; index < m_clips.size(); ++index)
+        if (m_clips[index].name == name)
+            return static_cast<int>(index);
+
+    return -1;
+}
+
+const std::vector<elix::VertexAnimation::Clip>& elix::VertexAnimation::getClips() const
+{
+    return m_clips;
+}
+
+float elix::VertexAnimation::getFrameRate() const
+{
+    return m_frameRate;
+}
+
+uint32_t elix::VertexAnimation::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+const elix::Model * elix::VertexAnimation::getModel() const
+{
+    return m_model;
+}
+
+std::span<const glm::vec4> elix::VertexAnimation::getFrames(size_t meshIndex) const
+{
+    return meshIndex < m_frames.size() ? std::span<const glm::vec4>(m_frames[meshIndex]) : std::span<const glm::vec4>{};
+}
+
+void elix::VertexAnimation::upload()
+{
+    m_buffers.resize(m_frames.size());
+
+    for (size_t meshIndex = 0; meshIndex < m_frames.size(); ++meshIndex)
+    {
+        if (m_frames[meshIndex].empty() || m_buffers[meshIndex])
+            continue;
+
+        auto buffer = std::make_shared<elix::Buffer>(elix::Buffer::BufferType::ShaderStorage, elix::Buffer::BufferUsage::StaticDraw);
+        buffer->create();
+        buffer->uploadRaw(m_frames[meshIndex].data(), m_frames[meshIndex].size() * sizeof(glm::vec4));
+        buffer->unbind();
+
+        m_buffers[meshIndex] = std::move(buffer);
+    }
+}
+
+void elix::VertexAnimation::bindFrames(size_t meshIndex)
+{
+    if (m_buffers.size() != m_frames.size())
+        upload();
+
+    if (meshIndex < m_buffers.size() && m_buffers[meshIndex])
+        m_buffers[meshIndex]->bindBase(FRAME_BINDING);
+}
+
+size_t elix::VertexAnimation::getMemorySize() const
+{
+    size_t size = 0;
+
+    for (const auto& frames : m_frames)
+        size += frames.size() * sizeof(glm::vec4);
+
+    return size;
+}
@@ -0,0 +1,154 @@
+#include "VertexAnimationRenderer.hpp"
+
+#include "GameObject.hpp"
+#include "MeshComponent.hpp"
+#include "SkinnedRenderer.hpp"
+#include "VertexAnimatorComponent.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    //std430 layout of Instance in the vertex animation shaders
+    struct Instance
+    {
+        glm::mat4 model;
+        uint32_t firstFrame;
+        uint32_t frameCount;
+        float frame;
+        uint32_t padding;
+    };
+
+    static_assert(sizeof(Instance) == 80, "Instances are uploaded as is");
+
+    constexpr unsigned int INSTANCE_BINDING = 1;
+
+    std::vector<Instance> g_instances;
+    std::vector<elix::VertexAnimationRenderer::Batch> g_batches;
+
+    std::unique_ptr<elix::Buffer> g_instanceBuffer{nullptr};
+} //namespace
+
+void elix::VertexAnimationRenderer::update(const std::vector<std::shared_ptr<GameObject>> &objects)
+{
+    g_instances.clear();
+    g_batches.clear();
+
+    const bool isSupported = SkinnedRenderer::isSupported();
+
+    struct Entry
+    {
+        elix::VertexAnimation* animation;
+        size_t lod;
+        Instance instance;
+    };
+
+    std::vector<Entry> entries;
+
+    for (const auto& object : objects)
+    {
+        const auto animator = object->getComponent<VertexAnimatorComponent>();
+        const auto meshComponent = object->getComponent<MeshComponent>();
+
+        if (!animator || !meshComponent)
+            continue;
+
+        const auto* clip = animator->getClip();
+        const bool isDrawn = isSupported && clip && meshComponent->getModel() == animator->getAnimation()->getModel();
+
+        meshComponent->setInstanced(isDrawn);
+
+        if (!isDrawn || meshComponent->isCulled())
+            continue;
+
+        entries.push_back({animator->getAnimation().get(), meshComponent->getLod(),
+                           {object->getTransformMatrix(), clip->firstFrame, clip->frameCount, animator->getFrame(), 0}});
+    }
+
+    if (entries.empty())
+        return;
+
+    std::ranges::stable_sort(entries, [](const Entry& a, const Entry& b)
+    {
+        return a.animation != b.animation ? a.animation < b.animation : a.lod < b.lod;
+    });
+
+    g_instances.reserve(entries.size());
+
+    for (const auto& entry : entries)
+    {
+        if (g_batches.empty() || g_batches.back().animation != entry.animation || g_batches.back().lod != entry.lod)
+            g_batches.push_back({entry.animation, entry.lod, static_cast<uint32_t>(g_instances.size()), 0});
+
+        g_instances.push_back(entry.instance);
+        ++g_batches.back().instanceCount;
+    }
+
+    if (!g_instanceBuffer)
+    {
+        g_instanceBuffer = std::make_unique<elix::Buffer>(elix::Buffer::BufferType::ShaderStorage, elix::Buffer::BufferUsage::StreamDraw);
+        g_instanceBuffer->create();
+    }
+
+    g_instanceBuffer->uploadRaw(g_instances.data(), g_instances.size() * sizeof(Instance));
+    g_instanceBuffer->unbind();
+}
+
+void elix::VertexAnimationRenderer::draw(elix::Shader &shader)
+{
+    if (g_batches.empty())
+        return;
+
+    g_instanceBuffer->bindBase(INSTANCE_BINDING);
+
+    const bool isDepthOnly = Mesh::isDepthOnlyPass();
+    const size_t lodBias = isDepthOnly ? MeshComponent::getLodSettings().shadowLodBias : 0;
+
+    for (const auto& batch : g_batches)
+    {
+        shader.setInt("instanceOffset", static_cast<int>(batch.firstInstance));
+
+        const auto& meshes = batch.animation->getModel()->getMeshes();
+
+        for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex)
+        {
+            const auto& mesh = meshes[meshIndex];
+
+            if (batch.animation->getFrames(meshIndex).empty())
+                continue;
+
+            if (!isDepthOnly)
+            {
+                Material* material = mesh.getMaterial();
+
+                if (!material)
+                    continue;
+
+                material->bind(shader);
+            }
+
+            batch.animation->bindFrames(meshIndex);
+            shader.setInt("vertexCount", static_cast<int>(mesh.getVertexCount()));
+
+            //The frames follow the full vertex buffer, the depth stream has its own vertex order
+            mesh.drawInstanced(batch.lod + lodBias, batch.instanceCount, false);
+        }
+    }
+}
+
+const std::vector<elix::VertexAnimationRenderer::Batch>& elix::VertexAnimationRenderer::getBatches()
+{
+    return g_batches;
+}
+
+size_t elix::VertexAnimationRenderer::getInstanceCount()
+{
+    return g_instances.size();
+}
+
+void elix::VertexAnimationRenderer::release()
+{
+    g_instanceBuffer.reset();
+    g_instances.clear();
+    g_batches.clear();
+}
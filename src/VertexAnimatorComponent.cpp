@@ -0,0 +1,62 @@
+#include "VertexAnimatorComponent.hpp"
+
+#include <cmath>
+
+VertexAnimatorComponent::VertexAnimatorComponent(std::shared_ptr<elix::VertexAnimation> animation) : m_animation(std::move(animation))
+{
+
+}
+
+void VertexAnimatorComponent::update(float deltaTime)
+{
+    const auto* clip = getClip();
+
+    if (!clip || clip->duration <= 0.0f)
+        return;
+
+    m_time = std::fmod(m_time + deltaTime * m_speed, clip->duration);
+
+    if (m_time < 0.0f)
+        m_time += clip->duration;
+}
+
+bool VertexAnimatorComponent::play(const std::string &clipName, float timeOffset)
+{
+    const int clip = m_animation ? m_animation->findClip(clipName) : -1;
+
+    if (clip < 0)
+        return false;
+
+    m_clip = clip;
+    m_time = 0.0f;
+    update(timeOffset / (m_speed != 0.0f ? m_speed : 1.0f));
+
+    return true;
+}
+
+void VertexAnimatorComponent::setSpeed(float speed)
+{
+    m_speed = speed;
+}
+
+float VertexAnimatorComponent::getSpeed() const
+{
+    return m_speed;
+}
+
+const elix::VertexAnimation::Clip * VertexAnimatorComponent::getClip() const
+{
+    return m_clip >= 0 ? &m_animation->getClips()[m_clip] : nullptr;
+}
+
+float VertexAnimatorComponent::getFrame() const
+{
+    const auto* clip = getClip();
+
+    return clip && clip->duration > 0.0f ? m_time / clip->duration * clip->frameCount : 0.0f;
+}
+
+const std::shared_ptr<elix::VertexAnimation>& VertexAnimatorComponent::getAnimation() const
+{
+    return m_animation;
+}
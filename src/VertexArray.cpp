@@ -9,6 +9,11 @@ namespace
         {
             case elix::VertexArray::Type::Float: return GL_FLOAT;
             case elix::VertexArray::Type::Int: return GL_INT;
+            case elix::VertexArray::Type::HalfFloat: return GL_HALF_FLOAT;
+            case elix::VertexArray::Type::Byte: return GL_BYTE;
+            case elix::VertexArray::Type::UnsignedByte: return GL_UNSIGNED_BYTE;
+            case elix::VertexArray::Type::Short: return GL_SHORT;
+            case elix::VertexArray::Type::UnsignedShort: return GL_UNSIGNED_SHORT;
         }
 
         return GL_NONE;
@@ -22,6 +27,14 @@ void elix::VertexArray::create()
     glGenVertexArrays(1, &m_id);
 }
 
+void elix::VertexArray::destroy()
+{
+    if (m_id)
+        glDeleteVertexArrays(1, &m_id);
+
+    m_id = 0;
+}
+
 void elix::VertexArray::bind() const
 {
     glBindVertexArray(m_id);
@@ -32,11 +45,17 @@ void elix::VertexArray::setAttribute(int index, size_t size, Type type, bool nor
     glEnableVertexAttribArray(index);
 
 
-    if (type == elix::VertexArray::Type::Float)
-        glVertexAttribPointer(index, size, toGL(type), normalized ? GL_TRUE : GL_FALSE, stride, data);
-    else if (type == elix::VertexArray::Type::Int)
+    if (type == elix::VertexArray::Type::Int)
         glVertexAttribIPointer(index, size, toGL(type), stride, data);
+    else
+        glVertexAttribPointer(index, size, toGL(type), normalized ? GL_TRUE : GL_FALSE, stride, data);
+
+}
 
+void elix::VertexArray::setIntegerAttribute(int index, size_t size, Type type, size_t stride, const void *data)
+{
+    glEnableVertexAttribArray(index);
+    glVertexAttribIPointer(index, size, toGL(type), stride, data);
 }
 
 unsigned int elix::VertexArray::getId() const
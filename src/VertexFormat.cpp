@@ -0,0 +1,312 @@
+#include "VertexFormat.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    template<typename T>
+    void packCommon(const common::Vertex& vertex, T& packed)
+    {
+        packed.position = vertex.position;
+
+        const glm::vec2 normal = elix::VertexFormat::encodeOctahedral(vertex.normal);
+        packed.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(normal.x));
+        packed.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(normal.y));
+
+        const glm::vec2 tangent = elix::VertexFormat::encodeOctahedral(vertex.tangent);
+        //Handedness of the frame, the bitangent is rebuilt as cross(normal, tangent) * sign. Zero marks a mesh without tangents
+        const bool hasTangent = vertex.tangent != glm::vec3(0.0f);
+        const float sign = !hasTangent ? 0.0f : glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+        packed.tangent[0] = static_cast<int8_t>(glm::packSnorm1x8(tangent.x));
+        packed.tangent[1] = static_cast<int8_t>(glm::packSnorm1x8(tangent.y));
+        packed.tangent[2] = static_cast<int8_t>(glm::packSnorm1x8(sign));
+        packed.tangent[3] = 0;
+
+        packed.textureCoordinates[0] = glm::packHalf1x16(vertex.textureCoordinates.x);
+        packed.textureCoordinates[1] = glm::packHalf1x16(vertex.textureCoordinates.y);
+    }
+
+    template<typename T>
+    void unpackCommon(const T& packed, common::Vertex& vertex)
+    {
+        vertex.position = packed.position;
+        vertex.normal = elix::VertexFormat::decodeOctahedral({glm::unpackSnorm1x16(static_cast<uint16_t>(packed.normal[0])),
+                                                              glm::unpackSnorm1x16(static_cast<uint16_t>(packed.normal[1]))});
+
+        const glm::vec2 tangent{glm::unpackSnorm1x8(static_cast<uint8_t>(packed.tangent[0])), glm::unpackSnorm1x8(static_cast<uint8_t>(packed.tangent[1]))};
+
+        if (packed.tangent[2] != 0)
+        {
+            vertex.tangent = elix::VertexFormat::decodeOctahedral(tangent);
+            vertex.bitangent = glm::cross(vertex.normal, vertex.tangent) * (packed.tangent[2] < 0 ? -1.0f : 1.0f);
+        }
+
+        vertex.textureCoordinates = {glm::unpackHalf1x16(packed.textureCoordinates[0]), glm::unpackHalf1x16(packed.textureCoordinates[1])};
+    }
+
+    void packWeights(const common::Vertex& vertex, elix::SkinnedVertex& packed)
+    {
+        //Ids a byte cannot hold are dropped rather than bound to another bone, the cooker refuses such models outright
+        auto isPackable = [&vertex](int i) { return vertex.boneID[i] >= 0 && vertex.boneID[i] < static_cast<int>(elix::VertexFormat::MAX_SKINNED_BONES); };
+
+        float total = 0.0f;
+
+        for (int i = 0; i < 4; ++i)
+            if (isPackable(i))
+                total += vertex.weight[i];
+
+        uint32_t packedTotal = 0;
+        int heaviest = -1;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const bool isUsed = isPackable(i) && total > 0.0f;
+
+            packed.boneIds[i] = isUsed ? static_cast<uint8_t>(vertex.boneID[i]) : 0;
+            packed.weights[i] = isUsed ? glm::packUnorm1x16(vertex.weight[i] / total) : 0;
+            packedTotal += packed.weights[i];
+
+            if (isUsed && (heaviest < 0 || packed.weights[i] > packed.weights[heaviest]))
+                heaviest = i;
+        }
+
+        //Rounding error goes to the largest influence so the weights still sum to exactly one
+        if (heaviest >= 0)
+            packed.weights[heaviest] = static_cast<uint16_t>(static_cast<int>(packed.weights[heaviest]) + static_cast<int>(std::numeric_limits<uint16_t>::max()) - static_cast<int>(packedTotal));
+    }
+} //namespace
+
+size_t elix::VertexFormat::getStride(VertexLayout layout)
+{
+    return layout == VertexLayout::Skinned ? sizeof(SkinnedVertex) : sizeof(StaticVertex);
+}
+
+size_t elix::VertexFormat::getIndexSize(IndexType type)
+{
+    return type == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+size_t elix::VertexFormat::getDepthStride(VertexLayout layout)
+{
+    return layout == VertexLayout::Skinned ? sizeof(SkinnedDepthVertex) : sizeof(glm::vec3);
+}
+
+elix::VertexLayout elix::VertexFormat::selectLayout(std::span<const common::Vertex> vertices)
+{
+    for (const auto& vertex : vertices)
+        if (vertex.boneID[0] != -1)
+            return VertexLayout::Skinned;
+
+    return VertexLayout::Static;
+}
+
+bool elix::VertexFormat::areBonesPackable(std::span<const common::Vertex> vertices)
+{
+    for (const auto& vertex : vertices)
+        for (int i = 0; i < 4; ++i)
+            if (vertex.boneID[i] >= static_cast<int>(MAX_SKINNED_BONES))
+                return false;
+
+    return true;
+}
+
+elix::IndexType elix::VertexFormat::selectIndexType(size_t vertexCount)
+{
+    return vertexCount <= std::numeric_limits<uint16_t>::max() + size_t{1} ? IndexType::UInt16 : IndexType::UInt32;
+}
+
+std::vector<std::byte> elix::VertexFormat::packVertices(std::span<const common::Vertex> vertices, VertexLayout layout)
+{
+    std::vector<std::byte> bytes(vertices.size() * getStride(layout));
+
+    for (size_t index = 0; index < vertices.size(); ++index)
+    {
+        if (layout == VertexLayout::Skinned)
+        {
+            SkinnedVertex packed{};
+            packCommon(vertices[index], packed);
+            packWeights(vertices[index], packed);
+            std::memcpy(bytes.data() + index * sizeof(SkinnedVertex), &packed, sizeof(SkinnedVertex));
+        }
+        else
+        {
+            StaticVertex packed{};
+            packCommon(vertices[index], packed);
+            std::memcpy(bytes.data() + index * sizeof(StaticVertex), &packed, sizeof(StaticVertex));
+        }
+    }
+
+    return bytes;
+}
+
+std::vector<std::byte> elix::VertexFormat::packIndices(std::span<const unsigned int> indices, IndexType type)
+{
+    std::vector<std::byte> bytes(indices.size() * getIndexSize(type));
+
+    if (type == IndexType::UInt32)
+    {
+        std::memcpy(bytes.data(), indices.data(), indices.size_bytes());
+        return bytes;
+    }
+
+    auto* output = reinterpret_cast<uint16_t*>(bytes.data());
+
+    for (size_t index = 0; index < indices.size(); ++index)
+        output[index] = static_cast<uint16_t>(indices[index]);
+
+    return bytes;
+}
+
+common::Vertex elix::VertexFormat::unpackVertex(std::span<const std::byte> vertices, VertexLayout layout, size_t index)
+{
+    common::Vertex vertex;
+
+    if (layout == VertexLayout::Skinned)
+    {
+        SkinnedVertex packed;
+        std::memcpy(&packed, vertices.data() + index * sizeof(SkinnedVertex), sizeof(SkinnedVertex));
+        unpackCommon(packed, vertex);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            vertex.boneID[i] = packed.weights[i] > 0 ? packed.boneIds[i] : -1;
+            vertex.weight[i] = glm::unpackUnorm1x16(packed.weights[i]);
+        }
+    }
+    else
+    {
+        StaticVertex packed;
+        std::memcpy(&packed, vertices.data() + index * sizeof(StaticVertex), sizeof(StaticVertex));
+        unpackCommon(packed, vertex);
+    }
+
+    return vertex;
+}
+
+glm::vec3 elix::VertexFormat::getPosition(std::span<const std::byte> vertices, VertexLayout layout, size_t index)
+{
+    glm::vec3 position;
+    std::memcpy(&position, vertices.data() + index * getStride(layout), sizeof(glm::vec3));
+    return position;
+}
+
+bool elix::VertexFormat::extractDepthStream(std::span<const std::byte> vertices, VertexLayout layout, std::span<const std::byte> indices, IndexType indexType,
+                                           std::vector<std::byte> &depthVertices, std::vector<std::byte> &depthIndices)
+{
+    const size_t stride = getStride(layout);
+    const size_t depthStride = getDepthStride(layout);
+    const size_t vertexCount = vertices.size() / stride;
+    const size_t indexCount = indices.size() / getIndexSize(indexType);
+
+    depthVertices.clear();
+    depthVertices.reserve(vertexCount * depthStride);
+
+    //Depth vertices are compared by their bytes, both layouts are free of padding
+    std::unordered_map<std::string_view, uint32_t> uniqueVertices;
+    std::vector<std::byte> packedVertices(vertexCount * depthStride);
+    std::vector<uint32_t> remap(vertexCount);
+
+    uniqueVertices.reserve(vertexCount);
+
+    for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+    {
+        std::byte* packed = packedVertices.data() + vertexIndex * depthStride;
+        const std::byte* source = vertices.data() + vertexIndex * stride;
+
+        if (layout == VertexLayout::Skinned)
+        {
+            SkinnedDepthVertex depthVertex;
+            std::memcpy(&depthVertex.position, source + offsetof(SkinnedVertex, position), sizeof(glm::vec3));
+            std::memcpy(depthVertex.boneIds, source + offsetof(SkinnedVertex, boneIds), sizeof(depthVertex.boneIds));
+            std::memcpy(depthVertex.weights, source + offsetof(SkinnedVertex, weights), sizeof(depthVertex.weights));
+            std::memcpy(packed, &depthVertex, sizeof(SkinnedDepthVertex));
+        }
+        else
+            std::memcpy(packed, source + offsetof(StaticVertex, position), sizeof(glm::vec3));
+
+        const auto [it, inserted] = uniqueVertices.try_emplace(std::string_view(reinterpret_cast<const char*>(packed), depthStride),
+                                                               static_cast<uint32_t>(depthVertices.size() / depthStride));
+
+        if (inserted)
+            depthVertices.insert(depthVertices.end(), packed, packed + depthStride);
+
+        remap[vertexIndex] = it->second;
+    }
+
+    depthIndices.resize(indices.size());
+
+    for (size_t index = 0; index < indexCount; ++index)
+    {
+        const uint32_t vertexIndex = getIndex(indices, indexType, index);
+
+        if (vertexIndex >= vertexCount)
+        {
+            depthVertices.clear();
+            depthIndices.clear();
+            return false;
+        }
+
+        const uint32_t depthIndex = remap[vertexIndex];
+
+        if (indexType == IndexType::UInt16)
+        {
+            const auto value = static_cast<uint16_t>(depthIndex);
+            std::memcpy(depthIndices.data() + index * sizeof(uint16_t), &value, sizeof(uint16_t));
+        }
+        else
+            std::memcpy(depthIndices.data() + index * sizeof(uint32_t), &depthIndex, sizeof(uint32_t));
+    }
+
+    return true;
+}
+
+uint32_t elix::VertexFormat::getIndex(std::span<const std::byte> indices, IndexType type, size_t index)
+{
+    if (type == IndexType::UInt16)
+    {
+        uint16_t value;
+        std::memcpy(&value, indices.data() + index * sizeof(uint16_t), sizeof(uint16_t));
+        return value;
+    }
+
+    uint32_t value;
+    std::memcpy(&value, indices.data() + index * sizeof(uint32_t), sizeof(uint32_t));
+    return value;
+}
+
+glm::vec2 elix::VertexFormat::encodeOctahedral(const glm::vec3 &direction)
+{
+    const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+
+    if (length <= 0.0f)
+        return glm::vec2(0.0f);
+
+    glm::vec2 encoded = glm::vec2(direction.x, direction.y) / length;
+
+    //Lower hemisphere is folded over the diagonals
+    if (direction.z < 0.0f)
+    {
+        const glm::vec2 folded = 1.0f - glm::abs(glm::vec2(encoded.y, encoded.x));
+        encoded = {encoded.x >= 0.0f ? folded.x : -folded.x, encoded.y >= 0.0f ? folded.y : -folded.y};
+    }
+
+    return encoded;
+}
+
+glm::vec3 elix::VertexFormat::decodeOctahedral(const glm::vec2 &encoded)
+{
+    glm::vec3 direction{encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+
+    const float fold = std::max(-direction.z, 0.0f);
+    direction.x += direction.x >= 0.0f ? -fold : fold;
+    direction.y += direction.y >= 0.0f ? -fold : fold;
+
+    return glm::normalize(direction);
+}
@@ -0,0 +1,91 @@
+#include "ModelCooker.hpp"
+#include "TextureCooker.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void printUsage()
+    {
+        ELIX_LOG_INFO("Usage: elixir_cook <source model> [output file]");
+        ELIX_LOG_INFO("       elixir_cook <source texture> [output file] [--encoding rgba8|bc1|bc3|bc5|bc7] [--linear] [--no-mips] [--flip]");
+    }
+
+    bool isTexture(const std::string& path)
+    {
+        static const std::vector<std::string> extensions{".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd", ".hdr", ".pic", ".pgm", ".ppm", ".pnm"};
+
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char character) { return std::tolower(character); });
+
+        return std::ranges::find(extensions, extension) != extensions.end();
+    }
+
+    bool parseEncoding(const std::string& name, elix::cooked::TextureEncoding& encoding)
+    {
+        if (name == "rgba8") encoding = elix::cooked::TextureEncoding::RGBA8;
+        else if (name == "bc1") encoding = elix::cooked::TextureEncoding::BC1;
+        else if (name == "bc3") encoding = elix::cooked::TextureEncoding::BC3;
+        else if (name == "bc5") encoding = elix::cooked::TextureEncoding::BC5;
+        else if (name == "bc7") encoding = elix::cooked::TextureEncoding::BC7;
+        else return false;
+
+        return true;
+    }
+} //namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const std::string sourcePath = argv[1];
+
+    std::string outputPath;
+    elix::TextureCooker::Options textureOptions;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "--encoding" && i + 1 < argc)
+        {
+            if (!parseEncoding(argv[++i], textureOptions.encoding))
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (argument == "--linear")
+            textureOptions.sRGB = false;
+        else if (argument == "--no-mips")
+            textureOptions.generateMips = false;
+        else if (argument == "--flip")
+            textureOptions.flipVertically = true;
+        else if (outputPath.empty())
+            outputPath = argument;
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const bool texture = isTexture(sourcePath);
+
+    if (outputPath.empty())
+        outputPath = std::filesystem::path(sourcePath).replace_extension(texture ? elix::TextureCooker::EXTENSION : elix::ModelCooker::EXTENSION).string();
+
+    if (texture)
+        return elix::TextureCooker::cook(sourcePath, outputPath, textureOptions) ? 0 : 1;
+
+    return elix::ModelCooker::cook(sourcePath, outputPath) ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include "SceneCooker.hpp"
+#include "Logger.hpp"
+
+#include <filesystem>
+#include <string>
+
+namespace
+{
+    void printUsage()
+    {
+        ELIX_LOG_INFO("Usage: elixir_scene <scene.json> [output file]    cooks the scene");
+        ELIX_LOG_INFO("       elixir_scene <scene", elix::SceneCooker::EXTENSION, "> [output file]    writes the cooked scene back as JSON");
+    }
+} //namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const std::string sourcePath = argv[1];
+    const bool isCooked = std::filesystem::path(sourcePath).extension() == elix::SceneCooker::EXTENSION;
+
+    std::string outputPath = argc > 2 ? argv[2] : std::string{};
+
+    if (outputPath.empty())
+        outputPath = std::filesystem::path(sourcePath).replace_extension(isCooked ? ".json" : elix::SceneCooker::EXTENSION).string();
+
+    if (isCooked)
+        return elix::SceneCooker::uncook(sourcePath, outputPath) ? 0 : 1;
+
+    return elix::SceneCooker::cook(sourcePath, outputPath) ? 0 : 1;
+}